@@ -69,10 +69,23 @@ namespace YAM
         return _state == Shuttingdown;
     }
 
+    bool BuildClient::requestStatus(std::shared_ptr<NodeStatusRequest> request) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_state == Shuttingdown || _state == Done) return false;
+
+        auto msg = dynamic_pointer_cast<IStreamable>(request);
+        _protocol->send(msg);
+        return true;
+    }
+
     // Return the completor delegate used to notify build completion.
     MulticastDelegate<std::shared_ptr<BuildResult>>& BuildClient::completor() {
         return _completor;
     }
+
+    MulticastDelegate<std::shared_ptr<NodeStatusResult>>& BuildClient::statusCompletor() {
+        return _statusCompletor;
+    }
     
     void BuildClient::run() {
         std::shared_ptr<BuildResult> result;
@@ -82,8 +95,11 @@ namespace YAM
                 std::shared_ptr<IStreamable> msg = _protocol->receive();
                 result = dynamic_pointer_cast<BuildResult>(msg);
                 auto logRecord = dynamic_pointer_cast<LogRecord>(msg);
+                auto statusResult = dynamic_pointer_cast<NodeStatusResult>(msg);
                 if (logRecord != nullptr) {
                     _logBook.add(*logRecord);
+                } else if (statusResult != nullptr) {
+                    _statusCompletor.Broadcast(statusResult);
                 } else {
                     done = true;
                 }
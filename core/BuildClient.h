@@ -13,6 +13,8 @@ namespace YAM
     class TcpStream;
     class BuildRequest;
     class BuildResult;
+    class NodeStatusRequest;
+    class NodeStatusResult;
     class BuildServiceProtocol;
 
     // A build client connects to a build service.
@@ -33,11 +35,16 @@ namespace YAM
     // | Done*         | startShutdown() |  send request      |  Done           |
     // | Done          | startBuild()    |  return false      |  Done           |
     // | Done          | stopBuild()     |  return false      |  Done           |
+    // |               |                 |                    |                 |
+    // | Idle,Building,| requestStatus() |  send request      |  (unchanged)    |
+    // | StoppingBuild |                 |                    |                 |
+    // | (any)         | async status    |  notify status     |  (unchanged)    |
     // +---------------+-----------------+--------------------+-----------------+
     // 
     // send request : synchronous send of a request message to service.
     // async result : asynchronous receipt of a result message from service.
     // notify completion : completor().Broadcast(result)
+    // notify status : statusCompletor().Broadcast(statusResult)
     // Done* : in this case no completion notification will happen.
     //  
     class __declspec(dllexport) BuildClient
@@ -70,10 +77,21 @@ namespace YAM
         // Return whether shutdown was started.
         bool startShutdown();
 
+        // Request the state of nodes, call statusCompletor().Broadcast(result)
+        // when the service replied. The service replies also while a build
+        // is running.
+        // Return whether the request was sent.
+        bool requestStatus(std::shared_ptr<NodeStatusRequest> request);
+
         // Return the completor delegate used to broadcast build completion.
         // Take care: broadcast is done in another thread than thread that 
         // constructed the build client.
         MulticastDelegate<std::shared_ptr<BuildResult>>& completor();
+
+        // Return the delegate used to broadcast the replies to status
+        // requests. Take care: broadcast is done in another thread than 
+        // thread that constructed the build client.
+        MulticastDelegate<std::shared_ptr<NodeStatusResult>>& statusCompletor();
         
     private:
         void run();
@@ -89,6 +107,7 @@ namespace YAM
         State _state;
         std::shared_ptr<std::thread> _receiver;
         MulticastDelegate<std::shared_ptr<BuildResult>> _completor;
+        MulticastDelegate<std::shared_ptr<NodeStatusResult>> _statusCompletor;
     };
 }
 
@@ -172,6 +172,7 @@ namespace YAM {namespace BuildFile {
         outputs.addHashes(hashes);
         for (auto const& grp : outputGroups) hashes.push_back(XXH64_string(grp.string()));
         for (auto const& bin : bins) hashes.push_back(XXH64_string(bin.string()));
+        hashes.push_back(resources.hash());
     }
 
     uint32_t Rule::typeId() const { return ruleType; }
@@ -185,6 +186,7 @@ namespace YAM {namespace BuildFile {
         outputs.stream(streamer);
         streamer->streamVector(outputGroups);
         streamer->streamVector(bins);
+        resources.stream(streamer);
     }
 
     void Deps::addHashes(std::vector<XXH64_hash_t>& hashes) const {
@@ -3,6 +3,7 @@
 #include "IStreamer.h"
 #include "IStreamable.h"
 #include "xxhash.h"
+#include "ResourceClaim.h"
 
 #include <vector>
 #include <memory>
@@ -79,6 +80,7 @@ namespace YAM { namespace BuildFile {
         Outputs outputs;
         std::vector<std::filesystem::path> outputGroups;
         std::vector<std::filesystem::path> bins;
+        ResourceClaim resources;
 
         void addHashes(std::vector<XXH64_hash_t>& hashes) const override;
         uint32_t typeId() const override;
@@ -467,7 +467,7 @@ namespace YAM
                     throw std::runtime_error(ss.str());
                 }
             } else {
-                outputNode = std::make_shared<GeneratedFileNode>(_context, outputPath, cmdNode);
+                outputNode = makeShared<GeneratedFileNode>(_context, outputPath, cmdNode);
                 _newMandatoryOutputs.insert({ outputPath, outputNode });
             }
         }
@@ -644,7 +644,7 @@ namespace YAM
         if (node != nullptr && cmdNode == nullptr) {
             throw std::runtime_error("not a command node"); //TODO: better message
         } else if (cmdNode == nullptr) {
-            cmdNode = std::make_shared<CommandNode>(_context, cmdName);
+            cmdNode = makeShared<CommandNode>(_context, cmdName);
             _newCommandsAndForEachNodes.insert({ cmdName, cmdNode });
         }
         if (_commands.contains(cmdName) || _forEachNodes.contains(cmdName)) {
@@ -678,6 +678,7 @@ namespace YAM
         // Note that the not-compiled script must be used because the content of
         // input groupNodes can only be expanded at cmdNode execution time.
         cmdNode->script(rule.script.script);
+        cmdNode->resourceClaim(rule.resources);
         if (outputFilters != cmdNode->outputFilters()) {
             // clear filters to release ownership of optional outputs that
             // may have been converted to mandatory outputs. In that case
@@ -758,6 +759,7 @@ namespace YAM
         forEachNode->orderOnlyInputs(orderOnlyInputs);
         forEachNode->script(rule.script.script);
         forEachNode->outputs(rule.outputs);
+        forEachNode->resourceClaim(rule.resources);
 
         for (auto const& groupPath : rule.outputGroups) {
             compileOutputGroupContent(groupPath, forEachNode);
@@ -799,7 +801,24 @@ namespace YAM
         content.insert(cmdOrForEachNode);
     }
 
+    void BuildFileCompiler::compileResourceClaim(BuildFile::Rule const& rule) {
+        ResourceClaim const& claim = rule.resources;
+        if (claim.empty()) return;
+        auto it = _resourcePoolCapacities.find(claim.pool);
+        if (it == _resourcePoolCapacities.end()) {
+            _resourcePoolCapacities.insert({ claim.pool, { claim.capacity, rule.line } });
+        } else if (it->second.first != claim.capacity) {
+            std::stringstream ss;
+            ss << "In rule at line " << rule.line << " in buildfile " << _buildFile.string() << ":" << std::endl;
+            ss << "Resource pool " << claim.pool << " has capacity " << claim.capacity
+                << " while it has capacity " << it->second.first
+                << " in the rule at line " << it->second.second << std::endl;
+            throw std::runtime_error(ss.str());
+        }
+    }
+
     void BuildFileCompiler::compileRule(BuildFile::Rule const& rule) {
+        compileResourceClaim(rule);
         std::vector<std::shared_ptr<Node>> cmdInputs = compileInputs(rule.cmdInputs);
         std::vector<std::shared_ptr<Node>> orderOnlyInputs = compileOrderOnlyInputs(rule.orderOnlyInputs);
         if (rule.forEach) {
@@ -190,6 +190,10 @@ namespace YAM {
             std::filesystem::path const& binPath,
             std::vector<std::shared_ptr<GeneratedFileNode>> const& outputs);
 
+        // Throw exception when rule claims a resource pool with another
+        // capacity than a previous rule in the buildfile.
+        void compileResourceClaim(BuildFile::Rule const& rule);
+
         void compileRule(BuildFile::Rule const& rule);
 
     private:
@@ -230,6 +234,10 @@ namespace YAM {
         std::map<std::shared_ptr<CommandNode>, std::size_t> _cmdRuleLineNrs;
         std::map<std::shared_ptr<ForEachNode>, std::size_t> _forEachRuleLineNrs;
 
+        // Per resource pool the capacity claimed by the rules in the 
+        // buildfile and the line nr of the first rule that claimed it.
+        std::map<std::string, std::pair<uint32_t, std::size_t>> _resourcePoolCapacities;
+
         // Newly created nodes because existing ones were not found in the 
         // execution context. 
         std::map<std::filesystem::path, std::shared_ptr<Node>> _newCommandsAndForEachNodes;
@@ -34,10 +34,13 @@ namespace YAM {
         virtual ~BuildFileCompilerNode();
 
         std::string className() const override { return "BuildFileCompilerNode"; }
+        NodeKind kind() const override { return NodeKind::BuildFileCompiler; }
 
         void buildFileParser(std::shared_ptr<BuildFileParserNode> const& newFile);
         std::shared_ptr<BuildFileParserNode> buildFileParser() const;
 
+        XXH64_hash_t executionHash() const { return _executionHash; }
+
         std::map<std::filesystem::path, std::shared_ptr<CommandNode>> const& commands() const {
             return _commands; 
         }
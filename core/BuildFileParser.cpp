@@ -31,6 +31,49 @@ namespace {
     ITokenSpec const* script(BuildFileTokenSpecs::script());
     ITokenSpec const* vertical(BuildFileTokenSpecs::vertical());
     ITokenSpec const* glob(BuildFileTokenSpecs::glob());
+
+    const std::regex poolRe(R"(^\{pool=(\w+):(\d+)\}$)");
+    const std::regex weightRe(R"(^\{weight=(\d+)\}$)");
+
+    void throwInvalidResourceClaim(
+        BuildFile::Output const& output,
+        std::filesystem::path const& buildFile,
+        std::string const& reason
+    ) {
+        std::stringstream ss;
+        ss
+            << "Invalid resource claim '" << output.path.string() << "'"
+            << " at line " << output.line
+            << ", column " << output.column
+            << " in file " << buildFile.string() << ": " << reason
+            << std::endl;
+        throw std::runtime_error(ss.str());
+    }
+
+    // Return whether the bin output is a resource pool claim. If so then
+    // update the claim.
+    bool parseResourceClaim(
+        BuildFile::Output const& output,
+        std::filesystem::path const& buildFile,
+        ResourceClaim& claim
+    ) {
+        std::string bin = output.path.string();
+        std::smatch match;
+        if (std::regex_match(bin, match, poolRe)) {
+            if (!claim.empty()) throwInvalidResourceClaim(output, buildFile, "pool already specified.");
+            claim.pool = match[1].str();
+            claim.capacity = static_cast<uint32_t>(std::stoul(match[2].str()));
+            if (claim.capacity == 0) throwInvalidResourceClaim(output, buildFile, "pool capacity must be > 0.");
+            return true;
+        } else if (std::regex_match(bin, match, weightRe)) {
+            claim.tokens = static_cast<uint32_t>(std::stoul(match[1].str()));
+            if (claim.tokens == 0) throwInvalidResourceClaim(output, buildFile, "weight must be > 0.");
+            return true;
+        } else if (bin.starts_with("{pool=") || bin.starts_with("{weight=")) {
+            throwInvalidResourceClaim(output, buildFile, "expected {pool=name:capacity} or {weight=tokens}.");
+        }
+        return false;
+    }
 }
 
 // Conventions:
@@ -160,7 +203,9 @@ namespace YAM {
             if (output.pathType == BuildFile::PathType::Group) {
                 rulePtr->outputGroups.push_back(output.path);
             } else if (output.pathType == BuildFile::PathType::Bin) {
-                rulePtr->bins.push_back(output.path);
+                if (!parseResourceClaim(output, _tokenizer.filePath(), rulePtr->resources)) {
+                    rulePtr->bins.push_back(output.path);
+                }
             } else if (output.pathType == BuildFile::PathType::Path) {
                 rulePtr->outputs.outputs.push_back(output);
             } else if (output.pathType == BuildFile::PathType::Glob) {
@@ -168,6 +213,14 @@ namespace YAM {
                 rulePtr->outputs.outputs.push_back(output);
             }
         }
+        if (rulePtr->resources.empty() && rulePtr->resources.tokens != 1) {
+            std::stringstream ss;
+            ss
+                << "Rule at line " << rulePtr->line
+                << " in file " << _tokenizer.filePath().string()
+                << " specifies a weight but no {pool=name:capacity}." << std::endl;
+            throw std::runtime_error(ss.str());
+        }
         return rulePtr;
     }
 
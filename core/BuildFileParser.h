@@ -49,7 +49,7 @@ namespace YAM
         InputPathFlag :== %[Index] 'f' | '%b' | '%B' | '%e' | '%D' | '%d'
         Index :== integer
         OutputPathFlag :== '%o'
-        CmdOutputs :== CmdOutput+  (Group | Bin )*
+        CmdOutputs :== CmdOutput+  (Group | Bin | Pool | Weight)*
         CmdOutput :== Output | ExtraOutput | OptionalOutput | IgnoreOutput
         Output :== 'out=' Path (',' Path])* // paths optionally contain InputPathFlags
         ExtraOutput :== 'extra=' Path (',' Path])* // paths optionally contain InputPathFlags
@@ -61,6 +61,8 @@ namespace YAM
         RepoName :== identifier // the name of a configured file repository
         Group :== Path where last path component is between angled brackets, e.g. modules\<someGroupName>
         Bin :== '{' identifier '}'
+        Pool :== '{pool=' identifier ':' integer '}'
+        Weight :== '{weight=' integer '}'
 
     Semantics:
 
@@ -105,6 +107,16 @@ namespace YAM
     OrderOnlyInputs: a list of generated files. Yam ensures that these files
     are made up-to-date before executing the command script.
 
+    Pool: the rule's commands claim tokens from the resource pool with the
+    given name and capacity (number of tokens). A command only executes its
+    script when the claimed tokens are available. E.g. {pool=link:4} limits
+    the number of concurrently executing commands in pool link to 4.
+    Rules that use the same pool must specify the same capacity.
+
+    Weight: the number of tokens claimed by each command, default 1. Requires
+    a Pool. E.g. {pool=memory:32} {weight=8} allows at most 4 concurrently
+    executing commands that each claim 8 tokens (e.g. GB of memory).
+
     RelPath: a relative path, relative to the directory that contains the
     buildfile.
 
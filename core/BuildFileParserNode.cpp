@@ -129,7 +129,7 @@ namespace YAM
                 if (_buildFile->name().extension() == ".txt") {
                     _buildFile->addObserver(this);
                 } else {
-                    _executor = std::make_shared<CommandNode>(context(), _buildFile->name() / "__bfExecutor");
+                    _executor = makeShared<CommandNode>(context(), _buildFile->name() / "__bfExecutor");
                     context()->nodes().add(_executor);
                     _executor->addObserver(this);
                     _executor->workingDirectory(buildFileDirectory());
@@ -139,7 +139,7 @@ namespace YAM
                     std::filesystem::path srcBfStem = srcBfName.stem().string();
                     std::filesystem::path genBfName = srcBfStem.string() + "_gen.txt";
                     std::filesystem::path genBfPath(srcBfDirPath / genBfName);
-                    auto genNode = std::make_shared<GeneratedFileNode>(context(), genBfPath, _executor);
+                    auto genNode = makeShared<GeneratedFileNode>(context(), genBfPath, _executor);
                     context()->nodes().add(genNode);
                     CommandNode::OutputFilter filter(CommandNode::OutputFilter::Output, genBfPath);
                     _executor->outputFilters({filter}, {genNode});
@@ -210,7 +210,7 @@ namespace YAM
         } else {
             std::shared_ptr<FileNode> const& buildFile = fileToParse();
             XXH64_hash_t oldHash = _buildFileHash;
-            _buildFileHash = buildFile->hashOf(FileAspect::entireFileAspect().name());
+            _buildFileHash = buildFile->hashOf(FileAspect::entireFileAspect());
             if (_buildFileHash == oldHash) {
                 startGlobs();
             } else {
@@ -220,7 +220,7 @@ namespace YAM
                     _parser->process(); 
                      postParseCompletion();
                 });
-                context()->threadPoolQueue().push(parse, PriorityClass::High);
+                context()->ioQueue().push(parse, PriorityClass::High);
             }
         }
     }
@@ -38,6 +38,7 @@ namespace YAM {
 
         // Overrides from Node class
         std::string className() const override { return "BuildFileParserNode"; }
+        NodeKind kind() const override { return NodeKind::BuildFileParser; }
         void start(PriorityClass prio) override;
 
         // Return the hash of the parseTree and of the globs in the parseTree's
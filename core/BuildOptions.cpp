@@ -8,6 +8,9 @@ namespace YAM
         , _workingDir(std::filesystem::current_path())
         , _logAspects({ LogRecord::Aspect::Error, LogRecord::Aspect::Warning})
         , _threads(0)
+        , _minThreads(0)
+        , _maxThreads(0)
+        , _ioThreads(0)
     { }
 
     void BuildOptions::stream(IStreamer* streamer) {
@@ -15,6 +18,9 @@ namespace YAM
         streamer->stream(_workingDir);
         streamer->streamVector(_scope);
         streamer->stream(_threads);
+        streamer->stream(_minThreads);
+        streamer->stream(_maxThreads);
+        streamer->stream(_ioThreads);
         LogRecord::streamAspects(streamer, _logAspects);
     }
 }
@@ -25,8 +25,22 @@ namespace YAM
         // Only log records whose aspect is in _logAspects.
         std::vector<LogRecord::Aspect> _logAspects;
 
+        // Number of threads that execute command scripts.
+        // 0: number of logical cores, the number of threads adapts to the
+        // system load within [_minThreads, _maxThreads].
         uint32_t _threads;
 
+        // Bounds of the number of threads that execute command scripts when
+        // _threads is 0. The upper bound does not exceed the job token
+        // budget, see JobServer.
+        // 0: number of logical cores / 4 and 2 * number of logical cores.
+        uint32_t _minThreads;
+        uint32_t _maxThreads;
+
+        // Number of threads that execute filesystem I/O (file hashing,
+        // directory content retrieval). 0: number of logical cores.
+        uint32_t _ioThreads;
+
         // Inherited via IStreamable
         uint32_t typeId() const override { throw std::runtime_error("not supported"); }
         void stream(IStreamer* streamer) override;
@@ -14,19 +14,27 @@ namespace YAM
         SHUTDOWN, 
         NOSRV,
         THREADS,
+        MINTHREADS,
+        MAXTHREADS,
+        IOTHREADS,
     };
     const option::Descriptor usage[] =
     {
-     {UNKNOWN,  0, "", "",         option::Arg::None,      "USAGE: yam [options] [ -- files ] \n\n"
+     {UNKNOWN,  0, "", "",         option::Arg::None,      "USAGE: yam [options] [ -- files ] \n"
+                                                           "       yam query deps|rdeps|somepath|allpaths <nodes>\n\n"
                                                            "Options:" },
      {HELP,     0, "",  "help",     option::Arg::None,     "  --help \tPrint usage and exit." },
      {CLEAN,    0, "",  "clean",    option::Arg::None,     "  --clean \tDelete specified output files" },
      {SHUTDOWN, 0, "",  "shutdown", option::Arg::None,     "  --shutdown \tShutdown yamServer" },
      {NOSRV,    0, "",  "noServer", option::Arg::None,     "  --noServer \tRun yam without yamServer" },
      {THREADS,  0, "j", "threads",  option::Arg::Optional, "  --threads=N \tRun up to N commands in parallel. Default is number of logical cores." },
+     {MINTHREADS,0, "", "minThreads",option::Arg::Optional, "  --minThreads=N \tWithout --threads: run at least N commands in parallel. Default is number of logical cores / 4." },
+     {MAXTHREADS,0, "", "maxThreads",option::Arg::Optional, "  --maxThreads=N \tWithout --threads: run at most N commands in parallel. Default is 2 * number of logical cores." },
+     {IOTHREADS,0, "",  "ioThreads",option::Arg::Optional, "  --ioThreads=N \tRun up to N file hash and directory read tasks in parallel. Default is number of logical cores." },
      {UNKNOWN,  0, "", "",         option::Arg::None, "\nExamples:\n"
                                    "  yam --clean bin/**\n"
-                                   "  yam -- bin/main.obj bin/lib.obj\n" },
+                                   "  yam -- bin/main.obj bin/lib.obj\n"
+                                   "  yam query rdeps src/lib.h\n" },
      {0,0,0,0,0,0}
     };
 }
@@ -64,6 +72,12 @@ namespace YAM
             if (options[CLEAN]) buildOptions._clean = true;
             option::Option &threads = options[THREADS];
             if (threads && threads.arg) buildOptions._threads = atoi(threads.arg);
+            option::Option &minThreads = options[MINTHREADS];
+            if (minThreads && minThreads.arg) buildOptions._minThreads = atoi(minThreads.arg);
+            option::Option &maxThreads = options[MAXTHREADS];
+            if (maxThreads && maxThreads.arg) buildOptions._maxThreads = atoi(maxThreads.arg);
+            option::Option &ioThreads = options[IOTHREADS];
+            if (ioThreads && ioThreads.arg) buildOptions._ioThreads = atoi(ioThreads.arg);
             if (options[NOSRV]) _noServer = true;
             if (options[SHUTDOWN]) _shutdown = true;
 
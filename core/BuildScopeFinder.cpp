@@ -12,10 +12,6 @@ namespace
 {
     using namespace YAM;
 
-    static const std::string cmdClass("CommandNode");
-    static const std::string forEachClass("ForEachNode");
-    static const std::string genFileClass("GeneratedFileNode");
-
     bool pathMatchesGlobs(
         std::vector<Glob> const& globs,
         std::filesystem::path const& path
@@ -76,18 +72,14 @@ namespace
 
     void appendDirtyNodes(
         ExecutionContext* context,
-        std::string const& nodeClass,
+        NodeKind kind,
         std::vector<std::shared_ptr<Node>>& dirtyNodes
     ) {
-        auto const& dirtyNodesMap = context->nodes().dirtyNodes();
-        auto it = dirtyNodesMap.find(nodeClass);
-        if (it != dirtyNodesMap.end()) {
-            for (auto const& node : it->second) {
-                if (node->state() != Node::State::Dirty) throw std::runtime_error("not a dirty node");
-                auto repoType = node->repository()->repoType();
-                if (repoType == FileRepositoryNode::RepoType::Build) {
-                    dirtyNodes.push_back(node);
-                }
+        for (auto node : context->nodes().dirtyNodes(kind)) {
+            if (node->state() != Node::State::Dirty) throw std::runtime_error("not a dirty node");
+            auto repoType = node->repository()->repoType();
+            if (repoType == FileRepositoryNode::RepoType::Build) {
+                dirtyNodes.push_back(node->shared_from_this());
             }
         }
     }
@@ -118,7 +110,7 @@ namespace
     ) {
         if (!globs.empty()) {
             std::vector<std::shared_ptr<Node>> dirtyNodes;
-            appendDirtyNodes(context, cmdClass, dirtyNodes);
+            appendDirtyNodes(context, NodeKind::Command, dirtyNodes);
             std::vector<std::shared_ptr<CommandNode>> dirtyCmds;
             castNodes<Node, CommandNode>(dirtyNodes, dirtyCmds);
             for (auto const& cmd : dirtyCmds) {
@@ -205,13 +197,13 @@ namespace YAM
     std::vector<std::shared_ptr<Node>> BuildScopeFinder::dirtyCommands() const {
         std::vector<std::shared_ptr<Node>> dirtyCmds;
         if (_paths.empty() && _globs.empty()) {
-            appendDirtyNodes(_context, cmdClass, dirtyCmds);
+            appendDirtyNodes(_context, NodeKind::Command, dirtyCmds);
         } else {
             findDirtyCmdsByPaths(_context, _paths, dirtyCmds);
             findDirtyCmdsByGlobs(_context, _globs, dirtyCmds);
         }
         std::vector<std::shared_ptr<Node>> dirtyNodes;
-        appendDirtyNodes(_context, forEachClass, dirtyNodes);
+        appendDirtyNodes(_context, NodeKind::ForEach, dirtyNodes);
         if (!dirtyNodes.empty()) {
             std::vector<std::shared_ptr<ForEachNode>> dirtyForEach;
             castNodes<Node, ForEachNode>(dirtyNodes, dirtyForEach);
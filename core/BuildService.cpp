@@ -3,8 +3,55 @@
 #include "BuildServiceProtocol.h"
 #include "BuildServiceMessageTypes.h"
 #include "BuildServicePortRegistry.h"
+#include "BuildOptions.h"
+#include "ExecutionContext.h"
+#include "JobServer.h"
+#include "GraphSnapshot.h"
 
 #include <string>
+#include <thread>
+#include <algorithm>
+
+namespace
+{
+    using namespace YAM;
+
+    ThreadPoolSizeController::Config poolSizeConfig() {
+        std::size_t nCores = std::max(1u, std::thread::hardware_concurrency());
+        ThreadPoolSizeController::Config config;
+        config.minSize = std::max<std::size_t>(1, nCores / 4);
+        config.maxSize = 2 * nCores;
+        return config;
+    }
+
+    // Return the pool size bounds requested by options. The pool does not
+    // grow beyond the job token budget: commands acquire a token before
+    // they execute, threads in excess of the budget would only wait.
+    std::pair<std::size_t, std::size_t> poolSizeBounds(BuildOptions const& options, JobServer const* jobServer) {
+        ThreadPoolSizeController::Config defaults = poolSizeConfig();
+        std::size_t maxSize = options._maxThreads == 0 ? defaults.maxSize : options._maxThreads;
+        if (jobServer != nullptr) maxSize = std::min<std::size_t>(maxSize, jobServer->nTokens());
+        maxSize = std::max<std::size_t>(1, maxSize);
+        std::size_t minSize = options._minThreads == 0 ? defaults.minSize : options._minThreads;
+        minSize = std::clamp<std::size_t>(minSize, 1, maxSize);
+        return { minSize, maxSize };
+    }
+
+    std::shared_ptr<NodeStatusResult> nodeStatus(NodeStatusRequest const& request, GraphSnapshot const& snapshot) {
+        auto result = std::make_shared<NodeStatusResult>();
+        result->epoch(snapshot.epoch());
+        for (auto const& name : request.nodes()) {
+            NodeStatusResult::NodeStatus status{ name, false, Node::State::Dirty };
+            auto node = snapshot.find(name);
+            if (node != nullptr) {
+                status.found = true;
+                status.state = node->state;
+            }
+            result->add(status);
+        }
+        return result;
+    }
+}
 
 namespace YAM
 {
@@ -12,6 +59,7 @@ namespace YAM
         : _service(boost::asio::ip::tcp::v4(), 0)
         , _acceptor(_context, _service)
         , _logBook(std::make_shared<BuildServiceLogBook>(this))
+        , _poolSizeController(_builder.context()->processPool(), poolSizeConfig(), _logBook)
         , _serviceThread(&BuildService::run, this)
     {}
 
@@ -40,7 +88,14 @@ namespace YAM
                 std::shared_ptr<IStreamable> request = _protocol->receive();
                 shutdown = dynamic_pointer_cast<ShutdownRequest>(request) != nullptr;
                 while (!shutdown && request != nullptr) {
-                    postRequest(request);
+                    auto statusRequest = dynamic_pointer_cast<NodeStatusRequest>(request);
+                    if (statusRequest != nullptr) {
+                        // Answered from the last published snapshot, i.e.
+                        // without waiting for the main thread.
+                        send(nodeStatus(*statusRequest, *(_builder.context()->snapshot())));
+                    } else {
+                        postRequest(request);
+                    }
                     request = _protocol->receive();
                     shutdown = dynamic_pointer_cast<ShutdownRequest>(request) != nullptr;
                 }
@@ -78,6 +133,13 @@ namespace YAM
                 _logBook->aspects(aspects());
                 _builder.completor().AddRaw(this, &BuildService::handleBuildCompletion);
                 _builder.start(buildRequest);
+                if (_builder.running() && buildRequest->options()._threads == 0) {
+                    auto [minSize, maxSize] = poolSizeBounds(
+                        buildRequest->options(),
+                        _builder.context()->jobServer().get());
+                    _poolSizeController.bounds(minSize, maxSize);
+                    _poolSizeController.start();
+                }
             }
         } else if (stopRequest != nullptr) {
             if (_builder.running()) _builder.stop();
@@ -89,6 +151,7 @@ namespace YAM
     // Called in main thread
     void BuildService::handleBuildCompletion(std::shared_ptr<BuildResult> result) {
         _builder.completor().RemoveObject(this);
+        _poolSizeController.stop();
         send(result);
     }
 
@@ -101,6 +164,7 @@ namespace YAM
             protocol = _protocol;
         }
         if (client != nullptr && protocol != nullptr) {
+            std::lock_guard<std::mutex> lock(_sendMutex);
             try {
                 protocol->send(msg);
             } catch (std::exception&) {
@@ -3,6 +3,7 @@
 #include "Dispatcher.h"
 #include "ILogBook.h"
 #include "Builder.h"
+#include "ThreadPoolSizeController.h"
 
 #include <memory>
 #include <atomic>
@@ -20,6 +21,11 @@ namespace YAM
     // A build service accepts a tcp/ip connection from the build client. 
     // Only one client at-a-time can connect.
     // Service adheres to BuildServiceProtocol.
+    // During a build that uses the default number of threads the service
+    // adapts the thread pool size to the system load, see 
+    // ThreadPoolSizeController.
+    // NodeStatusRequests are answered in the service thread from the last
+    // published GraphSnapshot, also while the main thread is busy.
     //
     class __declspec(dllexport) BuildService : public ILogBook
     {
@@ -61,9 +67,13 @@ namespace YAM
         boost::asio::ip::tcp::acceptor _acceptor;
         std::shared_ptr<BuildServiceLogBook> _logBook;
         Builder _builder;
+        ThreadPoolSizeController _poolSizeController;
         std::thread _serviceThread;
         std::mutex _connectMutex;
         std::mutex _logMutex;
+        // Serializes messages sent from the main thread, the service thread
+        // and logging threads.
+        std::mutex _sendMutex;
         std::shared_ptr<TcpStream> _client;
         std::shared_ptr<BuildServiceProtocol> _protocol;
     };
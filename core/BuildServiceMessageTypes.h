@@ -5,6 +5,8 @@
 #include "StopBuildRequest.h"
 #include "ShutdownRequest.h"
 #include "LogRecord.h"
+#include "NodeStatusRequest.h"
+#include "NodeStatusResult.h"
 
 namespace YAM
 {
@@ -18,7 +20,9 @@ namespace YAM
             BuildResult = 2,
             StopBuildRequest = 3,
             ShutdownRequest = 4,
-            LogRecord = 5
+            LogRecord = 5,
+            NodeStatusRequest = 6,
+            NodeStatusResult = 7
         };
 
         BuildServiceMessageTypes() {
@@ -27,6 +31,8 @@ namespace YAM
             StopBuildRequest::setStreamableType(static_cast<uint32_t>(StopBuildRequest));
             ShutdownRequest::setStreamableType(static_cast<uint32_t>(ShutdownRequest));
             LogRecord::setStreamableType(static_cast<uint32_t>(LogRecord));
+            NodeStatusRequest::setStreamableType(static_cast<uint32_t>(NodeStatusRequest));
+            NodeStatusResult::setStreamableType(static_cast<uint32_t>(NodeStatusResult));
         }
     };
 }
@@ -24,6 +24,7 @@ namespace
             switch (mtid) {
                 case BuildServiceMessageTypes::BuildResult: return tid;
                 case BuildServiceMessageTypes::LogRecord: return tid;
+                case BuildServiceMessageTypes::NodeStatusResult: return tid;
                 default: throw std::exception("Build service error: attempt to send illegal msg to client");
             }
             return tid;
@@ -40,6 +41,7 @@ namespace
                 case BuildServiceMessageTypes::BuildRequest: return new BuildRequest(streamer);
                 case BuildServiceMessageTypes::StopBuildRequest: return new StopBuildRequest(streamer);
                 case BuildServiceMessageTypes::ShutdownRequest: return new ShutdownRequest(streamer);
+                case BuildServiceMessageTypes::NodeStatusRequest: return new NodeStatusRequest(streamer);
                 default: throw std::exception("Build service protocol error: illegal msg received by service");
             }
         }
@@ -56,6 +58,7 @@ namespace
                 case BuildServiceMessageTypes::BuildRequest: return tid;
                 case BuildServiceMessageTypes::StopBuildRequest: return tid;
                 case BuildServiceMessageTypes::ShutdownRequest: return tid;
+                case BuildServiceMessageTypes::NodeStatusRequest: return tid;
                 default: throw std::exception("Build service protocol error: attempt to send illegal msg to service");
             }
         }
@@ -70,6 +73,7 @@ namespace
             switch (mtid) {
                 case BuildServiceMessageTypes::BuildResult: return new BuildResult(streamer);
                 case BuildServiceMessageTypes::LogRecord: return new LogRecord(streamer);
+                case BuildServiceMessageTypes::NodeStatusResult: return new NodeStatusResult(streamer);
                 default: throw std::exception("Build service protocol error: illegal msg received by client");
             }
         }
@@ -5,7 +5,18 @@
 
 namespace
 {
-    uint32_t _writeVersion = 1;
+    // Version 2: CommandNode stores its script execution duration.
+    // Version 3: CommandNode, ForEachNode and rules store resource claims.
+    // Version 4: FileNode stores aspect hashes by aspect index.
+    // Version 5: entire file hashes are XXH3-64 instead of XXH64 hashes.
+    // Version 6: the build state stores the file aspect names by build
+    //            state aspect index, FileNode stores aspect hashes by build
+    //            state aspect index. Older versions stored hashes by the
+    //            aspect indices of the process that stored them, these
+    //            cannot be mapped to aspect names.
+    //            Only version 6 is readable: version 4 and 5 build states
+    //            are dropped and all files are rehashed.
+    uint32_t _writeVersion = 6;
     std::vector<uint32_t> _readableVersions = { _writeVersion };
     const std::string _prefix("buildstate_");
     const std::string _ext("bt");
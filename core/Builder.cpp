@@ -21,12 +21,19 @@
 #include "Globber.h"
 #include "Glob.h"
 #include "BuildScopeFinder.h"
+#include "DependencyIndex.h"
+#include "GraphSnapshot.h"
+#include "CriticalPath.h"
+#include "JobServer.h"
+#include "FileHashCache.h"
 #include "PeriodicTimer.h"
 #include "FileSystem.h"
 
 #include <iostream>
 #include <map>
 #include <atomic>
+#include <mutex>
+#include <sstream>
 
 #include "../accessMonitor/Monitor.h"
 
@@ -35,36 +42,26 @@ namespace
     using namespace YAM;
 
     std::vector<std::shared_ptr<Node>> emptyNodes;
-    static std::string dirClass("DirectoryNode");
-    static std::string parserClass("BuildFileParserNode");
-    static std::string compilerClass("BuildFileCompilerNode");
-    static std::string cmdClass("CommandNode");
 
     void resetFailedAndCanceledNodes(NodeSet& nodes) {
         std::vector<std::shared_ptr<Node>> toReset;
-        for (auto const& pair : nodes.failedOrCanceledNodes()) {
-            toReset.insert(toReset.end(), pair.second.begin(), pair.second.end());
-        }
+        nodes.appendFailedOrCanceledNodes(toReset);
         for (auto const& node : toReset) node->setState(Node::State::Dirty);
     }
 
     template<typename T>
     void appendDirtyNodes(
         ExecutionContext* context,
-        std::string const& nodeClass,
+        NodeKind kind,
         std::vector<std::shared_ptr<T>>& dirtyNodes
     ) {
-        auto const& dirtyNodesMap = context->nodes().dirtyNodes();
-        auto it = dirtyNodesMap.find(nodeClass);
-        if (it != dirtyNodesMap.end()) {
-            for (auto const& node : it->second) {
-                auto repoType = node->repository()->repoType();
-                if (repoType != FileRepositoryNode::RepoType::Ignore) {
-                    auto tnode = dynamic_pointer_cast<T>(node);
-                    if (tnode == nullptr) throw std::runtime_error("not a node of type T");
-                    if (tnode->state() != Node::State::Dirty) throw std::runtime_error("not a dirty node");
-                    dirtyNodes.push_back(tnode);
-                }
+        for (auto node : context->nodes().dirtyNodes(kind)) {
+            auto repoType = node->repository()->repoType();
+            if (repoType != FileRepositoryNode::RepoType::Ignore) {
+                auto tnode = dynamic_pointer_cast<T>(node->shared_from_this());
+                if (tnode == nullptr) throw std::runtime_error("not a node of type T");
+                if (tnode->state() != Node::State::Dirty) throw std::runtime_error("not a dirty node");
+                dirtyNodes.push_back(tnode);
             }
         }
     }
@@ -72,11 +69,11 @@ namespace
     template<typename T>
     void appendDirtyNodesMap(
         ExecutionContext* context,
-        std::string const& nodeClass,
+        NodeKind kind,
         std::map<std::filesystem::path, std::shared_ptr<T>>& dirtyNodes
     ) {
         std::vector<std::shared_ptr<T>> dirtyNodesVec;
-        appendDirtyNodes<T>(context, nodeClass, dirtyNodesVec);
+        appendDirtyNodes<T>(context, kind, dirtyNodesVec);
         for (auto const& node : dirtyNodesVec) {
             dirtyNodes.insert({ node->name(), node });
         }
@@ -131,6 +128,14 @@ namespace
 
 namespace YAM
 {
+    // Serializes the dependency index writes of a builder. A write is
+    // skipped when a later build requested a newer write.
+    struct Builder::DependencyIndexWrites {
+        std::mutex mutex;
+        std::atomic<uint64_t> nRequested = 0;
+        std::atomic<bool> failed = false;
+    };
+
     // Called in any thread
     Builder::Builder()
         : _dirtyConfigNodes(std::make_shared<GroupNode>(&_context, "__dirtyConfigNodes"))
@@ -139,11 +144,13 @@ namespace YAM
         , _dirtyBuildFileCompilers(std::make_shared<GroupNode>(&_context, "__dirtyBuildFileCompilers__"))
         , _dirtyCommands(std::make_shared<GroupNode>(&_context, "__dirtyCommands__"))
         , _result(nullptr)
+        , _dependencyIndexStale(true)
+        , _dependencyIndexWrites(std::make_shared<DependencyIndexWrites>())
         , _periodicStorage(
             std::make_shared<PeriodicTimer>(
                 std::chrono::seconds(10),
                 _context.mainThreadQueue(),
-                Delegate<void>::CreateLambda([this]() { _storeBuildState(); })))
+                Delegate<void>::CreateLambda([this]() { _storeBuildStateAndPublishSnapshot(); })))
     {
         _dirtyConfigNodes->completor().AddRaw(this, &Builder::_handleConfigNodesCompletion);
         _dirtyDirectories->completor().AddRaw(this, &Builder::_handleDirectoriesCompletion);
@@ -180,7 +187,8 @@ namespace YAM
     void Builder::start(std::shared_ptr<BuildRequest> request) {
         ASSERT_MAIN_THREAD(&_context);
         if (running()) throw std::exception("request handling already in progress");
-        _context.statistics().reset();
+        _context.resetStatistics();
+        _context.resetResourcePoolClaims();
         _context.buildRequest(request);
         _result = std::make_shared<BuildResult>();
         bool ok = _init(request);
@@ -220,7 +228,16 @@ namespace YAM
         uint32_t threads = request->options()._threads;
         if (threads == 0) threads = defaultThreads;
         else if (threads > maxThreads) threads = maxThreads;
-        _context.threadPool().size(threads);
+        _context.processPool().size(threads);
+        // Nested make, ninja and cargo builds share the thread budget.
+        auto jobServer = _context.jobServer();
+        if (jobServer == nullptr || jobServer->nTokens() != threads) {
+            _context.jobServer(std::make_shared<JobServer>(threads));
+        }
+        uint32_t ioThreads = request->options()._ioThreads;
+        if (ioThreads == 0) ioThreads = defaultThreads;
+        else if (ioThreads > maxThreads) ioThreads = maxThreads;
+        _context.ioPool().size(ioThreads);
 
 		deleteLeftoverFiles(FileSystem::yamTempFolder(), _context.logBook().get());
 
@@ -256,6 +273,21 @@ namespace YAM
                 repositoriesNode->startWatching();
             }
         }
+        // File hashes are shared with other worktrees and yamServers. The
+        // cache is sized for the retrieved build state and grows with it.
+        std::size_t nSlots = FileHashCache::slotsFor(_context.nodes().size());
+        auto const& currentCache = _context.fileHashCache();
+        if (currentCache == nullptr || currentCache->nSlots() < nSlots) {
+            std::filesystem::path cachePath = FileHashCache::defaultPath(nSlots);
+            auto cache = std::make_shared<FileHashCache>(cachePath, nSlots);
+            if (cache->good()) {
+                _context.fileHashCache(cache);
+            } else if (currentCache == nullptr) {
+                std::stringstream ss;
+                ss << "Cannot open file hash cache " << cachePath.string() << ", files will be rehashed.";
+                _context.addToLogBook(LogRecord(LogRecord::Warning, ss.str()));
+            }
+        }
         return _result->state() == BuildResult::State::Ok;
     }
 
@@ -324,6 +356,7 @@ namespace YAM
         auto start = std::chrono::system_clock::now();
         ILogBook& logBook = *(_context.logBook());
         std::size_t nStored = _buildState->store();
+        if (0 < nStored) _dependencyIndexStale = true;
         if (logBook.mustLogAspect(LogRecord::BuildStateUpdate) && 0 < nStored) {
             auto duration = std::chrono::system_clock::now() - start;
             auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(duration);
@@ -334,6 +367,48 @@ namespace YAM
         }
     }
 
+    // Called in main thread
+    void Builder::_storeBuildStateAndPublishSnapshot() {
+        _storeBuildState();
+        _context.publishSnapshot();
+    }
+
+    void Builder::_storeDependencyIndex(std::filesystem::path const& repoDir) {
+        if (_buildState == nullptr) return;
+        if (!_dependencyIndexStale && !_dependencyIndexWrites->failed) return;
+        auto start = std::chrono::system_clock::now();
+        std::shared_ptr<ILogBook> logBook = _context.logBook();
+        std::filesystem::path path = DependencyIndex::filePath(repoDir / DotYamDirectory::yamName());
+        // Published by _storeBuildStateAndPublishSnapshot().
+        std::shared_ptr<const GraphSnapshot> snapshot = _context.snapshot();
+        _dependencyIndexStale = false;
+        std::shared_ptr<DependencyIndexWrites> writes = _dependencyIndexWrites;
+        uint64_t request = ++writes->nRequested;
+        auto d = Delegate<void>::CreateLambda([writes, request, snapshot, path, logBook, start]() {
+            std::lock_guard<std::mutex> lock(writes->mutex);
+            if (writes->nRequested != request) return;
+            try {
+                std::shared_ptr<DependencyIndex::Graph> graph = DependencyIndex::graph(*snapshot);
+                DependencyIndex::write(path, graph->names, graph->edges);
+                writes->failed = false;
+            } catch (std::exception const& e) {
+                writes->failed = true;
+                LogRecord warning(LogRecord::Warning, std::string("Failed to update dependency index: ") + e.what());
+                logBook->add(warning);
+                return;
+            }
+            if (logBook->mustLogAspect(LogRecord::BuildStateUpdate)) {
+                auto duration = std::chrono::system_clock::now() - start;
+                auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(duration);
+                std::stringstream ss;
+                ss << "Updated dependency index in " << ms << std::endl;
+                LogRecord saving(LogRecord::Progress, ss.str());
+                logBook->add(saving);
+            }
+        });
+        _context.ioQueue().push(std::move(d), PriorityClass::VeryLow);
+    }
+
     // Called in main thread
     void Builder::_start() {
         _periodicStorage->resume();
@@ -379,7 +454,7 @@ namespace YAM
             _postCompletion(Node::State::Failed);
         } else {
             std::map<std::filesystem::path, std::shared_ptr<DirectoryNode>> dirtyDirs;
-            appendDirtyNodesMap<DirectoryNode>(&_context, dirClass, dirtyDirs);
+            appendDirtyNodesMap<DirectoryNode>(&_context, NodeKind::Directory, dirtyDirs);
             std::vector<std::shared_ptr<Node>> prunedDirtyDirs = pruneDirtyDirectories(dirtyDirs);
             if (prunedDirtyDirs.empty()) {
                 _handleDirectoriesCompletion(_dirtyDirectories.get());
@@ -401,7 +476,7 @@ namespace YAM
             _postCompletion(Node::State::Failed);
         } else {
             std::vector<std::shared_ptr<Node>> dirtyBuildFiles;
-            appendDirtyNodes<Node>(&_context, parserClass, dirtyBuildFiles);
+            appendDirtyNodes<Node>(&_context, NodeKind::BuildFileParser, dirtyBuildFiles);
             if (dirtyBuildFiles.empty()) {
                 _handleBuildFileParsersCompletion(_dirtyBuildFileParsers.get());
             } else {
@@ -427,7 +502,7 @@ namespace YAM
             _postCompletion(Node::State::Failed);
         } else {
             std::vector<std::shared_ptr<Node>> dirtyBuildFileCompilers;
-            appendDirtyNodes<Node>(&_context, compilerClass, dirtyBuildFileCompilers);
+            appendDirtyNodes<Node>(&_context, NodeKind::BuildFileCompiler, dirtyBuildFileCompilers);
             if (dirtyBuildFileCompilers.empty()) {
                 _handleBuildFileCompilersCompletion(_dirtyBuildFileCompilers.get());
             } else {
@@ -471,6 +546,14 @@ namespace YAM
                     LogRecord executing(LogRecord::Progress, "Executing commands");
                     logBook.add(executing);
 
+                    // Execute scripts of commands on long dependency chains
+                    // before scripts of commands on short chains.
+                    IPriorityDispatcher& queue = _context.processQueue();
+                    CriticalPath criticalPath(dirtyCommands);
+                    criticalPath.assignPriorities(
+                        queue.priorityOf(PriorityClass::Low),
+                        queue.priorityOf(PriorityClass::High));
+
                     std::vector<std::shared_ptr<Node>> dirtyNodes;
                     dirtyNodes.insert(dirtyNodes.end(), dirtyCommands.begin(), dirtyCommands.end());
                     _dirtyCommands->content(dirtyNodes);
@@ -499,16 +582,30 @@ namespace YAM
     // Called in main thread
     void Builder::_notifyCompletion(Node::State resultState) {
         _periodicStorage->suspend();
-        _storeBuildState();
+        _storeBuildStateAndPublishSnapshot();
         auto state = BuildResult::State::Unknown;
         if (resultState == Node::State::Ok) state = BuildResult::State::Ok;
         else if (resultState == Node::State::Canceled) state = BuildResult::State::Canceled;
         else if (resultState == Node::State::Failed) state = BuildResult::State::Failed;
         _result->state(state);
+        _context.statistics().merge();
         _result->nDirectoryUpdates(_context.statistics().nDirectoryUpdates);
         _result->nNodesExecuted(_context.statistics().nSelfExecuted);
         _result->nNodesStarted(_context.statistics().nStarted);
         _result->nRehashedFiles(_context.statistics().nRehashedFiles);
+        _context.updateQueueStatistics();
+        if (_context.logBook()->mustLogAspect(LogRecord::Performance)) {
+            ExecutionStatistics const& stats = _context.statistics();
+            std::stringstream ss;
+            ss << "I/O queue: max depth=" << stats.ioQueue.maxDepth 
+                << " delegates=" << stats.ioQueue.nDelegates 
+                << " threads=" << _context.ioPool().size() << std::endl;
+            ss << "Process queue: max depth=" << stats.processQueue.maxDepth
+                << " delegates=" << stats.processQueue.nDelegates
+                << " threads=" << _context.processPool().size();
+            LogRecord d(LogRecord::Performance, ss.str());
+            _context.addToLogBook(d);
+        }
         _dirtyConfigNodes->content(emptyNodes);
         _dirtyDirectories->content(emptyNodes);
         _dirtyBuildFileParsers->content(emptyNodes);
@@ -523,8 +620,11 @@ namespace YAM
         //_buildState->logState(*(_context.logBook()));
         auto result = _result;
         _result = nullptr;
+        std::shared_ptr<BuildRequest> request = _context.buildRequest();
         _context.buildRequest(nullptr);
         _completor.Broadcast(result);
+        // After reporting the result to not delay the client.
+        if (request != nullptr) _storeDependencyIndex(request->repoDirectory());
     }
 
     bool Builder::running() {
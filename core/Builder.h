@@ -58,6 +58,13 @@ namespace YAM
         void _postCompletion(Node::State resultState);
         void _notifyCompletion(Node::State resultState);
         void _storeBuildState();
+        // When build state changed since last write: write the
+        // DependencyIndex of the last published snapshot in an io thread.
+        void _storeDependencyIndex(std::filesystem::path const& repoDir);
+        // Called periodically during a build and at build completion.
+        // Publishing only takes the nodes changed since the previous
+        // snapshot, see ExecutionContext::publishSnapshot().
+        void _storeBuildStateAndPublishSnapshot();
 
         ExecutionContext _context;
         std::shared_ptr<PersistentBuildState> _buildState;
@@ -69,6 +76,9 @@ namespace YAM
         std::shared_ptr<GroupNode> _dirtyBuildFileCompilers;
         std::shared_ptr<GroupNode> _dirtyCommands;
         std::shared_ptr<BuildResult> _result;
+        bool _dependencyIndexStale;
+        struct DependencyIndexWrites;
+        std::shared_ptr<DependencyIndexWrites> _dependencyIndexWrites;
         std::shared_ptr<PeriodicTimer> _periodicStorage;
     };
 }
@@ -5,6 +5,7 @@
 #include "GroupNode.h"
 #include "ExecutionContext.h"
 #include "MonitoredProcess.h"
+#include "JobServer.h"
 #include "FileAspectSet.h"
 #include "FileSystem.h"
 #include "FileRepositoryNode.h"
@@ -30,6 +31,30 @@ namespace
 
     std::mutex removeAllMutex;
 
+    // Awaitable that resumes the awaiting coroutine when the pool admits it
+    // to its dispatcher, see ResourcePool::admit(..). The claimed tokens
+    // are released when the coroutine suspends or returns after resumption.
+    class AdmitTo
+    {
+    public:
+        AdmitTo(std::shared_ptr<ResourcePool> const& pool, uint32_t prio, uint32_t tokens)
+            : _pool(pool), _prio(prio), _tokens(tokens)
+        {}
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<NodeTask::promise_type> handle) const {
+            _pool->admit(
+                Delegate<void>::CreateLambda([handle]() { NodeTask::resume(handle); }),
+                _prio, _tokens);
+        }
+        void await_resume() const noexcept {}
+
+    private:
+        std::shared_ptr<ResourcePool> _pool;
+        uint32_t _prio;
+        uint32_t _tokens;
+    };
+
     std::vector<std::shared_ptr<Node>> getFileNodes(std::vector<std::shared_ptr<Node>> const& nodes) {
         std::vector<std::shared_ptr<Node>> files;
         for (auto const& node : nodes) {
@@ -55,27 +80,6 @@ namespace
         }
     }
 
-    void computePathSetsDifference(
-        std::set<std::filesystem::path> const& in1,
-        std::set<std::filesystem::path> const& in2,
-        std::set<std::filesystem::path>& inBoth,
-        std::set<std::filesystem::path>& onlyIn1,
-        std::set<std::filesystem::path>& onlyIn2
-    ) {
-        std::set_intersection(
-            in1.begin(), in1.end(),
-            in2.begin(), in2.end(),
-            std::inserter(inBoth, inBoth.begin()));
-        std::set_difference(
-            in1.begin(), in1.end(),
-            inBoth.begin(), inBoth.end(),
-            std::inserter(onlyIn1, onlyIn1.begin()));
-        std::set_difference(
-            in2.begin(), in2.end(),
-            inBoth.begin(), inBoth.end(),
-            std::inserter(onlyIn2, onlyIn2.begin()));
-    }
-
     bool isGenerated(std::shared_ptr<Node> const& node) {
         return nullptr != dynamic_cast<GeneratedFileNode*>(node.get());
     }
@@ -398,7 +402,8 @@ namespace YAM
 
     CommandNode::CommandNode()
         : Node()
-        , _buildFile(nullptr) {}
+        , _buildFile(nullptr)
+        , _executionDuration(0) {}
 
     CommandNode::CommandNode(
         ExecutionContext* context,
@@ -407,6 +412,7 @@ namespace YAM
         , _buildFile(nullptr)
         , _inputAspectsName(FileAspectSet::entireFileSet().name())
         , _executionHash(rand())
+        , _executionDuration(0)
     {}
 
     CommandNode::~CommandNode() {
@@ -571,22 +577,11 @@ namespace YAM
     }
 
     void CommandNode::updateMandatoryOutputs(std::vector<std::shared_ptr<GeneratedFileNode>> const& outputs) {
-        OutputNodes newMandatoryOutputs;
-        for (auto const& output : outputs) newMandatoryOutputs.insert({ output->name(), output });
+        OutputNodes newMandatoryOutputs(outputs);
+        std::vector<std::shared_ptr<GeneratedFileNode>> kept;
         std::vector<std::shared_ptr<GeneratedFileNode>> toRemove;
         std::vector<std::shared_ptr<GeneratedFileNode>> toAdd;
-        for (auto const& pair : newMandatoryOutputs) {
-            auto& newOutput = pair.second;
-            if (!_mandatoryOutputs.contains(newOutput->name())) {
-                toAdd.push_back(newOutput);
-            }
-        }
-        for (auto const& pair : _mandatoryOutputs) {
-            auto& oldOutput = pair.second;
-            if (!newMandatoryOutputs.contains(oldOutput->name())) {
-                toRemove.push_back(oldOutput);
-            }
-        }
+        computeNodeMapDifference(newMandatoryOutputs, _mandatoryOutputs, kept, toAdd, toRemove);
         for (auto& n : toRemove) {
             n->deleteFile(false, true);
             n->removeObserver(this);
@@ -676,6 +671,37 @@ namespace YAM
         return _executionHash;
     }
 
+    void CommandNode::executionDuration(std::chrono::nanoseconds duration) {
+        if (_executionDuration != duration) {
+            _executionDuration = duration;
+            modified(true);
+        }
+    }
+
+    std::chrono::nanoseconds CommandNode::executionDuration() const {
+        return _executionDuration;
+    }
+
+    void CommandNode::scriptPriority(uint32_t prio) {
+        _scriptPriority = prio;
+    }
+
+    uint32_t CommandNode::scriptPriority() const {
+        if (_scriptPriority.has_value()) return _scriptPriority.value();
+        return context()->processQueue().priorityOf(PriorityClass::High);
+    }
+
+    void CommandNode::resourceClaim(ResourceClaim const& claim) {
+        if (!(_resourceClaim == claim)) {
+            _resourceClaim = claim;
+            modified(true);
+        }
+    }
+
+    ResourceClaim const& CommandNode::resourceClaim() const {
+        return _resourceClaim;
+    }
+
     XXH64_hash_t CommandNode::computeExecutionHash(std::vector<OutputNameFilter> const& filters) const {
         XXH64_state_t* state = XXH64_createState();
         XXH64_reset(state, 0);
@@ -689,18 +715,16 @@ namespace YAM
         for (auto const& node : _cmdInputs) {
             std::string nname = node->name().string();
             XXH64_update(state, nname.data(), nname.length());
-            auto grpNode = dynamic_pointer_cast<GroupNode>(node);
-            if (grpNode != nullptr) {
-                XXH64_hash_t grpHash = grpNode->hash();
+            if (node->kind() == NodeKind::Group) {
+                XXH64_hash_t grpHash = static_cast<GroupNode*>(node.get())->hash();
                 XXH64_update(state, &grpHash, sizeof(XXH64_hash_t));
             }
         }
         for (auto const& node : _orderOnlyInputs) {
             std::string nname = node->name().string();
             XXH64_update(state, nname.data(), nname.length());
-            auto grpNode = dynamic_pointer_cast<GroupNode>(node);
-            if (grpNode != nullptr) {
-                XXH64_hash_t grpHash = grpNode->hash();
+            if (node->kind() == NodeKind::Group) {
+                XXH64_hash_t grpHash = static_cast<GroupNode*>(node.get())->hash();
                 XXH64_update(state, &grpHash, sizeof(grpHash));
             }
         }
@@ -709,7 +733,7 @@ namespace YAM
             std::string fpath = filter._symPath.generic_string();
             XXH64_update(state, fpath.data(), fpath.length());
         }
-        auto entireFile = FileAspect::entireFileAspect().name();
+        FileAspect const& entireFile = FileAspect::entireFileAspect();
         for (auto const& pair : _mandatoryOutputs) {
             XXH64_hash_t hef = pair.second->hashOf(entireFile);
             XXH64_update(state, &hef, sizeof(hef));
@@ -718,11 +742,11 @@ namespace YAM
             XXH64_hash_t hef = pair.second->hashOf(entireFile);
             XXH64_update(state, &hef, sizeof(hef));
         }
-        FileAspectSet inputAspects = context()->findFileAspectSet(_inputAspectsName);
+        FileAspectSet const& inputAspects = context()->findFileAspectSet(_inputAspectsName);
         for (auto const& pair : _detectedInputs) {
             auto const& node = pair.second;
             FileAspect const& inputAspect = inputAspects.findApplicableAspect(node->name());
-            XXH64_hash_t hdi = node->hashOf(inputAspect.name());
+            XXH64_hash_t hdi = node->hashOf(inputAspect);
             XXH64_update(state, &hdi, sizeof(hdi));
         }
 
@@ -761,19 +785,14 @@ namespace YAM
         // producing CommandNode who then notifies its observers, i.e to nodes
         // that read one or more output files of the producing command node.
         // 
-        for (auto const& symPath : result._removedInputPaths) {  
-            auto it = _detectedInputs.find(symPath);
-            if (it == _detectedInputs.end()) throw std::exception("no such input");
-            auto const& node = it->second;
+        _detectedInputs.update(result._removedInputNodes, result._addedInputNodes);
+        for (auto const& node : result._removedInputNodes) {  
             if (!isGenerated(node)) node->removeObserver(this);
-            _detectedInputs.erase(it);
         }
         for (auto const& node : result._addedInputNodes) {
             if (!isGenerated(node)) node->addObserver(this);
-            auto result = _detectedInputs.insert({ node->name(), node });
-            if (!result.second) throw std::exception("attempt to add duplicate input");
         }
-        bool changed = !result._removedInputPaths.empty() || !result._addedInputNodes.empty();
+        bool changed = !result._removedInputNodes.empty() || !result._addedInputNodes.empty();
         if (changed) modified(true);
     }
 
@@ -799,7 +818,7 @@ namespace YAM
         }
         for (auto& n : newOptionals) {
             context()->nodes().add(n);
-            _detectedOptionalOutputs.insert({ n->name(), n });
+            _detectedOptionalOutputs.insert(n);
             n->addObserver(this);
         }
         for (auto const& output : allOptionals) {
@@ -883,7 +902,7 @@ namespace YAM
                     throw std::exception("illegal filter type");
                 } else if (outputType == OutputFilter::Type::Optional) {
                     auto sharedThis = dynamic_pointer_cast<CommandNode>(shared_from_this());
-                    outputNode = std::make_shared<GeneratedFileNode>(context(), outputPath, sharedThis);
+                    outputNode = makeShared<GeneratedFileNode>(context(), outputPath, sharedThis);
                     optionalOutputNodes.push_back(outputNode);
                     newOptionalOutputNodes.push_back(outputNode);
                 } else if (outputType == OutputFilter::Type::Ignore) {
@@ -975,6 +994,10 @@ namespace YAM
     // main thread
     void CommandNode::start(PriorityClass prio) {
         Node::start(prio);
+        execute(prio).start();
+    }
+
+    NodeTask CommandNode::execute(PriorityClass prio) {
         std::vector<Node*> requisites;
         for (auto const& ip : _inputProducers) {
             auto const& group = dynamic_pointer_cast<GroupNode>(ip);
@@ -992,29 +1015,42 @@ namespace YAM
         getSourceInputs(requisites);
         for (auto const& pair : _mandatoryOutputs) requisites.push_back(pair.second.get());
         for (auto const& pair : _detectedOptionalOutputs) requisites.push_back(pair.second.get());
-        auto callback = Delegate<void, Node::State>::CreateLambda(
-            [this](Node::State state) { handleRequisitesCompletion(state); }
-        );
-        startNodes(requisites, std::move(callback), prio);
-    }
-
-    void CommandNode::handleRequisitesCompletion(Node::State state) {
+        Node::State state = co_await awaitNodes(requisites, prio);
         if (state != Node::State::Ok) {
             Node::notifyCompletion(state);
-        } else if (canceling()) {
+            co_return;
+        }
+        if (canceling()) {
             Node::notifyCompletion(Node::State::Canceled);
-        } else if (_executionHash != computeExecutionHash(outputNameFilters())) {
-            context()->statistics().registerSelfExecuted(this);
-            for (auto const& pair : _mandatoryOutputs) {
-                DirectoryNode::addGeneratedFile(pair.second);
-            }
-            auto d = Delegate<void>::CreateLambda(
-                [this]() { executeScript(); }
-            );
-            context()->threadPoolQueue().push(std::move(d), PriorityClass::High);
-        } else {
+            co_return;
+        }
+        if (_executionHash == computeExecutionHash(outputNameFilters())) {
             Node::notifyCompletion(state);
+            co_return;
         }
+        context()->statistics().registerSelfExecuted(this);
+        for (auto const& pair : _mandatoryOutputs) {
+            DirectoryNode::addGeneratedFile(pair.second);
+        }
+        if (_resourceClaim.empty()) {
+            co_await ResumeOn(context()->processQueue(), scriptPriority());
+        } else {
+            // The pool pushes the coroutine to the process queue when the
+            // claimed tokens are available.
+            auto const& pool = context()->resourcePool(_resourceClaim);
+            co_await AdmitTo(pool, scriptPriority(), _resourceClaim.tokens);
+        }
+
+        ExecutionResult result;
+        executeScript(result);
+        co_await resumeOnMainThread();
+
+        std::vector<Node*> outputsAndNewInputs;
+        handleExecuteScriptCompletion(result, outputsAndNewInputs);
+        if (result._newState == Node::State::Ok) {
+            result._newState = co_await awaitNodes(outputsAndNewInputs, PriorityClass::VeryHigh);
+        }
+        handleOutputAndNewInputFilesCompletion(result);
     }
 
     std::filesystem::path CommandNode::convertToSymbolicPath(
@@ -1057,46 +1093,55 @@ namespace YAM
     }
 
     // threadpool
-    void CommandNode::executeScript() {
-        auto result = std::make_shared<ExecutionResult>();
-        result->_log.aspects(context()->logBook()->aspects());
-        result->_newState = Node::State::Ok;
+    void CommandNode::executeScript(ExecutionResult& result) {
+        result._log.aspects(context()->logBook()->aspects());
+        result._newState = Node::State::Ok;
+        result._duration = std::chrono::nanoseconds(0);
+        std::shared_ptr<JobServer> jobServer = context()->jobServer();
+        bool hasToken = false;
+        if (jobServer != nullptr) {
+            // The script's build tools may acquire more tokens, see JobServer.
+            while (!hasToken && !canceling()) {
+                hasToken = jobServer->acquire(std::chrono::milliseconds(100));
+            }
+        }
         if (canceling()) {
-            result->_newState = Node::State::Canceled;
+            result._newState = Node::State::Canceled;
         } else {
-            MonitoredProcessResult scriptResult = executeMonitoredScript(result->_log);
+            auto start = std::chrono::steady_clock::now();
+            MonitoredProcessResult scriptResult = executeMonitoredScript(result._log);
+            result._duration = std::chrono::steady_clock::now() - start;
+            if (hasToken) {
+                jobServer->release();
+                hasToken = false;
+            }
             if (scriptResult.exitCode != 0) {
-                result->_newState = canceling() ? Node::State::Canceled : Node::State::Failed;
+                result._newState = canceling() ? Node::State::Canceled : Node::State::Failed;
             } else {
-                result->_newState = Node::State::Ok;                
-                std::set<std::filesystem::path> previousInputPaths;
-                for (auto const& pair : _detectedInputs) {
-                    previousInputPaths.insert(pair.second->name());
-                }                    
-                auto currentInputPaths = convertToSymbolicPaths(scriptResult.readOnlyFiles, result->_log);
-                computePathSetsDifference(
-                    previousInputPaths, currentInputPaths,
-                    result->_keptInputPaths,
-                    result->_removedInputPaths,
-                    result->_addedInputPaths);
-
-                std::set<std::filesystem::path> outputPaths = convertToSymbolicPaths(scriptResult.writtenFiles, result->_log);
+                result._newState = Node::State::Ok;                
+                auto currentInputPaths = convertToSymbolicPaths(scriptResult.readOnlyFiles, result._log);
+                computeNodeMapDifference(
+                    _detectedInputs, currentInputPaths,
+                    result._keptInputNodes,
+                    result._removedInputNodes,
+                    result._addedInputPaths);
+
+                std::set<std::filesystem::path> outputPaths = convertToSymbolicPaths(scriptResult.writtenFiles, result._log);
                 for (auto const& path : outputPaths) {
-                    result->_outputPaths.insert({ path,findFilterType(path, outputNameFilters())});
+                    result._outputPaths.insert({ path,findFilterType(path, outputNameFilters())});
                 }
                 if (_postProcessor != nullptr) {
                     _postProcessor->process(scriptResult);
                 }
             }
         }
-        auto d = Delegate<void>::CreateLambda(
-            [this, result]() { handleExecuteScriptCompletion(result); }
-        );
-        context()->mainThreadQueue().push(std::move(d));
+        if (hasToken) jobServer->release();
     }
 
-    void CommandNode::handleExecuteScriptCompletion(std::shared_ptr<ExecutionResult> sresult) {
-        ExecutionResult& result = *sresult;
+    void CommandNode::handleExecuteScriptCompletion(
+        ExecutionResult& result,
+        std::vector<Node*>& outputsAndNewInputs
+    ) {
         if (result._newState != Node::State::Ok) {
         } else if (canceling()) {
             result._newState = Node::State::Canceled;
@@ -1108,16 +1153,19 @@ namespace YAM
             if (!validOutputs) {
                 result._newState = Node::State::Failed;
             } else {
-                std::vector< std::shared_ptr<Node>> outputsAndNewInputs;
+                std::vector< std::shared_ptr<Node>> newInputs;
                 std::map<std::filesystem::path, std::shared_ptr<GeneratedFileNode>> allowedGenInputFiles;
                 getOutputFileNodes(_inputProducers, allowedGenInputFiles);
+                std::vector<std::filesystem::path> keptInputPaths;
+                keptInputPaths.reserve(result._keptInputNodes.size());
+                for (auto const& n : result._keptInputNodes) keptInputPaths.push_back(n->name());
                 std::vector<std::shared_ptr<FileNode>> notUsed1;
                 std::vector<std::shared_ptr<Node>> notUsed2;
                 // Kept inputs must be validated because of possible change in 
                 // _inputproducers.
                 bool validKeptInputs = findInputNodes(
                     allowedGenInputFiles,
-                    result._keptInputPaths,
+                    keptInputPaths,
                     notUsed1,
                     notUsed2,
                     result._log);
@@ -1125,21 +1173,22 @@ namespace YAM
                     allowedGenInputFiles,
                     result._addedInputPaths,
                     result._addedInputNodes,
-                    outputsAndNewInputs,
+                    newInputs,
                     result._log);
                 if (validKeptInputs && validNewInputs) {
+                    for (auto const& n : newInputs) outputsAndNewInputs.push_back(n.get());
                     setDetectedInputs(result);
                     setDetectedOptionalOutputs(optionalOutputNodes, newOptionalOutputNodes);
                     // output nodes have been updated by command script, hence their
                     // hashes need to be re-computed.
-                    for (auto& pair : _mandatoryOutputs) {
+                    for (auto const& pair : _mandatoryOutputs) {
                         auto& n = pair.second;
                         // temporarily stop observing n to avoid Dirty state to
                         // propagate to this command (see handleDirtyOf()).
                         n->removeObserver(this);
                         n->setState(Node::State::Dirty);
                         n->addObserver(this);
-                        outputsAndNewInputs.push_back(n);
+                        outputsAndNewInputs.push_back(n.get());
                     }
                     for (auto const &pair : _detectedOptionalOutputs) {
                         // temporarily stop observing n to avoid Dirty state to
@@ -1148,32 +1197,21 @@ namespace YAM
                         n->removeObserver(this);
                         n->setState(Node::State::Dirty);
                         n->addObserver(this);
-                        outputsAndNewInputs.push_back(n);
+                        outputsAndNewInputs.push_back(n.get());
                     }
-                    std::vector<Node*> rawNodes;
-                    for (auto const& n : outputsAndNewInputs) rawNodes.push_back(n.get());
-                    auto callback = Delegate<void, Node::State>::CreateLambda(
-                        [this, sresult](Node::State state) { 
-                            handleOutputAndNewInputFilesCompletion(state, sresult); }
-                    );
-                    startNodes(rawNodes, std::move(callback), PriorityClass::VeryHigh);
                 } else {
                     result._newState = Node::State::Failed;
                 }
             }
         }
         result._log.forwardTo(*(context()->logBook()));
-        if (result._newState != Node::State::Ok) {
-            handleOutputAndNewInputFilesCompletion(result._newState, sresult);
-        }
     }
 
-    void CommandNode::handleOutputAndNewInputFilesCompletion(Node::State newState, std::shared_ptr<ExecutionResult> sresult) {
-        ExecutionResult& result = *sresult;
-        result._newState = newState;
-        if (newState == Node::State::Ok) {
+    void CommandNode::handleOutputAndNewInputFilesCompletion(ExecutionResult& result) {
+        if (result._newState == Node::State::Ok) {
             auto prevHash = _executionHash;
             _executionHash = computeExecutionHash(outputNameFilters());
+            executionDuration(result._duration);
             if (
                 _postProcessor == nullptr 
                 && prevHash != _executionHash 
@@ -1193,7 +1231,7 @@ namespace YAM
             _executionHash = rand();
         }
         modified(true);
-        notifyCompletion(sresult->_newState);
+        notifyCompletion(result._newState);
     }
 
     std::string CommandNode::compileScript(ILogBook& logBook) {
@@ -1243,6 +1281,12 @@ namespace YAM
         std::map<std::string, std::string> env;
         env["TMP"] = tmpDir.string();
         env["TEMP"] = tmpDir.string();
+        std::shared_ptr<JobServer> jobServer = context()->jobServer();
+        if (jobServer != nullptr) {
+            // Make nested make, ninja and cargo builds share yam's job budget.
+            env["MAKEFLAGS"] = jobServer->makeFlags();
+            env["CARGO_MAKEFLAGS"] = jobServer->makeFlags();
+        }
 
         std::filesystem::path wdir;
         auto locked = _workingDir.lock();
@@ -1285,7 +1329,7 @@ namespace YAM
 
     bool CommandNode::findInputNodes(
         std::map<std::filesystem::path, std::shared_ptr<GeneratedFileNode>> const& allowedGenInputFiles,
-        std::set<std::filesystem::path>const& inputSymPaths,
+        std::vector<std::filesystem::path> const& inputSymPaths,
         std::vector<std::shared_ptr<FileNode>>& inputNodes,
         std::vector<std::shared_ptr<Node>>& srcInputNodes,
         ILogBook& logBook
@@ -1322,7 +1366,7 @@ namespace YAM
                 auto srcInputFile = dynamic_pointer_cast<SourceFileNode>(fileNode);
                 if (srcInputFile == nullptr) {
                     // inputPath references a non-existing source file.
-                    srcInputFile = std::make_shared<SourceFileNode>(context(), symInputPath);
+                    srcInputFile = makeShared<SourceFileNode>(context(), symInputPath);
                     nodes.add(srcInputFile);
                 }
                 inputNodes.push_back(srcInputFile);
@@ -1356,6 +1400,11 @@ namespace YAM
         NodeMapStreamer::stream(streamer, _detectedOptionalOutputs);
         NodeMapStreamer::stream(streamer, _detectedInputs);
         streamer->stream(_executionHash);
+        uint64_t duration;
+        if (streamer->writing()) duration = _executionDuration.count();
+        streamer->stream(duration);
+        if (streamer->reading()) _executionDuration = std::chrono::nanoseconds(duration);
+        _resourceClaim.stream(streamer);
     }
 
     void CommandNode::prepareDeserialize() {
@@ -2,12 +2,16 @@
 
 #include "Node.h"
 #include "FileNode.h"
+#include "NodeMap.h"
 #include "IMonitoredProcess.h"
 #include "MemoryLogBook.h"
 #include "Glob.h"
+#include "ResourceClaim.h"
 #include "xxhash.h"
 
 #include <atomic>
+#include <chrono>
+#include <optional>
 #include <unordered_set>
 
 namespace YAM
@@ -46,8 +50,8 @@ namespace YAM
     class __declspec(dllexport) CommandNode : public Node
     {
     public:
-        typedef std::map<std::filesystem::path, std::shared_ptr<FileNode>> InputNodes;
-        typedef std::map<std::filesystem::path, std::shared_ptr<GeneratedFileNode>> OutputNodes;
+        typedef NodeMap<FileNode> InputNodes;
+        typedef NodeMap<GeneratedFileNode> OutputNodes;
 
         // Output filters define how CommandNode treats detected output files.
         // A CommandNode can have 0, 1 or more output filters.
@@ -106,6 +110,7 @@ namespace YAM
         ~CommandNode();
 
         std::string className() const override { return "CommandNode"; }
+        NodeKind kind() const override { return NodeKind::Command; }
 
         // Set the name of input file aspect set. The set is accessed via
         // context()->findFileAspectSet(newName).
@@ -184,6 +189,24 @@ namespace YAM
 
         XXH64_hash_t executionHash() const;
 
+        // Set/get the wall-clock duration of the last successful script 
+        // execution. Zero when the script has not yet executed successfully.
+        // The duration is updated on each successful script execution.
+        void executionDuration(std::chrono::nanoseconds duration);
+        std::chrono::nanoseconds executionDuration() const;
+
+        // Set/get the priority with which the script execution is pushed to
+        // context()->processQueue(). Defaults to PriorityClass::High.
+        // See CriticalPath.
+        void scriptPriority(uint32_t prio);
+        uint32_t scriptPriority() const;
+
+        // Set/get the resource pool tokens claimed by script execution.
+        // The script is only executed when the claimed tokens are available
+        // in context()->resourcePool(claim). Empty by default.
+        void resourceClaim(ResourceClaim const& claim);
+        ResourceClaim const& resourceClaim() const;
+
         static void setStreamableType(uint32_t type);
         // Inherited from IStreamable
         uint32_t typeId() const override;
@@ -202,10 +225,12 @@ namespace YAM
             MemoryLogBook _log;
             Node::State _newState;
             std::map<std::filesystem::path, OutputFilter::Type> _outputPaths;
-            std::set<std::filesystem::path> _keptInputPaths;
-            std::set<std::filesystem::path> _removedInputPaths;
-            std::set<std::filesystem::path> _addedInputPaths;
+            // Difference between previous and current detected inputs.
+            std::vector<std::shared_ptr<FileNode>> _keptInputNodes;
+            std::vector<std::shared_ptr<FileNode>> _removedInputNodes;
+            std::vector<std::filesystem::path> _addedInputPaths;
             std::vector<std::shared_ptr<FileNode>> _addedInputNodes;
+            std::chrono::nanoseconds _duration;
         };
         void updateOutputNameFilters();
         void updateMandatoryOutputs(std::vector<std::shared_ptr<GeneratedFileNode>> const& outputs);
@@ -221,10 +246,10 @@ namespace YAM
         std::set<std::filesystem::path> convertToSymbolicPaths(
             std::set<std::filesystem::path> const& absPaths,
             MemoryLogBook& logBook);
-        void handleRequisitesCompletion(Node::State state);
-        void executeScript();
-        void handleExecuteScriptCompletion(std::shared_ptr<ExecutionResult> result);
-        void handleOutputAndNewInputFilesCompletion(Node::State newState, std::shared_ptr<ExecutionResult> result);
+        NodeTask execute(PriorityClass prio);
+        void executeScript(ExecutionResult& result); // Executes in a threadpool thread
+        void handleExecuteScriptCompletion(ExecutionResult& result, std::vector<Node*>& outputsAndNewInputs);
+        void handleOutputAndNewInputFilesCompletion(ExecutionResult& result);
 
         void updateInputProducers();
 
@@ -241,7 +266,7 @@ namespace YAM
 
         bool findInputNodes(
             std::map<std::filesystem::path, std::shared_ptr<GeneratedFileNode>> const& allowedGenInputFiles,
-            std::set<std::filesystem::path>const& inputSymPaths,
+            std::vector<std::filesystem::path> const& inputSymPaths,
             std::vector<std::shared_ptr<FileNode>>& inputNodes,
             std::vector<std::shared_ptr<Node>>& srcInputNodes,
             ILogBook& logBook
@@ -288,5 +313,9 @@ namespace YAM
         // The hash of the hashes of all items that, when changed, invalidate
         // the output files.
         XXH64_hash_t _executionHash;
+
+        std::chrono::nanoseconds _executionDuration;
+        std::optional<uint32_t> _scriptPriority;
+        ResourceClaim _resourceClaim;
     };
 }
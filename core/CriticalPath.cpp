@@ -0,0 +1,142 @@
+#include "CriticalPath.h"
+#include "CommandNode.h"
+#include "GeneratedFileNode.h"
+#include "GroupNode.h"
+
+#include <unordered_set>
+
+namespace
+{
+    using namespace YAM;
+
+    void appendGroupProducers(
+        GroupNode const* group,
+        std::unordered_set<GroupNode const*>& visitedGroups,
+        std::unordered_set<CommandNode*>& producers);
+
+    void appendProducer(
+        Node* input,
+        std::unordered_set<GroupNode const*>& visitedGroups,
+        std::unordered_set<CommandNode*>& producers
+    ) {
+        auto genFile = dynamic_cast<GeneratedFileNode*>(input);
+        if (genFile != nullptr) {
+            producers.insert(genFile->producer().get());
+            return;
+        }
+        auto cmd = dynamic_cast<CommandNode*>(input);
+        if (cmd != nullptr) {
+            producers.insert(cmd);
+            return;
+        }
+        auto group = dynamic_cast<GroupNode*>(input);
+        if (group != nullptr) {
+            appendGroupProducers(group, visitedGroups, producers);
+        }
+    }
+
+    void appendGroupProducers(
+        GroupNode const* group,
+        std::unordered_set<GroupNode const*>& visitedGroups,
+        std::unordered_set<CommandNode*>& producers
+    ) {
+        if (!visitedGroups.insert(group).second) return;
+        for (auto const& node : group->content()) {
+            appendProducer(node.get(), visitedGroups, producers);
+        }
+    }
+
+    // Return the commands that produce the cmdInputs and orderOnlyInputs
+    // of given command.
+    std::unordered_set<CommandNode*> getProducers(CommandNode* cmd) {
+        std::unordered_set<GroupNode const*> visitedGroups;
+        std::unordered_set<CommandNode*> producers;
+        for (auto const& input : cmd->cmdInputs()) {
+            appendProducer(input.get(), visitedGroups, producers);
+        }
+        for (auto const& input : cmd->orderOnlyInputs()) {
+            appendProducer(input.get(), visitedGroups, producers);
+        }
+        producers.erase(cmd);
+        return producers;
+    }
+}
+
+namespace YAM
+{
+    CriticalPath::CriticalPath(std::vector<std::shared_ptr<Node>> const& nodes)
+        : _maxLength(0)
+    {
+        std::chrono::nanoseconds knownDuration(0);
+        std::size_t nKnown = 0;
+        for (auto const& node : nodes) {
+            auto cmd = dynamic_cast<CommandNode*>(node.get());
+            if (cmd != nullptr && _lengths.insert({ cmd, std::chrono::nanoseconds(0) }).second) {
+                _commands.push_back(cmd);
+                if (cmd->executionDuration().count() > 0) {
+                    knownDuration += cmd->executionDuration();
+                    nKnown++;
+                }
+            }
+        }
+        std::chrono::nanoseconds defaultDuration(1);
+        if (nKnown > 0) defaultDuration = std::max(defaultDuration, knownDuration / static_cast<int64_t>(nKnown));
+
+        // consumers[p] are the commands that depend on outputs of p.
+        // nConsumers[c] is the number of consumers of c whose length is 
+        // not yet known.
+        std::unordered_map<CommandNode*, std::vector<CommandNode*>> producers;
+        std::unordered_map<CommandNode*, std::size_t> nConsumers;
+        for (auto cmd : _commands) {
+            for (auto producer : getProducers(cmd)) {
+                if (_lengths.contains(producer)) {
+                    producers[cmd].push_back(producer);
+                    nConsumers[producer] += 1;
+                }
+            }
+        }
+
+        // Visit commands in reverse topological order, i.e. consumers before
+        // producers. Commands in a dependency cycle are never ready and keep
+        // length zero.
+        std::vector<CommandNode*> ready;
+        for (auto cmd : _commands) {
+            if (!nConsumers.contains(cmd)) ready.push_back(cmd);
+        }
+        std::unordered_map<CommandNode*, std::chrono::nanoseconds> maxConsumerLength;
+        while (!ready.empty()) {
+            CommandNode* cmd = ready.back();
+            ready.pop_back();
+            std::chrono::nanoseconds duration = cmd->executionDuration();
+            if (duration.count() == 0) duration = defaultDuration;
+            std::chrono::nanoseconds length = duration + maxConsumerLength[cmd];
+            _lengths[cmd] = length;
+            if (length > _maxLength) _maxLength = length;
+            for (auto producer : producers[cmd]) {
+                auto& maxLength = maxConsumerLength[producer];
+                if (length > maxLength) maxLength = length;
+                if (--nConsumers[producer] == 0) ready.push_back(producer);
+            }
+        }
+    }
+
+    std::chrono::nanoseconds CriticalPath::length(CommandNode const* command) const {
+        auto it = _lengths.find(command);
+        if (it == _lengths.end()) return std::chrono::nanoseconds(0);
+        return it->second;
+    }
+
+    void CriticalPath::assignPriorities(uint32_t lowPrio, uint32_t highPrio) const {
+        if (highPrio < lowPrio) throw std::exception("highPrio < lowPrio");
+        double range = highPrio - lowPrio;
+        double maxLength = static_cast<double>(_maxLength.count());
+        for (auto cmd : _commands) {
+            uint32_t prio = lowPrio;
+            if (maxLength > 0) {
+                double fraction = static_cast<double>(length(cmd).count()) / maxLength;
+                prio += static_cast<uint32_t>(fraction * range + 0.5);
+            }
+            cmd->scriptPriority(prio);
+        }
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <unordered_map>
+
+namespace YAM
+{
+    class Node;
+    class CommandNode;
+
+    // Estimates the remaining critical path length of commands.
+    // 
+    // The remaining critical path length of a command C is the duration of
+    // the longest chain of command executions that starts with C, i.e. the
+    // executionDuration() of C plus the maximum remaining critical path
+    // length of the commands that depend on output files of C.
+    // Commands that do not have a (successful) historical execution duration
+    // are assumed to take the average duration of the commands that do.
+    // 
+    // When many commands are ready to execute, executing the commands with
+    // the longest remaining critical path first minimizes total build time.
+    // E.g. a link step that depends on a long compilation must not wait for
+    // many cheap compilations that happened to be queued first.
+    // 
+    class __declspec(dllexport) CriticalPath
+    {
+    public:
+        // Estimate the remaining critical path lengths of the CommandNodes
+        // in 'nodes'. Only dependencies between the commands in 'nodes' are
+        // taken into account. Nodes that are not CommandNodes are ignored.
+        CriticalPath(std::vector<std::shared_ptr<Node>> const& nodes);
+
+        // Return the estimated remaining critical path length of command.
+        // Return zero when command was not in 'nodes'.
+        std::chrono::nanoseconds length(CommandNode const* command) const;
+
+        // Return the maximum of the estimated lengths.
+        std::chrono::nanoseconds maxLength() const { return _maxLength; }
+
+        // Set the scriptPriority() of each command to a priority in range
+        // [lowPrio, highPrio] that is proportional to its estimated length.
+        // The commands with length maxLength() get highPrio.
+        void assignPriorities(uint32_t lowPrio, uint32_t highPrio) const;
+
+    private:
+        std::vector<CommandNode*> _commands;
+        std::unordered_map<CommandNode const*, std::chrono::nanoseconds> _lengths;
+        std::chrono::nanoseconds _maxLength;
+    };
+}
@@ -10,7 +10,7 @@ Override default asset
 Override default static_assert
 #define DELEGATE_STATIC_ASSERT(expression, msg)
 
-Set inline allocator size (default: 32)
+Set inline allocator size (default: 40)
 #define DELEGATE_INLINE_ALLOCATION_SIZE
 
 Reassign allocation functions:
@@ -29,7 +29,7 @@ Delegates::SetAllocationCallbacks(allocFunction, freeFunc);
     - Member functions
     - Lambda's
     - std::shared_ptr
-- Delegate object is allocated inline if it is under 32 bytes
+- Delegate object is allocated inline if it is not larger than 40 bytes
 - Add payload to delegate during bind-time
 - Move operations enable optimization
 
@@ -106,8 +106,13 @@ Raw delegate payload: 10
 
 //The allocation size of delegate data.
 //Delegates larger than this will be heap allocated.
+//YAM: 40 bytes fits the lambda delegates that nodes push to the
+//dispatchers: [this] (24 bytes incl. vtable pointer), [this, state] (32)
+//and [this, shared_ptr] (40). FileNode keeps its hash results in members
+//to capture only [this]. Each Node embeds a Delegate and a MulticastDelegate
+//(also a DelegateBase): every 8 bytes of inline size add 16 bytes to a Node.
 #ifndef DELEGATE_INLINE_ALLOCATION_SIZE
-#define DELEGATE_INLINE_ALLOCATION_SIZE 32
+#define DELEGATE_INLINE_ALLOCATION_SIZE 40
 #endif
 
 #define DECLARE_DELEGATE(name, ...) \
@@ -646,6 +651,12 @@ public:
         return m_Allocator.GetSize();
     }
 
+    //Return whether the bound delegate did not fit in the inline buffer
+    bool IsHeapAllocated() const
+    {
+        return m_Allocator.HasHeapAllocation();
+    }
+
     //Clear the bound delegate if it is bound to the given object.
     //Ignored when pObject is a nullptr
     void ClearIfBoundTo(void* pObject)
@@ -1081,6 +1092,14 @@ public:
         return m_Events.size();
     }
 
+    //Return whether handler storage was allocated on the heap.
+    //A delegate without handlers does not allocate, e.g. the completor of
+    //a node that is not observed.
+    bool IsHeapAllocated() const
+    {
+        return m_Events.capacity() != 0;
+    }
+
 private:
     void Lock()
     {
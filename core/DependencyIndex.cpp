@@ -0,0 +1,312 @@
+#include "DependencyIndex.h"
+#include "ExecutionContext.h"
+#include "GraphSnapshot.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+namespace
+{
+    using namespace YAM;
+
+    typedef DependencyIndex::Id Id;
+
+    const char magic[8] = { 'y', 'a', 'm', 'd', 'e', 'p', 's', '\0' };
+    const uint32_t version = 1;
+
+    // File layout:
+    //     Header
+    //     uint64_t nameOffsets[nNodes + 1]    offsets in names
+    //     uint64_t depOffsets[nNodes + 1]     offsets in deps
+    //     uint64_t rdepOffsets[nNodes + 1]    offsets in rdeps
+    //     Id deps[nEdges]
+    //     Id rdeps[nEdges]
+    //     char names[namesSize]
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t nNodes;
+        uint64_t nEdges;
+        uint64_t namesSize;
+    };
+
+    // Return the offsets of the rows of edges, sorted by first.
+    std::vector<uint64_t> rowOffsets(std::vector<std::pair<Id, Id>> const& edges, std::size_t nNodes) {
+        std::vector<uint64_t> offsets(nNodes + 1, 0);
+        for (auto const& edge : edges) offsets[edge.first + 1] += 1;
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+        return offsets;
+    }
+
+    // Windows fails to replace a file that is mapped by another process,
+    // e.g. by 'yam query'. Such a mapping only exists for the duration of
+    // the query, hence retry for some time.
+    void renameWithRetry(std::filesystem::path const& from, std::filesystem::path const& to) {
+        const int maxAttempts = 50;
+        for (int attempt = 1; ; ++attempt) {
+            std::error_code ec;
+            std::filesystem::rename(from, to, ec);
+            if (!ec) return;
+            if (attempt == maxAttempts) {
+                std::string error = ec.message();
+                std::filesystem::remove(from, ec);
+                throw std::runtime_error("cannot replace " + to.string() + ": " + error);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+    }
+
+    template <class T>
+    void writeArray(std::ofstream& out, std::vector<T> const& values) {
+        out.write(reinterpret_cast<char const*>(values.data()), values.size() * sizeof(T));
+    }
+}
+
+namespace YAM
+{
+    struct DependencyIndex::Mapping {
+        boost::interprocess::file_mapping file;
+        boost::interprocess::mapped_region region;
+    };
+
+    std::filesystem::path DependencyIndex::filePath(std::filesystem::path const& yamDir) {
+        return yamDir / "dependencyIndex";
+    }
+
+    std::shared_ptr<DependencyIndex::Graph> DependencyIndex::graph(GraphSnapshot const& snapshot) {
+        auto graph = std::make_shared<Graph>();
+        std::vector<std::string>& names = graph->names;
+        std::vector<std::pair<Id, Id>>& edges = graph->edges;
+        std::unordered_map<PathInterner::Id, Id> ids;
+        ids.reserve(snapshot.size());
+        names.reserve(snapshot.size());
+        snapshot.foreach(Delegate<void, std::shared_ptr<const NodeSnapshot> const&>::CreateLambda(
+            [&](std::shared_ptr<const NodeSnapshot> const& node) {
+                ids.insert({ node->nameId, static_cast<Id>(names.size()) });
+                names.push_back(node->name().string());
+            }));
+        snapshot.foreach(Delegate<void, std::shared_ptr<const NodeSnapshot> const&>::CreateLambda(
+            [&](std::shared_ptr<const NodeSnapshot> const& node) {
+                Id id = ids[node->nameId];
+                for (PathInterner::Id input : node->inputs) {
+                    auto it = ids.find(input);
+                    if (it != ids.end()) edges.push_back({ id, it->second });
+                }
+                for (PathInterner::Id output : node->outputs) {
+                    auto it = ids.find(output);
+                    if (it != ids.end()) edges.push_back({ it->second, id });
+                }
+            }));
+        return graph;
+    }
+
+    void DependencyIndex::write(std::filesystem::path const& path, ExecutionContext* context) {
+        std::shared_ptr<Graph> g = graph(GraphSnapshot(context, nullptr, 0));
+        write(path, g->names, g->edges);
+    }
+
+    void DependencyIndex::write(
+        std::filesystem::path const& path,
+        std::vector<std::string> const& names,
+        std::vector<std::pair<Id, Id>> const& edges
+    ) {
+        if (names.size() >= invalidId) throw std::runtime_error("too many nodes for dependency index");
+
+        // Renumber nodes in name order.
+        std::vector<Id> order(names.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&names](Id lhs, Id rhs) { return names[lhs] < names[rhs]; });
+        std::vector<Id> newId(names.size());
+        for (Id i = 0; i < order.size(); ++i) newId[order[i]] = i;
+
+        std::vector<std::pair<Id, Id>> depEdges;
+        depEdges.reserve(edges.size());
+        for (auto const& edge : edges) {
+            if (edge.first >= names.size() || edge.second >= names.size()) throw std::runtime_error("invalid edge");
+            depEdges.push_back({ newId[edge.first], newId[edge.second] });
+        }
+        std::sort(depEdges.begin(), depEdges.end());
+        depEdges.erase(std::unique(depEdges.begin(), depEdges.end()), depEdges.end());
+        std::vector<std::pair<Id, Id>> rdepEdges;
+        rdepEdges.reserve(depEdges.size());
+        for (auto const& edge : depEdges) rdepEdges.push_back({ edge.second, edge.first });
+        std::sort(rdepEdges.begin(), rdepEdges.end());
+
+        std::vector<uint64_t> nameOffsets;
+        nameOffsets.reserve(names.size() + 1);
+        uint64_t namesSize = 0;
+        for (Id old : order) {
+            nameOffsets.push_back(namesSize);
+            namesSize += names[old].size();
+        }
+        nameOffsets.push_back(namesSize);
+        std::vector<Id> deps, rdeps;
+        deps.reserve(depEdges.size());
+        rdeps.reserve(rdepEdges.size());
+        for (auto const& edge : depEdges) deps.push_back(edge.second);
+        for (auto const& edge : rdepEdges) rdeps.push_back(edge.second);
+
+        Header header;
+        std::memcpy(header.magic, magic, sizeof(magic));
+        header.version = version;
+        header.nNodes = static_cast<uint32_t>(names.size());
+        header.nEdges = deps.size();
+        header.namesSize = namesSize;
+
+        // Write to temporary file and rename to avoid that readers see a
+        // partially written index.
+        std::filesystem::path tmpPath(path);
+        tmpPath += ".tmp";
+        {
+            std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+            if (!out) throw std::runtime_error("cannot open " + tmpPath.string());
+            out.write(reinterpret_cast<char const*>(&header), sizeof(header));
+            writeArray(out, nameOffsets);
+            writeArray(out, rowOffsets(depEdges, names.size()));
+            writeArray(out, rowOffsets(rdepEdges, names.size()));
+            writeArray(out, deps);
+            writeArray(out, rdeps);
+            for (Id old : order) out.write(names[old].data(), names[old].size());
+            if (!out) throw std::runtime_error("cannot write " + tmpPath.string());
+        }
+        renameWithRetry(tmpPath, path);
+    }
+
+    DependencyIndex::DependencyIndex(std::filesystem::path const& path) {
+        try {
+            _mapping = std::make_unique<Mapping>();
+            _mapping->file = boost::interprocess::file_mapping(path.string().c_str(), boost::interprocess::read_only);
+            _mapping->region = boost::interprocess::mapped_region(_mapping->file, boost::interprocess::read_only);
+        } catch (boost::interprocess::interprocess_exception const& e) {
+            throw std::runtime_error("cannot map " + path.string() + ": " + e.what());
+        }
+        char const* data = static_cast<char const*>(_mapping->region.get_address());
+        std::size_t size = _mapping->region.get_size();
+        if (size < sizeof(Header)) throw std::runtime_error("not a dependency index: " + path.string());
+        Header const* header = reinterpret_cast<Header const*>(data);
+        if (std::memcmp(header->magic, magic, sizeof(magic)) != 0 || header->version != version) {
+            throw std::runtime_error("not a dependency index: " + path.string());
+        }
+        _nNodes = header->nNodes;
+        _nEdges = header->nEdges;
+        uint64_t offsetsSize = 3 * (static_cast<uint64_t>(_nNodes) + 1) * sizeof(uint64_t);
+        uint64_t edgesSize = 2 * _nEdges * sizeof(Id);
+        if (size != sizeof(Header) + offsetsSize + edgesSize + header->namesSize) {
+            throw std::runtime_error("corrupt dependency index: " + path.string());
+        }
+        char const* p = data + sizeof(Header);
+        _nameOffsets = reinterpret_cast<uint64_t const*>(p);
+        _depOffsets = _nameOffsets + _nNodes + 1;
+        _rdepOffsets = _depOffsets + _nNodes + 1;
+        _deps = reinterpret_cast<Id const*>(_rdepOffsets + _nNodes + 1);
+        _rdeps = _deps + _nEdges;
+        _names = reinterpret_cast<char const*>(_rdeps + _nEdges);
+    }
+
+    DependencyIndex::~DependencyIndex() {}
+
+    std::size_t DependencyIndex::nNodes() const { return _nNodes; }
+    std::size_t DependencyIndex::nEdges() const { return _nEdges; }
+
+    DependencyIndex::Id DependencyIndex::find(std::string_view name) const {
+        Id lo = 0;
+        Id hi = _nNodes;
+        while (lo < hi) {
+            Id mid = lo + (hi - lo) / 2;
+            if (this->name(mid) < name) lo = mid + 1;
+            else hi = mid;
+        }
+        return (lo < _nNodes && this->name(lo) == name) ? lo : invalidId;
+    }
+
+    std::string_view DependencyIndex::name(Id id) const {
+        return std::string_view(_names + _nameOffsets[id], _nameOffsets[id + 1] - _nameOffsets[id]);
+    }
+
+    std::span<const DependencyIndex::Id> DependencyIndex::deps(Id id) const {
+        return std::span<const Id>(_deps + _depOffsets[id], _deps + _depOffsets[id + 1]);
+    }
+
+    std::span<const DependencyIndex::Id> DependencyIndex::rdeps(Id id) const {
+        return std::span<const Id>(_rdeps + _rdepOffsets[id], _rdeps + _rdepOffsets[id + 1]);
+    }
+
+    std::vector<DependencyIndex::Id> DependencyIndex::reachable(Id id, bool reverse, std::vector<bool>& visited) const {
+        std::vector<Id> result;
+        std::vector<Id> stack({ id });
+        visited[id] = true;
+        while (!stack.empty()) {
+            Id current = stack.back();
+            stack.pop_back();
+            for (Id next : reverse ? rdeps(current) : deps(current)) {
+                if (!visited[next]) {
+                    visited[next] = true;
+                    result.push_back(next);
+                    stack.push_back(next);
+                }
+            }
+        }
+        return result;
+    }
+
+    std::vector<DependencyIndex::Id> DependencyIndex::transitiveDeps(Id id) const {
+        std::vector<bool> visited(_nNodes, false);
+        std::vector<Id> result = reachable(id, false, visited);
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    std::vector<DependencyIndex::Id> DependencyIndex::transitiveRdeps(Id id) const {
+        std::vector<bool> visited(_nNodes, false);
+        std::vector<Id> result = reachable(id, true, visited);
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    std::vector<DependencyIndex::Id> DependencyIndex::somePath(Id from, Id to) const {
+        std::vector<Id> parent(_nNodes, invalidId);
+        std::deque<Id> queue({ from });
+        parent[from] = from;
+        while (!queue.empty() && parent[to] == invalidId) {
+            Id current = queue.front();
+            queue.pop_front();
+            for (Id next : deps(current)) {
+                if (parent[next] == invalidId) {
+                    parent[next] = current;
+                    queue.push_back(next);
+                }
+            }
+        }
+        std::vector<Id> path;
+        if (parent[to] == invalidId) return path;
+        for (Id id = to; id != from; id = parent[id]) path.push_back(id);
+        path.push_back(from);
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+
+    std::vector<DependencyIndex::Id> DependencyIndex::allPaths(Id from, Id to) const {
+        // A node is on a path from 'from' to 'to' when it is reachable from
+        // 'from' and 'to' is reachable from it.
+        std::vector<bool> fromReaches(_nNodes, false);
+        std::vector<bool> reachesTo(_nNodes, false);
+        reachable(from, false, fromReaches);
+        std::vector<Id> result;
+        if (!fromReaches[to]) return result;
+        reachable(to, true, reachesTo);
+        for (Id id = 0; id < _nNodes; ++id) {
+            if (fromReaches[id] && reachesTo[id]) result.push_back(id);
+        }
+        return result;
+    }
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace YAM
+{
+    class ExecutionContext;
+    class GraphSnapshot;
+
+    // A DependencyIndex is a compact, persistent snapshot of the dependency
+    // edges in the build graph. It is written by the Builder after each
+    // build and is used by 'yam query' to answer questions like "what
+    // rebuilds when I touch X" and "why does Y depend on Z" without
+    // loading the build state and without starting yamServer.
+    //
+    // Node X depends on node Y when Y is in X->getInputs(..) or when X is
+    // in Y->getOutputs(..), e.g. a command depends on its input files and
+    // a generated file depends on the command that produces it.
+    //
+    // The index file is memory-mapped. It contains the node names, sorted
+    // by name, and the dependency and reverse dependency edges in
+    // compressed sparse row format. Node ids are positions in the sorted
+    // name table, hence sorting ids sorts nodes by name.
+    // The file is in native byte order.
+    //
+    class __declspec(dllexport) DependencyIndex
+    {
+    public:
+        typedef uint32_t Id;
+        static constexpr Id invalidId = UINT32_MAX;
+
+        // Return the path of the index file in given .yam directory.
+        static std::filesystem::path filePath(std::filesystem::path const& yamDir);
+
+        // The node names and dependency edges from which an index is
+        // written, see write(path, names, edges).
+        struct Graph {
+            std::vector<std::string> names;
+            std::vector<std::pair<Id, Id>> edges;
+        };
+
+        // Return the graph of the nodes in given snapshot.
+        // Can be called in any thread.
+        static std::shared_ptr<Graph> graph(GraphSnapshot const& snapshot);
+
+        // Write the index of the nodes in context->nodes() and of the
+        // repositories in context to given path.
+        // Pre: called in context->mainThread()
+        static void write(std::filesystem::path const& path, ExecutionContext* context);
+
+        // Write the index of the graph with given node names and edges to
+        // given path. An edge (x, y) specifies that names[x] depends on
+        // names[y]. Duplicate edges are ignored.
+        // The index is written to a temporary file that is renamed to
+        // path. The rename is retried for some time when it fails, e.g.
+        // on Windows when 'yam query' has mapped the existing index.
+        // Throw std::runtime_error on write failure.
+        static void write(
+            std::filesystem::path const& path,
+            std::vector<std::string> const& names,
+            std::vector<std::pair<Id, Id>> const& edges);
+
+        // Memory-map the index file at given path.
+        // Throw std::runtime_error when the file cannot be mapped or is not
+        // a valid index file.
+        DependencyIndex(std::filesystem::path const& path);
+        ~DependencyIndex();
+
+        std::size_t nNodes() const;
+        std::size_t nEdges() const;
+
+        // Return the id of the node with given name, invalidId if not found.
+        Id find(std::string_view name) const;
+        std::string_view name(Id id) const;
+
+        // Return the direct dependencies of node id.
+        std::span<const Id> deps(Id id) const;
+        // Return the nodes that directly depend on node id.
+        std::span<const Id> rdeps(Id id) const;
+
+        // Return the nodes on which node id depends directly or indirectly.
+        std::vector<Id> transitiveDeps(Id id) const;
+        // Return the nodes that depend directly or indirectly on node id.
+        std::vector<Id> transitiveRdeps(Id id) const;
+
+        // Return a shortest dependency path from node 'from' to node 'to',
+        // i.e. { from, dependency of from, ..., to }.
+        // Return empty vector when 'from' does not depend on 'to'.
+        std::vector<Id> somePath(Id from, Id to) const;
+
+        // Return the nodes on all dependency paths from node 'from' to node
+        // 'to', including 'from' and 'to'.
+        // Return empty vector when 'from' does not depend on 'to'.
+        std::vector<Id> allPaths(Id from, Id to) const;
+
+    private:
+        struct Mapping;
+
+        // Return the ids reachable from id via edges, excluding id.
+        // Mark the reachable ids and id in 'visited'.
+        std::vector<Id> reachable(Id id, bool reverse, std::vector<bool>& visited) const;
+
+        std::unique_ptr<Mapping> _mapping;
+        uint32_t _nNodes;
+        uint64_t _nEdges;
+        uint64_t const* _nameOffsets;
+        uint64_t const* _depOffsets;
+        uint64_t const* _rdepOffsets;
+        Id const* _deps;
+        Id const* _rdeps;
+        char const* _names;
+    };
+}
@@ -0,0 +1,87 @@
+#include "DependencyQuery.h"
+#include "DependencyIndex.h"
+#include "DotYamDirectory.h"
+#include "FileRepositoryNode.h"
+#include "RepositoryNameFile.h"
+
+#include <exception>
+
+namespace
+{
+    using namespace YAM;
+
+    // Return the symbolic path of the node at given path.
+    std::filesystem::path symbolicPathOf(
+        std::string const& nodePath,
+        std::filesystem::path const& currentDir,
+        std::filesystem::path const& repoDir,
+        std::string const& repoName
+    ) {
+        std::filesystem::path path(nodePath);
+        if (FileRepositoryNode::isSymbolicPath(path)) return path.lexically_normal();
+        std::filesystem::path absPath = (currentDir / path).lexically_normal();
+        return FileRepositoryNode::repoNameToSymbolicPath(repoName) / absPath.lexically_relative(repoDir);
+    }
+}
+
+namespace YAM
+{
+    void DependencyQuery::usage(std::ostream& out) {
+        out
+            << "USAGE: yam query deps <node>           Print the nodes on which node depends." << std::endl
+            << "       yam query rdeps <node>          Print the nodes that depend on node." << std::endl
+            << "       yam query somepath <from> <to>  Print a dependency path from node 'from' to node 'to'." << std::endl
+            << "       yam query allpaths <from> <to>  Print the nodes on all dependency paths from 'from' to 'to'." << std::endl
+            << std::endl
+            << "A node is a path relative to the current directory or a symbolic path, e.g. @@repo/src/main.cpp." << std::endl
+            << "Queries use the dependency index that was stored by the last build." << std::endl;
+    }
+
+    int DependencyQuery::run(
+        std::vector<std::string> const& args,
+        std::filesystem::path const& currentDir,
+        std::ostream& out
+    ) {
+        std::string command = args.empty() ? "" : args[0];
+        bool binary = command == "somepath" || command == "allpaths";
+        bool unary = command == "deps" || command == "rdeps";
+        if (!(unary && args.size() == 2) && !(binary && args.size() == 3)) {
+            usage(out);
+            return 1;
+        }
+        std::filesystem::path yamDir = DotYamDirectory::find(currentDir);
+        if (yamDir.empty()) {
+            out << "Not in a yam repository: " << currentDir.string() << std::endl;
+            return 1;
+        }
+        std::filesystem::path repoDir = yamDir.parent_path();
+        std::string repoName = RepositoryNameFile(repoDir).repoName();
+        try {
+            DependencyIndex index(DependencyIndex::filePath(yamDir));
+            std::vector<DependencyIndex::Id> ids;
+            for (std::size_t i = 1; i < args.size(); ++i) {
+                std::filesystem::path name = symbolicPathOf(args[i], currentDir, repoDir, repoName);
+                DependencyIndex::Id id = index.find(name.string());
+                if (id == DependencyIndex::invalidId) {
+                    out << "Unknown node: " << name.string() << std::endl;
+                    return 1;
+                }
+                ids.push_back(id);
+            }
+            std::vector<DependencyIndex::Id> result;
+            if (command == "deps") result = index.transitiveDeps(ids[0]);
+            else if (command == "rdeps") result = index.transitiveRdeps(ids[0]);
+            else if (command == "somepath") result = index.somePath(ids[0], ids[1]);
+            else result = index.allPaths(ids[0], ids[1]);
+            if (binary && result.empty()) {
+                out << "No dependency path from " << index.name(ids[0]) << " to " << index.name(ids[1]) << std::endl;
+            }
+            for (auto id : result) out << index.name(id) << std::endl;
+        } catch (std::exception const& e) {
+            out << e.what() << std::endl;
+            out << "Run a build to create the dependency index." << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <filesystem>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace YAM
+{
+    // DependencyQuery implements 'yam query': it answers dependency
+    // queries from the DependencyIndex that was stored by the last build,
+    // i.e. without connecting to yamServer.
+    //
+    class __declspec(dllexport) DependencyQuery
+    {
+    public:
+        // Write the usage of 'yam query' to out.
+        static void usage(std::ostream& out);
+
+        // Answer the query in args, e.g. { "deps", "src/main.cpp" }, from
+        // the dependency index of the yam repository that contains
+        // currentDir. Node paths in args are symbolic or relative to
+        // currentDir. Write the answer, or the failure, to out.
+        // Return 0 on success, else 1.
+        static int run(
+            std::vector<std::string> const& args,
+            std::filesystem::path const& currentDir,
+            std::ostream& out);
+    };
+}
@@ -26,19 +26,16 @@ namespace
     ) {
         std::shared_ptr<Node> node = nullptr;
         if (dirEntry.is_directory()) {
-            node = std::make_shared<DirectoryNode>(context, name, parent);
+            node = makeShared<DirectoryNode>(context, name, parent);
         } else if (dirEntry.is_regular_file()) {
-            node = std::make_shared<SourceFileNode>(context, name);
+            node = makeShared<SourceFileNode>(context, name);
         } else {
             // bool notHandled = true;
         }
         return node;
     }
 
-    std::shared_ptr<SourceFileNode> findBuildFile(
-        std::map<std::filesystem::path,
-        std::shared_ptr<Node>> content
-    ) {
+    std::shared_ptr<SourceFileNode> findBuildFile(NodeMap<Node> const& content) {
         static std::regex fileNameRe(R"(^buildfile_yam\..*$)");
         for (auto const& pair : content) {
             auto fileName = pair.first.filename();
@@ -133,11 +130,11 @@ namespace YAM
                 auto msg = ec.message();
                 //throw std::runtime_error(absGenDirPath.string() + " is not a directory");
             }
-            genDir = std::make_shared<DirectoryNode>(context(), symGenDirPath, this);
+            genDir = makeShared<DirectoryNode>(context(), symGenDirPath, this);
             context()->nodes().add(genDir);
             genDir->addObserver(this);
             genDir->addPrerequisitesToContext();
-            _content.insert({ symGenDirPath, genDir });
+            _content.insert(genDir);
             modified(true);
         } else {
             genDir = dynamic_pointer_cast<DirectoryNode>(it->second);
@@ -150,7 +147,7 @@ namespace YAM
             throw std::exception("attempt to add generate file to wrong directory");
         }
         if (!_generatedContent.contains(genFile->name())) {
-            _generatedContent.insert({ genFile->name(), genFile });
+            _generatedContent.insert(genFile);
             modified(true);
         }
     }
@@ -252,9 +249,7 @@ namespace YAM
 
     std::shared_ptr<Node> DirectoryNode::getNode(
         std::filesystem::directory_entry const& dirEntry,
-        std::shared_ptr<FileRepositoryNode> const& repo,
-        std::unordered_set<std::shared_ptr<Node>>& added,
-        std::unordered_set<std::shared_ptr<Node>>& kept
+        std::shared_ptr<FileRepositoryNode> const& repo
     ) {
         std::shared_ptr<Node> child = nullptr;
         auto const& absPath = dirEntry.path();
@@ -263,7 +258,6 @@ namespace YAM
             auto it = _content.find(symPath);
             if (it != _content.end()) {
                 child = it->second;
-                kept.insert(it->second);
             } else {
                 // A node for this entry may be present in buildstate (contect->nodes()).
                 // getNode() executes in threadpool context, hence buildstate access
@@ -271,32 +265,30 @@ namespace YAM
                 // and check in main thread (commitResult) whether it already existed in
                 // buildstate.
                 child = createNode(this, dirEntry, symPath, context());
-                added.insert(child);
             }
         }
         return child;
     }
 
     void DirectoryNode::retrieveContent(
-        std::map<std::filesystem::path, std::shared_ptr<Node>>& content,
-        std::unordered_set<std::shared_ptr<Node>>& added,
-        std::unordered_set<std::shared_ptr<Node>>& removed,
-        std::unordered_set<std::shared_ptr<Node>>& kept
+        NodeMap<Node>& content,
+        std::vector<std::shared_ptr<Node>>& added,
+        std::vector<std::shared_ptr<Node>>& kept,
+        std::vector<std::shared_ptr<Node>>& removed
     ) {
         auto repo = repository();
         std::filesystem::path absDir = repo->absolutePathOf(name());
+        std::vector<std::shared_ptr<Node>> children;
         if (std::filesystem::exists(absDir)) {
+            children.reserve(_content.size());
             std::shared_ptr<Node> child = nullptr;
             for (auto const& dirEntry : std::filesystem::directory_iterator{ absDir }) {
-                child = getNode(dirEntry, repo, added, kept);
-                if (child != nullptr) content.insert({ child->name(), child });
-            }
-        }
-        for (auto const& pair : _content) {
-            if (!kept.contains(pair.second)) {
-                removed.insert(pair.second);
+                child = getNode(dirEntry, repo);
+                if (child != nullptr) children.push_back(child);
             }
         }
+        content = NodeMap<Node>(children);
+        computeNodeMapDifference(content, _content, kept, added, removed);
     } 
 
     void DirectoryNode::_removeChildRecursively(std::shared_ptr<Node> const& child) {
@@ -341,7 +333,7 @@ namespace YAM
 
     XXH64_hash_t DirectoryNode::computeExecutionHash(
         XXH64_hash_t dotIgnoreNodeHash,
-        std::map<std::filesystem::path, std::shared_ptr<Node>> const& content
+        NodeMap<Node> const& content
     ) const {
         std::vector<XXH64_hash_t> hashes;
         hashes.push_back(dotIgnoreNodeHash);
@@ -362,41 +354,67 @@ namespace YAM
 
     void DirectoryNode::start(PriorityClass prio) {
         Node::start(prio);
-        std::vector<Node*> requisites;
-        requisites.push_back(_dotIgnoreNode.get());
-        auto callback = Delegate<void, Node::State>::CreateLambda(
-            [this](Node::State s) { handleRequisitesCompletion(s); }
-        );
-        startNodes(requisites, std::move(callback), prio);
+        execute(prio).start();
     }
 
-    void DirectoryNode::handleRequisitesCompletion(Node::State state) {
+    NodeTask DirectoryNode::execute(PriorityClass prio) {
+        std::vector<Node*> requisites;
+        requisites.push_back(_dotIgnoreNode.get());
+        Node::State state = co_await awaitNodes(requisites, prio);
         if (state != Node::State::Ok) {
             Node::notifyCompletion(state);
-        } else if (canceling()) {
+            co_return;
+        }
+        if (canceling()) {
             Node::notifyCompletion(Node::State::Canceled);
+            co_return;
+        }
+        context()->statistics().registerSelfExecuted(this);
+
+        RetrieveResult result;
+        co_await ResumeOn(context()->ioQueue(), PriorityClass::High);
+        retrieveContentIfNeeded(result);
+        co_await resumeOnMainThread();
+
+        if (result._newState != Node::State::Ok) {
+            notifyCompletion(result._newState);
+            co_return;
+        }
+        if (canceling()) {
+            notifyCompletion(Node::State::Canceled);
+            co_return;
+        }
+        if (
+            result._lastWriteTime == _lastWriteTime
+            && result._executionHash == _executionHash
+        ) {
+            updateBuildFileParserNode();
         } else {
-            context()->statistics().registerSelfExecuted(this);
-            auto d = Delegate<void>::CreateLambda(
-                [this]() { retrieveContentIfNeeded(); }
-            );
-            context()->threadPoolQueue().push(std::move(d), PriorityClass::High);
+            commitResult(result);
+        }
+
+        std::vector<Node*> dirtySubDirs;
+        getDirtySubDirs(dirtySubDirs);
+        if (dirtySubDirs.empty()) {
+            Node::notifyCompletion(Node::State::Ok);
+        } else {
+            state = co_await awaitNodes(dirtySubDirs, PriorityClass::VeryHigh);
+            Node::notifyCompletion(state);
         }
     }
 
     // Executes in a threadpool thread
-    void DirectoryNode::retrieveContentIfNeeded() {
-        auto result = std::make_shared<RetrieveResult>();
+    void DirectoryNode::retrieveContentIfNeeded(RetrieveResult& result) {
         bool success = true;
         try {
-            result->_lastWriteTime = retrieveLastWriteTime();
-            result->_executionHash = computeExecutionHash(_dotIgnoreNode->hash(), result->_content);
+            result._lastWriteTime = retrieveLastWriteTime();
+            result._executionHash = computeExecutionHash(_dotIgnoreNode->hash(), result._content);
             if (
-                result->_lastWriteTime != _lastWriteTime
-                || result->_executionHash != _executionHash // because _dotIgnoreNode changed
+                result._lastWriteTime != _lastWriteTime
+                || result._executionHash != _executionHash // because _dotIgnoreNode changed
             ) {
-                retrieveContent(result->_content, result->_added, result->_removed, result->_kept);
-                result->_executionHash = computeExecutionHash(_dotIgnoreNode->hash(), result->_content);
+                retrieveContent(result._content, result._added, result._kept, result._removed);
+                result._executionHash = computeExecutionHash(_dotIgnoreNode->hash(), result._content);
             }
         } catch (std::filesystem::filesystem_error fserr) {
             success = false;
@@ -405,49 +423,16 @@ namespace YAM
             LogRecord error(LogRecord::Aspect::Error, ss.str());
             context()->addToLogBook(error);
         }
-        result->_newState = success ? Node::State::Ok : Node::State::Failed;
-        auto d = Delegate<void>::CreateLambda(
-            [this, result]() { handleRetrieveContentCompletion(*result); }
-        );
-        context()->mainThreadQueue().push(std::move(d));
-    }
-
-    void DirectoryNode::handleRetrieveContentCompletion(RetrieveResult& result) {
-        if (result._newState != Node::State::Ok) {
-            notifyCompletion(result._newState);
-        } else if (canceling()) {
-            result._newState = Node::State::Canceled;
-            notifyCompletion(result._newState);
-        } else {
-            if (
-                result._lastWriteTime == _lastWriteTime
-                && result._executionHash == _executionHash
-            ) {
-                updateBuildFileParserNode();
-                startSubDirs();
-            } else {
-                commitResult(result);
-                startSubDirs();
-            }
-        }
+        result._newState = success ? Node::State::Ok : Node::State::Failed;
     }
 
-    void DirectoryNode::startSubDirs() {
-        std::vector<Node*> dirtyChildren;
+    void DirectoryNode::getDirtySubDirs(std::vector<Node*>& dirtySubDirs) const {
         for (auto it = _content.begin(); it != _content.end(); ++it) {
             auto sdir = dynamic_pointer_cast<DirectoryNode>(it->second);
             if (sdir != nullptr && sdir->state() == Node::State::Dirty) {
-                dirtyChildren.push_back(sdir.get());
+                dirtySubDirs.push_back(sdir.get());
             }
         }
-        if (dirtyChildren.empty()) {
-            Node::notifyCompletion(Node::State::Ok);
-        } else {
-            auto callback = Delegate<void, Node::State>::CreateLambda(
-                [this](Node::State s) { Node::notifyCompletion(s); }
-            );
-            startNodes(dirtyChildren, std::move(callback), PriorityClass::VeryHigh);
-        }
     }
 
     // Executes in main thread
@@ -455,10 +440,8 @@ namespace YAM
         bool dirChanged = _executionHash != result._executionHash;
         _lastWriteTime = result._lastWriteTime;
         _executionHash = result._executionHash;
-        _content.clear();
-        for (auto const& node : result._kept) {
-            _content.insert({ node->name(), node });
-        }
+        std::vector<std::shared_ptr<Node>> content(result._kept);
+        content.reserve(result._kept.size() + result._added.size());
         for (auto const& n : result._added) {
             // A node with name n->name() may already exist in buildstate.
             // If so, use that one instead of n.
@@ -469,7 +452,7 @@ namespace YAM
                     node = n;
                     context()->nodes().add(node);
                 }
-                _content.insert({ node->name(), node });
+                content.push_back(node);
                 auto dir = dynamic_pointer_cast<DirectoryNode>(node); 
                 if (dir != nullptr) {
                     dir->addObserver(this);
@@ -477,6 +460,7 @@ namespace YAM
                 }
             }
         }
+        _content = NodeMap<Node>(content);
         for (auto const& n : result._removed) {
             _removeChildRecursively(n);
         }
@@ -1,11 +1,11 @@
 #pragma once
 #include "Node.h"
+#include "NodeMap.h"
 #include "MemoryLogBook.h"
 #include "xxhash.h"
 
 #include <chrono>
 #include <vector>
-#include <map>
 #include <unordered_set>
 
 namespace YAM
@@ -60,6 +60,7 @@ namespace YAM
         virtual ~DirectoryNode();
 
         std::string className() const override { return "DirectoryNode"; }
+        NodeKind kind() const override { return NodeKind::Directory; }
 
         void start(PriorityClass prio) override;
 
@@ -83,7 +84,7 @@ namespace YAM
         void getOutputs(std::vector<std::shared_ptr<Node>>& outputs) const override;
         void getInputs(std::vector<std::shared_ptr<Node>>& inputs) const override;
 
-        std::map<std::filesystem::path, std::shared_ptr<Node>> const& getContent() {
+        NodeMap<Node> const& getContent() {
             return _content;
         }
 
@@ -99,7 +100,7 @@ namespace YAM
 
         XXH64_hash_t computeExecutionHash(
             XXH64_hash_t dotIgnoreNodeHash,
-            std::map<std::filesystem::path, std::shared_ptr<Node>> const& content) const;
+            NodeMap<Node> const& content) const;
 
         // Recursively remove the directory content from context->nodes().
         void clear();
@@ -134,18 +135,17 @@ namespace YAM
             Node::State _newState;
             MemoryLogBook _log;
             std::chrono::time_point<std::chrono::utc_clock> _lastWriteTime;
-            std::map<std::filesystem::path, std::shared_ptr<Node>> _content;
-            // the difference with _content and this->_content
-            std::unordered_set<std::shared_ptr<Node>> _added;
-            std::unordered_set<std::shared_ptr<Node>> _kept;
-            std::unordered_set<std::shared_ptr<Node>> _removed;
+            NodeMap<Node> _content;
+            // the difference with _content and this->_content, sorted by name
+            std::vector<std::shared_ptr<Node>> _added;
+            std::vector<std::shared_ptr<Node>> _kept;
+            std::vector<std::shared_ptr<Node>> _removed;
             XXH64_hash_t _executionHash;
         };
 
-        void handleRequisitesCompletion(Node::State state);
-        void retrieveContentIfNeeded(); // Executes in a threadpool thread
-        void handleRetrieveContentCompletion(RetrieveResult& result);
-        void startSubDirs();
+        NodeTask execute(PriorityClass prio);
+        void retrieveContentIfNeeded(RetrieveResult& result); // Executes in a threadpool thread
+        void getDirtySubDirs(std::vector<Node*>& dirtySubDirs) const;
         void commitResult(YAM::DirectoryNode::RetrieveResult& result);
         void updateBuildFileParserNode();
         void _removeChildRecursively(std::shared_ptr<Node> const& child);
@@ -154,22 +154,20 @@ namespace YAM
         std::chrono::time_point<std::chrono::utc_clock> retrieveLastWriteTime() const;
         std::shared_ptr<Node> getNode(
             std::filesystem::directory_entry const& dirEntry,
-            std::shared_ptr<FileRepositoryNode> const& repo,
-            std::unordered_set<std::shared_ptr<Node>>& added,
-            std::unordered_set<std::shared_ptr<Node>>& kept);
+            std::shared_ptr<FileRepositoryNode> const& repo);
         void retrieveContent(
-            std::map<std::filesystem::path, std::shared_ptr<Node>>& content,
-            std::unordered_set<std::shared_ptr<Node>>& added,
-            std::unordered_set<std::shared_ptr<Node>>& kept,
-            std::unordered_set<std::shared_ptr<Node>>& removed);
+            NodeMap<Node>& content,
+            std::vector<std::shared_ptr<Node>>& added,
+            std::vector<std::shared_ptr<Node>>& kept,
+            std::vector<std::shared_ptr<Node>>& removed);
 
         DirectoryNode* _parent;
         std::shared_ptr<DotIgnoreNode> _dotIgnoreNode;
         std::shared_ptr<BuildFileParserNode> _buildFileParserNode;
         std::shared_ptr<BuildFileCompilerNode> _buildFileCompilerNode;
         std::chrono::time_point<std::chrono::utc_clock> _lastWriteTime;
-        std::map<std::filesystem::path, std::shared_ptr<Node>> _content;
-        std::map<std::filesystem::path, std::shared_ptr<GeneratedFileNode>> _generatedContent;
+        NodeMap<Node> _content;
+        NodeMap<GeneratedFileNode> _generatedContent;
         XXH64_hash_t _executionHash;
     };
 }
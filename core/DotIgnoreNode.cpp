@@ -40,8 +40,8 @@ namespace YAM
         , _directory(directory)
         , _hash(rand())
     {
-        _dotIgnoreFiles.push_back(std::make_shared<SourceFileNode>(context, _directory->name() / ".gitignore"));
-        _dotIgnoreFiles.push_back(std::make_shared<SourceFileNode>(context, _directory->name() / ".yamignore"));
+        _dotIgnoreFiles.push_back(makeShared<SourceFileNode>(context, _directory->name() / ".gitignore"));
+        _dotIgnoreFiles.push_back(makeShared<SourceFileNode>(context, _directory->name() / ".yamignore"));
     }
 
     void DotIgnoreNode::addPrerequisitesToContext() {
@@ -94,7 +94,7 @@ namespace YAM
     XXH64_hash_t DotIgnoreNode::computeHash() const {
         std::vector<XXH64_hash_t> hashes;
         for (auto const& node : _dotIgnoreFiles) {
-            hashes.push_back(node->hashOf(FileAspect::entireFileAspect().name()));
+            hashes.push_back(node->hashOf(FileAspect::entireFileAspect()));
         }
         XXH64_hash_t hash = XXH64(hashes.data(), sizeof(XXH64_hash_t) * hashes.size(), 0);
         return hash;
@@ -120,7 +120,7 @@ namespace YAM
             auto d = Delegate<void>::CreateLambda(
                 [this]() { parseDotIgnoreFiles(); }
             );
-            context()->threadPoolQueue().push(std::move(d), PriorityClass::High);
+            context()->ioQueue().push(std::move(d), PriorityClass::High);
         } else {
             Node::notifyCompletion(state);
         }
@@ -32,6 +32,7 @@ namespace YAM
             DirectoryNode *directory);
 
         std::string className() const override { return "DotIgnoreNode"; }
+        NodeKind kind() const override { return NodeKind::DotIgnore; }
 
         // Add the prerequisites (i.e, the .gitignore and .yamignore file nodes
         // to the execution context.
@@ -4,6 +4,11 @@
 #include "FileRepositoryNode.h"
 #include "BuildRequest.h"
 #include "ConsoleLogBook.h"
+#include "JobServer.h"
+#include "FileHashCache.h"
+#include "GraphSnapshot.h"
+
+#include <sstream>
 
 namespace
 {
@@ -16,13 +21,6 @@ namespace
         return n;
     }
 
-    Delegate<bool, std::shared_ptr<Node> const&> includeIfDirty = 
-        Delegate<bool, std::shared_ptr<Node> const&>::CreateLambda(
-            [](std::shared_ptr<Node> const& node) 
-            { 
-                return node->state() == Node::State::Dirty; 
-            });
-
 
     static std::shared_ptr<FileRepositoryNode> nullRepo;
 }
@@ -32,9 +30,12 @@ namespace YAM
 
     ExecutionContext::ExecutionContext()
         : _mainThreadQueue(nPriorities())
-        , _threadPoolQueue(nPriorities())
+        , _ioQueue(nPriorities(), static_cast<uint32_t>(getDefaultPoolSize()))
+        , _processQueue(nPriorities(), static_cast<uint32_t>(getDefaultPoolSize()))
         , _mainThread(&_mainThreadQueue, "YAM_main")
-        , _threadPool(&_threadPoolQueue, "YAM_threadpool", getDefaultPoolSize()) 
+        , _ioPool(&_ioQueue, "YAM_io", getDefaultPoolSize())
+        , _processPool(&_processQueue, "YAM_process", getDefaultPoolSize())
+        , _snapshot(std::make_shared<GraphSnapshot>())
         , _logBook(std::make_shared<ConsoleLogBook>())
     {
         auto const& entireFileSet = FileAspectSet::entireFileSet();
@@ -46,16 +47,22 @@ namespace YAM
         _mainThreadQueue.stop(); // this will cause _mainThread to finish
     }
 
-    ThreadPool& ExecutionContext::threadPool() {
-        return _threadPool;
+    ThreadPool& ExecutionContext::ioPool() {
+        return _ioPool;
+    }
+    ThreadPool& ExecutionContext::processPool() {
+        return _processPool;
     }
     Thread& ExecutionContext::mainThread() {
         return _mainThread;
     }
-    PriorityDispatcher& ExecutionContext::threadPoolQueue() {
-        return _threadPoolQueue;
+    IPriorityDispatcher& ExecutionContext::ioQueue() {
+        return _ioQueue;
+    }
+    IPriorityDispatcher& ExecutionContext::processQueue() {
+        return _processQueue;
     }
-    PriorityDispatcher& ExecutionContext::mainThreadQueue()  {
+    IPriorityDispatcher& ExecutionContext::mainThreadQueue()  {
         return _mainThreadQueue;
     }
 
@@ -67,6 +74,19 @@ namespace YAM
         return _statistics;
     }
 
+    void ExecutionContext::resetStatistics() {
+        _statistics.reset();
+        _ioQueue.resetStatistics();
+        _processQueue.resetStatistics();
+    }
+
+    void ExecutionContext::updateQueueStatistics() {
+        _statistics.ioQueue.maxDepth = _ioQueue.maxSize();
+        _statistics.ioQueue.nDelegates = _ioQueue.nPushed();
+        _statistics.processQueue.maxDepth = _processQueue.maxSize();
+        _statistics.processQueue.nDelegates = _processQueue.nPushed();
+    }
+
     void ExecutionContext::repositoriesNode(std::shared_ptr<RepositoriesNode> const& node) {
         if (_repositoriesNode != node) {
             if (_repositoriesNode != nullptr) {
@@ -119,12 +139,68 @@ namespace YAM
         return s->second;
     }
 
+    std::shared_ptr<ResourcePool> const& ExecutionContext::resourcePool(ResourceClaim const& claim) {
+        if (claim.empty()) throw std::runtime_error("empty resource claim");
+        auto it = _resourcePools.find(claim.pool);
+        if (it == _resourcePools.end()) {
+            auto pool = std::make_shared<ResourcePool>(claim.pool, claim.capacity, _processQueue);
+            it = _resourcePools.insert({ claim.pool, pool }).first;
+        } else if (it->second->capacity() != claim.capacity) {
+            if (_claimedResourcePools.contains(claim.pool)) {
+                std::stringstream ss;
+                ss << "Resource pool " << claim.pool << " is claimed with capacity " << claim.capacity
+                    << " and with capacity " << it->second->capacity() << "." << std::endl;
+                ss << "Specify the same capacity in all rules that claim the pool." << std::endl;
+                addToLogBook(LogRecord(LogRecord::Error, ss.str()));
+            } else {
+                it->second->capacity(claim.capacity);
+            }
+        }
+        _claimedResourcePools.insert(claim.pool);
+        return it->second;
+    }
+
+    void ExecutionContext::resetResourcePoolClaims() {
+        _claimedResourcePools.clear();
+    }
+
+    void ExecutionContext::jobServer(std::shared_ptr<JobServer> const& server) {
+        _jobServer = server;
+    }
+
+    std::shared_ptr<JobServer> const& ExecutionContext::jobServer() const {
+        return _jobServer;
+    }
+
+    void ExecutionContext::fileHashCache(std::shared_ptr<FileHashCache> const& cache) {
+        _fileHashCache = cache;
+    }
+
+    std::shared_ptr<FileHashCache> const& ExecutionContext::fileHashCache() const {
+        return _fileHashCache;
+    }
+
     NodeSet & ExecutionContext::nodes() {
         return _nodes;
     }
 
     void ExecutionContext::getDirtyNodes(std::vector<std::shared_ptr<Node>>& dirtyNodes) {
-        _nodes.find(includeIfDirty, dirtyNodes);
+        dirtyNodes.clear();
+        _nodes.appendDirtyNodes(dirtyNodes);
+    }
+
+    std::shared_ptr<const GraphSnapshot> ExecutionContext::publishSnapshot() {
+        std::shared_ptr<const GraphSnapshot> previous = snapshot();
+        auto next = std::make_shared<const GraphSnapshot>(this, previous, _nodes.snapshotChanges(), previous->epoch() + 1);
+        _nodes.clearSnapshotChanges();
+        std::lock_guard<std::mutex> lock(_snapshotMutex);
+        _snapshot = next;
+        return next;
+    }
+
+    std::shared_ptr<const GraphSnapshot> ExecutionContext::snapshot() const {
+        std::lock_guard<std::mutex> lock(_snapshotMutex);
+        return _snapshot;
     }
 
     void ExecutionContext::buildRequest(std::shared_ptr<BuildRequest> request) {
@@ -162,5 +238,8 @@ namespace YAM
         }
         _nodes.clear();
         _nodes.clearChangeSet();
+        _fileAspectIndexMap.clear();
+        // Return the memory of the destroyed nodes to the system.
+        SlabPool::releaseAllEmptySlabs();
     }
 }
\ No newline at end of file
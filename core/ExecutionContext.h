@@ -1,13 +1,18 @@
 #pragma once
 
 #include "NodeSet.h"
-#include "PriorityDispatcher.h"
+#include "MpscDispatcher.h"
+#include "WorkStealingDispatcher.h"
 #include "Thread.h"
 #include "ThreadPool.h"
 #include "FileAspectSet.h"
+#include "ResourcePool.h"
+#include "ResourceClaim.h"
 #include "ExecutionStatistics.h"
 
 #include <memory>
+#include <mutex>
+#include <set>
 #include <unordered_set>
 
 namespace YAM
@@ -18,6 +23,9 @@ namespace YAM
     class RepositoriesNode;
     class ILogBook;
     class LogRecord;
+    class JobServer;
+    class GraphSnapshot;
+    class FileHashCache;
 
     class __declspec(dllexport) ExecutionContext
     {
@@ -26,16 +34,32 @@ namespace YAM
         ExecutionContext();
         ~ExecutionContext();
 
-        ThreadPool& threadPool();
+        // Filesystem I/O, like file hashing and directory content retrieval,
+        // is executed by ioPool(). Command scripts are executed by 
+        // processPool(). The pools are sized independently. Separate pools
+        // avoid that hashing stalls while all threads wait for child 
+        // processes to complete and vice versa.
+        // Both pools default to the number of logical cores.
+        ThreadPool& ioPool();
+        ThreadPool& processPool();
         Thread& mainThread();
-        PriorityDispatcher& threadPoolQueue();
-        PriorityDispatcher& mainThreadQueue();
+        IPriorityDispatcher& ioQueue();
+        IPriorityDispatcher& processQueue();
+        IPriorityDispatcher& mainThreadQueue();
 
         // Throw an exception when called in other thread than mainThread.
         void assertMainThread();
 
         ExecutionStatistics& statistics();
 
+        // Reset statistics(), including the queue depth statistics of 
+        // ioQueue() and processQueue().
+        void resetStatistics();
+
+        // Copy the queue depth statistics of ioQueue() and processQueue()
+        // to statistics().ioQueue and statistics().processQueue.
+        void updateQueueStatistics();
+
         void repositoriesNode(std::shared_ptr<RepositoriesNode> const& node);
         std::shared_ptr<RepositoriesNode> const& repositoriesNode() const;
 
@@ -65,10 +89,59 @@ namespace YAM
         // 
         FileAspectSet const& findFileAspectSet(std::string const& aspectSetName) const;
 
+        // Return the resource pool with name claim.pool. Create the pool 
+        // when it does not yet exist. Set the pool capacity to claim.capacity
+        // when the pool was not yet claimed since resetResourcePoolClaims().
+        // Log an error and keep the pool capacity when the pool was claimed
+        // with another capacity, i.e. when rules in different buildfiles
+        // specify different capacities for the same pool. BuildFileCompiler
+        // detects such conflicts between the rules in one buildfile.
+        // Script executions of commands that claim pool tokens are admitted
+        // to processQueue() by the pool.
+        // Pre: !claim.empty()
+        std::shared_ptr<ResourcePool> const& resourcePool(ResourceClaim const& claim);
+
+        // Allow the next claims to change the pool capacities, called at
+        // the start of each build.
+        void resetResourcePoolClaims();
+
+        // Set/get the jobserver that limits the concurrency of command 
+        // scripts and of the build tools started by these scripts.
+        // Nullptr when concurrency is only limited by processPool().size().
+        // Only set the jobserver when no command scripts are executing.
+        void jobServer(std::shared_ptr<JobServer> const& server);
+        std::shared_ptr<JobServer> const& jobServer() const;
+
+        // Set/get the cache that is consulted by FileNodes before hashing
+        // files. Nullptr when files are always hashed.
+        // Only set the cache when no files are being hashed.
+        void fileHashCache(std::shared_ptr<FileHashCache> const& cache);
+        std::shared_ptr<FileHashCache> const& fileHashCache() const;
+
+        // Return the map of the file aspect indices of this process to the
+        // file aspect indices of the persistent build state.
+        FileAspectIndexMap& fileAspectIndexMap() { return _fileAspectIndexMap; }
+
         NodeSet & nodes();
-        // Return the nodes that are in state Node::State::Dirty
+        // Return the nodes that are in state Node::State::Dirty, i.e. the
+        // concatenation of the dirty node lists in nodes().
         void getDirtyNodes(std::vector<std::shared_ptr<Node>>& dirtyNodes);
 
+        // Take a snapshot of nodes() and repositories() and make it the
+        // snapshot returned by snapshot(). The new snapshot has the epoch of
+        // the previous snapshot + 1. It is taken incrementally from the
+        // previous snapshot and nodes().snapshotChanges(), i.e. its cost is
+        // proportional to the number of nodes that changed since the
+        // previous snapshot, see GraphSnapshot.
+        // Pre: called in mainThread()
+        std::shared_ptr<const GraphSnapshot> publishSnapshot();
+
+        // Return the last published snapshot. Initially the empty snapshot
+        // with epoch 0.
+        // Can be called in any thread. Use this snapshot to query the
+        // build graph in other threads than mainThread().
+        std::shared_ptr<const GraphSnapshot> snapshot() const;
+
         void logBook(std::shared_ptr<ILogBook> newBook);
         std::shared_ptr<ILogBook> logBook() const;
         void addToLogBook(LogRecord const& record);
@@ -79,15 +152,21 @@ namespace YAM
         // Fill 'buildState' with nodes and repositories.
         void getBuildState(std::unordered_set<std::shared_ptr<IPersistable>>& buildState);
 
-        // Post: nodes.empty() and repositories().empty()
+        // Post: nodes.empty() and repositories().empty() and
+        // fileAspectIndexMap().names().empty()
+        // Releases the empty node slabs, see SlabPool.
+        // Does not clear PathInterner::names(): reloading the build state
+        // re-uses the interned node names.
         void clearBuildState();
 
 
     private:
-        PriorityDispatcher _mainThreadQueue;
-        PriorityDispatcher _threadPoolQueue;
+        MpscDispatcher _mainThreadQueue;
+        WorkStealingDispatcher _ioQueue;
+        WorkStealingDispatcher _processQueue;
         Thread _mainThread;
-        ThreadPool _threadPool;
+        ThreadPool _ioPool;
+        ThreadPool _processPool;
         ExecutionStatistics _statistics;
 
         std::shared_ptr<RepositoriesNode> _repositoriesNode;
@@ -96,7 +175,16 @@ namespace YAM
         std::map<std::string, FileAspect> _fileAspects;
         std::map<std::string, FileAspectSet> _fileAspectSets;
 
+        std::map<std::string, std::shared_ptr<ResourcePool>> _resourcePools;
+        std::set<std::string> _claimedResourcePools;
+        std::shared_ptr<JobServer> _jobServer;
+        std::shared_ptr<FileHashCache> _fileHashCache;
+        FileAspectIndexMap _fileAspectIndexMap;
+
         NodeSet _nodes;
+
+        mutable std::mutex _snapshotMutex;
+        std::shared_ptr<const GraphSnapshot> _snapshot;
         
         std::shared_ptr<ILogBook> _logBook;
         std::shared_ptr<BuildRequest> _request;
@@ -1,5 +1,10 @@
 #include "ExecutionStatistics.h"
 
+namespace
+{
+    std::atomic<uint64_t> nextId(1);
+}
+
 namespace YAM
 {
     ExecutionStatistics::ExecutionStatistics()
@@ -7,7 +12,9 @@ namespace YAM
         , nSelfExecuted(0)
         , registerNodes(false)
         , nRehashedFiles(0)
+        , nRehashedBytes(0)
         , nDirectoryUpdates(0)
+        , _id(nextId++)
     {
     }
 
@@ -15,11 +22,22 @@ namespace YAM
         nStarted = 0;
         nSelfExecuted = 0;
         nRehashedFiles = 0;
+        nRehashedBytes = 0;
         nDirectoryUpdates = 0;
         started.clear();
         selfExecuted.clear();
         rehashedFiles.clear();
         updatedDirectories.clear();
+        ioQueue = QueueStatistics();
+        processQueue = QueueStatistics();
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (auto const& shard : _shards) {
+            shard->nRehashedFiles = 0;
+            shard->nRehashedBytes = 0;
+            shard->nDirectoryUpdates = 0;
+            shard->rehashedFiles.clear();
+            shard->updatedDirectories.clear();
+        }
     }
 
     void ExecutionStatistics::registerStarted(Node const* node) {
@@ -37,20 +55,66 @@ namespace YAM
         }
     }
 
+    ExecutionStatistics::Shard& ExecutionStatistics::shard() {
+        // Shards are owned by their statistics object and are never deleted
+        // before that object. Ids are never re-used, hence a cached shard 
+        // is only used while its owner exists.
+        struct Cache {
+            uint64_t id = 0;
+            Shard* shard = nullptr;
+        };
+        thread_local Cache cache;
+        if (cache.id != _id) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto const thisThread = std::this_thread::get_id();
+            Shard* found = nullptr;
+            for (auto const& s : _shards) {
+                if (s->thread == thisThread) found = s.get();
+            }
+            if (found == nullptr) {
+                _shards.push_back(std::make_unique<Shard>());
+                found = _shards.back().get();
+                found->thread = thisThread;
+            }
+            cache.id = _id;
+            cache.shard = found;
+        }
+        return *cache.shard;
+    }
 
     void ExecutionStatistics::registerRehashedFile(FileNode const* node) {
-        nRehashedFiles++;
-        if (registerNodes) {
-            std::lock_guard<std::mutex> lock(mutex);
-            rehashedFiles.insert(node);
+        Shard& s = shard();
+        s.nRehashedFiles++;
+        if (registerNodes.load(std::memory_order_relaxed)) {
+            s.rehashedFiles.push_back(node);
         }
     }
 
+    void ExecutionStatistics::registerRehashedBytes(uint64_t nBytes) {
+        shard().nRehashedBytes += nBytes;
+    }
+
     void ExecutionStatistics::registerUpdatedDirectory(DirectoryNode const* node) {
-        nDirectoryUpdates++;
-        if (registerNodes) {
-            std::lock_guard<std::mutex> lock(mutex);
-            updatedDirectories.insert(node);
+        Shard& s = shard();
+        s.nDirectoryUpdates++;
+        if (registerNodes.load(std::memory_order_relaxed)) {
+            s.updatedDirectories.push_back(node);
+        }
+    }
+
+    void ExecutionStatistics::merge() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (auto const& shard : _shards) {
+            nRehashedFiles += shard->nRehashedFiles;
+            nRehashedBytes += shard->nRehashedBytes;
+            nDirectoryUpdates += shard->nDirectoryUpdates;
+            rehashedFiles.insert(shard->rehashedFiles.begin(), shard->rehashedFiles.end());
+            updatedDirectories.insert(shard->updatedDirectories.begin(), shard->updatedDirectories.end());
+            shard->nRehashedFiles = 0;
+            shard->nRehashedBytes = 0;
+            shard->nDirectoryUpdates = 0;
+            shard->rehashedFiles.clear();
+            shard->updatedDirectories.clear();
         }
     }
-}
\ No newline at end of file
+}
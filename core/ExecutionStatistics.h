@@ -1,8 +1,12 @@
 #pragma once
 
 #include <unordered_set>
+#include <vector>
+#include <memory>
 #include <mutex>
+#include <thread>
 #include <atomic>
+#include <cstdint>
 
 namespace YAM
 {
@@ -13,16 +17,34 @@ namespace YAM
     class __declspec(dllexport) ExecutionStatistics
     {
     public:
+        struct QueueStatistics {
+            // maximum number of queued delegates
+            std::size_t maxDepth = 0;
+            // number of delegates pushed to queue
+            uint64_t nDelegates = 0;
+        };
+
         ExecutionStatistics();
 
         void reset();
 
+        // Called from main thread.
         void registerStarted(Node const* node);
         void registerSelfExecuted(Node const* node);
 
+        // Called from threadpool. Registrations are collected in per-thread
+        // shards without synchronization and are added to nRehashedFiles,
+        // nRehashedBytes, rehashedFiles, nDirectoryUpdates and 
+        // updatedDirectories by merge().
         void registerRehashedFile(FileNode const* node);
+        void registerRehashedBytes(uint64_t nBytes);
         void registerUpdatedDirectory(DirectoryNode const* node);
 
+        // Merge the per-thread registrations into the public fields.
+        // Pre: called from main thread and no registration is in progress,
+        // e.g. at completion of a build.
+        void merge();
+
         // number of nodes started
         unsigned int nStarted;
         // number of nodes self-executed
@@ -34,15 +56,36 @@ namespace YAM
         std::unordered_set<Node const*> started;
         std::unordered_set<Node const*> selfExecuted;
 
-        // These two fields are incremented from threadpool,
-        // hence use atomics.
-        std::atomic<unsigned int> nRehashedFiles;
-        std::atomic<unsigned int> nDirectoryUpdates;
-
-        std::mutex mutex;
-        // These 2 fields are updated from threadpool.
-        // Use mutex to do MT-safe update.
+        // Valid after merge().
+        unsigned int nRehashedFiles;
+        // number of bytes read from files to compute file aspect hashes
+        uint64_t nRehashedBytes;
+        unsigned int nDirectoryUpdates;
         std::unordered_set<FileNode const*> rehashedFiles;
         std::unordered_set<DirectoryNode const*> updatedDirectories;
+
+        // Queue depth statistics of ExecutionContext::ioQueue() and
+        // ExecutionContext::processQueue().
+        // See ExecutionContext::updateQueueStatistics().
+        QueueStatistics ioQueue;
+        QueueStatistics processQueue;
+
+    private:
+        // Aligned to avoid false sharing between threads.
+        struct alignas(64) Shard {
+            std::thread::id thread;
+            unsigned int nRehashedFiles = 0;
+            uint64_t nRehashedBytes = 0;
+            unsigned int nDirectoryUpdates = 0;
+            std::vector<FileNode const*> rehashedFiles;
+            std::vector<DirectoryNode const*> updatedDirectories;
+        };
+
+        Shard& shard();
+
+        // Identifies this object in the thread-local shard cache.
+        uint64_t _id;
+        std::mutex _mutex;
+        std::vector<std::unique_ptr<Shard>> _shards;
     };
 }
@@ -1,16 +1,87 @@
 #include "FileAspect.h"
+#include "FileReader.h"
+#include "IStreamer.h"
+#include "TreeHash.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+namespace
+{
+    using namespace YAM;
+
+    const char* const entireFileName = "entireFile";
+
+    struct AspectNames {
+        std::mutex mutex;
+        std::map<std::string, std::size_t> indices = { {entireFileName, 0} };
+        std::vector<std::string> names = { entireFileName };
+    };
+
+    AspectNames& aspectNames() {
+        static AspectNames names;
+        return names;
+    }
+
+    Delegate<XXH64_hash_t, std::filesystem::path const&> pathHashFunction(
+        Delegate<XXH64_hash_t, std::string_view, IPriorityDispatcher*> const& contentHashFunction
+    ) {
+        return Delegate<XXH64_hash_t, std::filesystem::path const&>::CreateLambda(
+            [contentHashFunction](std::filesystem::path const& fileName) {
+                XXH64_hash_t hash = 0;
+                FileReader::read(fileName, Delegate<void, std::string_view>::CreateLambda(
+                    [&contentHashFunction, &hash](std::string_view content) {
+                        hash = contentHashFunction.Execute(content, nullptr);
+                    }));
+                return hash;
+            });
+    }
+}
 
 namespace YAM
 {
     FileAspect::FileAspect(
         std::string const & name,
         RegexSet const& fileNamePatterns,
-        Delegate<XXH64_hash_t, std::filesystem::path const&> const& hashFunction)
+        Delegate<XXH64_hash_t, std::filesystem::path const&> const& hashFunction,
+        uint32_t version)
         : _name(name)
+        , _index(indexOf(name))
+        , _version(version)
         , _fileNamePatterns(fileNamePatterns)
         , _hashFunction(hashFunction)
     { }
 
+    FileAspect::FileAspect(
+        std::string const& name,
+        RegexSet const& fileNamePatterns,
+        Delegate<XXH64_hash_t, std::string_view, IPriorityDispatcher*> const& contentHashFunction,
+        uint32_t version)
+        : _name(name)
+        , _index(indexOf(name))
+        , _version(version)
+        , _fileNamePatterns(fileNamePatterns)
+        , _hashFunction(pathHashFunction(contentHashFunction))
+        , _contentHashFunction(contentHashFunction)
+    { }
+
+    FileAspect::FileAspect(
+        std::string const& name,
+        RegexSet const& fileNamePatterns,
+        Delegate<XXH64_hash_t, std::filesystem::path const&> const& hashFunction,
+        Delegate<XXH64_hash_t, std::string_view, IPriorityDispatcher*> const& contentHashFunction,
+        uint32_t version)
+        : _name(name)
+        , _index(indexOf(name))
+        , _version(version)
+        , _fileNamePatterns(fileNamePatterns)
+        , _hashFunction(hashFunction)
+        , _contentHashFunction(contentHashFunction)
+    { }
+
     std::string const& FileAspect::name() const {
         return _name;
     }
@@ -32,16 +103,147 @@ namespace YAM
         return _hashFunction.Execute(fileName);
     }
 
+    XXH64_hash_t FileAspect::hashContent(std::string_view content, IPriorityDispatcher* helpers) const {
+        return _contentHashFunction.Execute(content, helpers);
+    }
+
+    uint64_t FileAspect::hashFile(
+        std::filesystem::path const& path,
+        std::vector<FileAspect> const& aspects,
+        FileAspectHashes& hashes,
+        IPriorityDispatcher* helpers,
+        bool* readFailed
+    ) {
+        bool failed = false;
+        bool hashContent = std::any_of(aspects.begin(), aspects.end(),
+            [](FileAspect const& aspect) { return aspect.hashesContent(); });
+        uint64_t nBytesRead = 0;
+        bool read = hashContent && FileReader::read(path, Delegate<void, std::string_view>::CreateLambda(
+            [&aspects, &hashes, &nBytesRead, helpers](std::string_view content) {
+                nBytesRead += content.size();
+                for (auto const& aspect : aspects) {
+                    if (aspect.hashesContent()) hashes.set(aspect, aspect.hashContent(content, helpers));
+                }
+            }));
+        if (hashContent && !read) failed = true;
+        for (auto const& aspect : aspects) {
+            if (!read || !aspect.hashesContent()) {
+                hashes.set(aspect, aspect.hash(path));
+                std::error_code ec;
+                uint64_t size = std::filesystem::file_size(path, ec);
+                if (!ec) nBytesRead += size;
+                else failed = true;
+            }
+        }
+        if (readFailed != nullptr) *readFailed = failed;
+        return nBytesRead;
+    }
+
     FileAspect const & FileAspect::entireFileAspect() {
-        static Delegate<XXH64_hash_t, std::filesystem::path const&> hashEntireFile =
-            Delegate<XXH64_hash_t, std::filesystem::path const&>::CreateLambda(
-                [](std::filesystem::path const& fn) {
-                    return XXH64_file(fn.string().c_str());
+        static Delegate<XXH64_hash_t, std::string_view, IPriorityDispatcher*> hashEntireContent =
+            Delegate<XXH64_hash_t, std::string_view, IPriorityDispatcher*>::CreateLambda(
+                [](std::string_view content, IPriorityDispatcher* helpers) {
+                    return TreeHash::hash64(content, helpers);
                 });
         static FileAspect entireFileAspect(
-            std::string("entireFile"), 
+            std::string(entireFileName), 
             RegexSet({ ".*" }), 
-            hashEntireFile);
+            hashEntireContent);
         return entireFileAspect;
     }
-}
\ No newline at end of file
+
+    std::size_t FileAspect::indexOf(std::string const& name) {
+        AspectNames& names = aspectNames();
+        std::lock_guard<std::mutex> lock(names.mutex);
+        auto it = names.indices.find(name);
+        if (it == names.indices.end()) {
+            if (names.names.size() == maxAspects) throw std::runtime_error("too many file aspects");
+            it = names.indices.insert({ name, names.names.size() }).first;
+            names.names.push_back(name);
+        }
+        return it->second;
+    }
+
+    std::string FileAspect::nameOf(std::size_t index) {
+        AspectNames& names = aspectNames();
+        std::lock_guard<std::mutex> lock(names.mutex);
+        if (index >= names.names.size()) throw std::runtime_error("no such file aspect index");
+        return names.names[index];
+    }
+
+    void FileAspectHashes::randomize() {
+        for (std::size_t i = 0; i < FileAspect::maxAspects; ++i) {
+            if (_valid & (1u << i)) _hashes[i] = rand();
+        }
+    }
+
+    bool FileAspectHashes::operator==(FileAspectHashes const& rhs) const {
+        if (_valid != rhs._valid) return false;
+        for (std::size_t i = 0; i < FileAspect::maxAspects; ++i) {
+            if ((_valid & (1u << i)) && _hashes[i] != rhs._hashes[i]) return false;
+        }
+        return true;
+    }
+
+    void FileAspectHashes::stream(IStreamer* streamer) {
+        streamer->stream(_valid);
+        for (std::size_t i = 0; i < FileAspect::maxAspects; ++i) {
+            if (_valid & (1u << i)) streamer->stream(_hashes[i]);
+        }
+    }
+
+    FileAspectIndexMap::FileAspectIndexMap() {
+        clear();
+    }
+
+    void FileAspectIndexMap::names(std::vector<std::string> const& names) {
+        if (names.size() > FileAspect::maxAspects) throw std::runtime_error("too many file aspects in build state");
+        clear();
+        _names = names;
+        for (std::size_t i = 0; i < _names.size(); ++i) {
+            std::size_t index;
+            try {
+                index = FileAspect::indexOf(_names[i]);
+            } catch (std::runtime_error const&) {
+                continue;
+            }
+            _toStored[index] = i;
+            _toProcess[i] = index;
+        }
+    }
+
+    void FileAspectIndexMap::store(FileAspectHashes const& hashes, FileAspectHashes& stored) {
+        stored = FileAspectHashes();
+        for (std::size_t i = 0; i < FileAspect::maxAspects; ++i) {
+            if ((hashes._valid & (1u << i)) == 0) continue;
+            if (_toStored[i] == FileAspect::maxAspects) {
+                if (_names.size() == FileAspect::maxAspects) throw std::runtime_error("too many file aspects in build state");
+                _toStored[i] = _names.size();
+                _toProcess[_names.size()] = i;
+                _names.push_back(FileAspect::nameOf(i));
+                _modified = true;
+            }
+            std::size_t si = _toStored[i];
+            stored._hashes[si] = hashes._hashes[i];
+            stored._valid |= (1u << si);
+        }
+    }
+
+    void FileAspectIndexMap::retrieve(FileAspectHashes const& stored, FileAspectHashes& hashes) const {
+        hashes = FileAspectHashes();
+        for (std::size_t si = 0; si < FileAspect::maxAspects; ++si) {
+            if ((stored._valid & (1u << si)) == 0) continue;
+            std::size_t i = _toProcess[si];
+            if (i == FileAspect::maxAspects) continue;
+            hashes._hashes[i] = stored._hashes[si];
+            hashes._valid |= (1u << i);
+        }
+    }
+
+    void FileAspectIndexMap::clear() {
+        _names.clear();
+        _toStored.fill(FileAspect::maxAspects);
+        _toProcess.fill(FileAspect::maxAspects);
+        _modified = false;
+    }
+}
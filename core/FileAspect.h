@@ -4,16 +4,24 @@
 #include "Delegates.h"
 #include "xxhash.h"
 
+#include <array>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <filesystem>
 #include <regex>
 
 namespace YAM
 {
+    class IStreamer;
+    class IPriorityDispatcher;
+    class FileAspectHashes;
+
     class __declspec(dllexport) FileAspect
     {
     public:
+        // Max number of distinct aspect names, see index().
+        static constexpr std::size_t maxAspects = 8;
 
         FileAspect() = default;
         FileAspect(const FileAspect& other) = default;
@@ -26,12 +34,57 @@ namespace YAM
         // lines, trailing and leading whitespace.
         // C++ filename regexes are: \.cpp$, \.h$, \.hpp$, \.inline$
         //
+        // The version identifies the hash function. It must be incremented
+        // when the hash function changes because FileHashCache stores
+        // hashes by aspect name and version.
+        //
+        // Throw exception when more than maxAspects distinct aspect names
+        // are constructed.
+        FileAspect(
+            std::string const& name,
+            RegexSet const& fileNamePatterns,
+            Delegate<XXH64_hash_t, std::filesystem::path const&> const& hashFunction,
+            uint32_t version = 1);
+
+        // Construct an aspect that computes its hash from the file content
+        // in memory. hashFile(..) reads a file once for all its content
+        // hashing aspects. hash(fileName) reads the file and calls 
+        // contentHashFunction.
+        // contentHashFunction(content, helpers) may push delegates to 
+        // helpers, when not null, to hash content in parallel.
+        FileAspect(
+            std::string const& name,
+            RegexSet const& fileNamePatterns,
+            Delegate<XXH64_hash_t, std::string_view, IPriorityDispatcher*> const& contentHashFunction,
+            uint32_t version = 1);
+
+        // Construct an aspect that hashes file content in memory with 
+        // contentHashFunction and that hashes a file with hashFunction.
+        // Both functions must compute the same hash for the same content.
         FileAspect(
             std::string const& name,
             RegexSet const& fileNamePatterns,
-            Delegate<XXH64_hash_t, std::filesystem::path const&> const& hashFunction);
+            Delegate<XXH64_hash_t, std::filesystem::path const&> const& hashFunction,
+            Delegate<XXH64_hash_t, std::string_view, IPriorityDispatcher*> const& contentHashFunction,
+            uint32_t version = 1);
 
         std::string const& name() const;
+        uint32_t version() const { return _version; }
+
+        // Return the index of the aspect with given name, assign the next
+        // free index when name has no index yet.
+        // Throw exception when all maxAspects indices are in use.
+        static std::size_t indexOf(std::string const& name);
+
+        // Return the aspect name that has given index.
+        // Throw exception when index is not assigned.
+        static std::string nameOf(std::size_t index);
+
+        // Return the dense index of name(), index < maxAspects.
+        // Aspect names are assigned indices in order of first construction,
+        // the entireFile aspect has index 0. A default constructed aspect
+        // has index maxAspects.
+        std::size_t index() const { return _index; }
         RegexSet& fileNamePatterns();
         Delegate<XXH64_hash_t, std::filesystem::path const&> const& hashFunction() const;
 
@@ -42,13 +95,121 @@ namespace YAM
         // Pre: this.matches(fileName)
         XXH64_hash_t hash(std::filesystem::path const& fileName) const;
 
+        // Return whether the aspect can hash file content in memory.
+        bool hashesContent() const { return _contentHashFunction.IsBound(); }
+
+        // Pre: hashesContent()
+        XXH64_hash_t hashContent(std::string_view content, IPriorityDispatcher* helpers = nullptr) const;
+
+        // Compute the hashes of the given aspects of the file at given path
+        // and set them in 'hashes'.
+        // The file is read once, see FileReader, and all aspects that hash
+        // content hash that content, using helpers when not null. Other 
+        // aspects hash the file by itself.
+        // When readFailed is not null: set *readFailed to whether the file
+        // could not be read, in which case the hashes are not the hashes
+        // of the file content.
+        // Return the number of bytes read from the file.
+        static uint64_t hashFile(
+            std::filesystem::path const& path,
+            std::vector<FileAspect> const& aspects,
+            FileAspectHashes& hashes,
+            IPriorityDispatcher* helpers = nullptr,
+            bool* readFailed = nullptr);
+
         // Return the aspect whose hash includes all of a file's content and
-        // that matches all file names.
+        // that matches all file names. The hash is a TreeHash.
         static FileAspect const & entireFileAspect();
 
     private:
         std::string _name;
+        std::size_t _index = maxAspects;
+        uint32_t _version = 0;
         RegexSet _fileNamePatterns;
         Delegate<XXH64_hash_t, std::filesystem::path const&> _hashFunction;
+        // Not bound when the aspect only hashes files by path.
+        Delegate<XXH64_hash_t, std::string_view, IPriorityDispatcher*> _contentHashFunction;
+    };
+
+    // The hashes of the aspects of a file, stored in a slot per aspect
+    // index.
+    class __declspec(dllexport) FileAspectHashes
+    {
+    public:
+        bool contains(FileAspect const& aspect) const {
+            return aspect.index() < FileAspect::maxAspects && (_valid & (1u << aspect.index())) != 0;
+        }
+
+        // Pre: contains(aspect)
+        XXH64_hash_t operator[](FileAspect const& aspect) const {
+            return _hashes[aspect.index()];
+        }
+
+        void set(FileAspect const& aspect, XXH64_hash_t hash) {
+            _hashes[aspect.index()] = hash;
+            _valid |= (1u << aspect.index());
+        }
+
+        // Replace the hashes of all contained aspects by random values.
+        void randomize();
+
+        bool operator==(FileAspectHashes const& rhs) const;
+
+        void stream(IStreamer* streamer);
+
+    private:
+        friend class FileAspectIndexMap;
+
+        std::array<XXH64_hash_t, FileAspect::maxAspects> _hashes{};
+        uint32_t _valid = 0;
+    };
+
+    // Aspect indices are assigned in order of first construction of aspect
+    // names, hence the index of an aspect differs between processes that
+    // construct aspects in different order. A persistent build state stores
+    // the aspect hashes of a file by build state index and stores the 
+    // aspect names by build state index once, see PersistentBuildState.
+    // FileAspectIndexMap maps process indices to build state indices and
+    // vice versa.
+    // A build state stores at most maxAspects aspect names.
+    //
+    // Class is not MT-safe.
+    class __declspec(dllexport) FileAspectIndexMap
+    {
+    public:
+        FileAspectIndexMap();
+
+        // Set the aspect names of the build state, names[i] is the name
+        // of build state index i. Assign process indices to the names that
+        // have no process index yet. Names for which no process index is
+        // available are not mapped.
+        // Post: !modified()
+        void names(std::vector<std::string> const& names);
+        std::vector<std::string> const& names() const { return _names; }
+
+        // Return whether names were added since names(names)
+        bool modified() const { return _modified; }
+        void modified(bool value) { _modified = value; }
+
+        // Set 'stored' to the hashes in 'hashes' by build state index.
+        // Add the names of aspects that have no build state index yet to 
+        // names().
+        // Throw exception when all maxAspects build state indices are in use.
+        void store(FileAspectHashes const& hashes, FileAspectHashes& stored);
+
+        // Set 'hashes' to the hashes in 'stored' by process index. Hashes 
+        // of aspects that are not mapped are not retrieved.
+        void retrieve(FileAspectHashes const& stored, FileAspectHashes& hashes) const;
+
+        // Remove all names.
+        void clear();
+
+    private:
+        std::vector<std::string> _names;
+        // Indexed by process index, maxAspects when not mapped.
+        std::array<std::size_t, FileAspect::maxAspects> _toStored;
+        // Indexed by build state index, maxAspects when not mapped.
+        std::array<std::size_t, FileAspect::maxAspects> _toProcess;
+        bool _modified;
     };
 }
@@ -124,7 +124,7 @@ namespace YAM
         ExecutionContext* context, 
         std::filesystem::path const& repoName)
         : Node(context, repoName / "__invokeConfig")
-        , _configFile(std::make_shared<SourceFileNode>(context, repoName / configFilePath()))
+        , _configFile(makeShared<SourceFileNode>(context, repoName / configFilePath()))
         , _executionHash(rand())
     {
         context->nodes().add(_configFile);
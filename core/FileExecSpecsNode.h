@@ -59,9 +59,12 @@ namespace YAM
         // extension.
         std::string command(std::filesystem::path const& fileName) const;
 
+        XXH64_hash_t executionHash() const { return _executionHash; }
+
         //Inherited from Node
         void start(PriorityClass prio) override;
         std::string className() const override { return "FileExecSpecsNode"; }
+        NodeKind kind() const override { return NodeKind::FileExecSpecs; }
         void cleanup() override;
 
         static void setStreamableType(uint32_t type);
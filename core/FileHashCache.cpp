@@ -0,0 +1,314 @@
+#include "FileHashCache.h"
+#include "FileAspect.h"
+#include "Xxh3.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#if defined( _WIN32 )
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    using namespace YAM;
+
+    // "yamhash" followed by the file format version.
+    const uint64_t magic = 0x02687361686d6179ULL;
+    const std::size_t slotsPerBucket = 8;
+
+    struct Header {
+        std::atomic<uint64_t> magic;
+        uint64_t reserved[7];
+    };
+
+    struct Key {
+        uint64_t key0;
+        uint64_t key1;
+    };
+
+    Key keyOf(FileHashCache::Identity const& identity, FileAspect const& aspect) {
+        uint32_t version = aspect.version();
+        Xxh3::State state;
+        state.update(&identity, sizeof(identity));
+        state.update(&version, sizeof(version));
+        state.update(aspect.name().data(), aspect.name().size());
+        Xxh3Hash128 hash = state.digest128();
+        // Key { 0, 0 } identifies an empty slot.
+        if (hash.low64 == 0 && hash.high64 == 0) hash.high64 = 1;
+        return { hash.low64, hash.high64 };
+    }
+
+#if defined( _WIN32 )
+    // File times are in 100 ns units.
+    const uint64_t oneSecond = 10 * 1000 * 1000;
+
+    uint64_t now() {
+        FILETIME time;
+        GetSystemTimeAsFileTime(&time);
+        return (static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+    }
+
+    bool identifyFile(std::filesystem::path const& path, FileHashCache::Identity& identity) {
+        HANDLE file = CreateFileW(
+            path.wstring().c_str(),
+            FILE_READ_ATTRIBUTES,
+            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            NULL,
+            OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL,
+            NULL);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        BY_HANDLE_FILE_INFORMATION info;
+        FILE_BASIC_INFO basic;
+        FILE_ID_INFO id;
+        bool ok =
+            GetFileInformationByHandle(file, &info)
+            && GetFileInformationByHandleEx(file, FileBasicInfo, &basic, sizeof(basic));
+        // The 64-bit file index of BY_HANDLE_FILE_INFORMATION is not unique
+        // on ReFS, which uses 128-bit file ids.
+        bool hasId = ok && GetFileInformationByHandleEx(file, FileIdInfo, &id, sizeof(id));
+        CloseHandle(file);
+        if (!ok || (info.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0) return false;
+        if (hasId) {
+            static_assert(sizeof(id.FileId) == 2 * sizeof(uint64_t));
+            identity.device = id.VolumeSerialNumber;
+            std::memcpy(&identity.fileIdLow, &id.FileId.Identifier[0], sizeof(uint64_t));
+            std::memcpy(&identity.fileIdHigh, &id.FileId.Identifier[8], sizeof(uint64_t));
+        } else {
+            identity.device = info.dwVolumeSerialNumber;
+            identity.fileIdLow = (static_cast<uint64_t>(info.nFileIndexHigh) << 32) | info.nFileIndexLow;
+            identity.fileIdHigh = 0;
+        }
+        identity.size = (static_cast<uint64_t>(info.nFileSizeHigh) << 32) | info.nFileSizeLow;
+        identity.modified = static_cast<uint64_t>(basic.LastWriteTime.QuadPart);
+        identity.changed = static_cast<uint64_t>(basic.ChangeTime.QuadPart);
+        return true;
+    }
+#else
+    // File times are in ns units.
+    const uint64_t oneSecond = 1000 * 1000 * 1000;
+
+    uint64_t toNs(struct timespec const& time) {
+        return static_cast<uint64_t>(time.tv_sec) * oneSecond + static_cast<uint64_t>(time.tv_nsec);
+    }
+
+    uint64_t now() {
+        struct timespec time;
+        clock_gettime(CLOCK_REALTIME, &time);
+        return toNs(time);
+    }
+
+    bool identifyFile(std::filesystem::path const& path, FileHashCache::Identity& identity) {
+        struct stat status;
+        if (stat(path.c_str(), &status) != 0 || !S_ISREG(status.st_mode)) return false;
+        identity.device = static_cast<uint64_t>(status.st_dev);
+        identity.fileIdLow = static_cast<uint64_t>(status.st_ino);
+        identity.fileIdHigh = 0;
+        identity.size = static_cast<uint64_t>(status.st_size);
+        identity.modified = toNs(status.st_mtim);
+        identity.changed = toNs(status.st_ctim);
+        return true;
+    }
+
+    // Return whether path is a file of given type that is owned by the
+    // effective user. Change its access mode to given mode when it is
+    // also accessible by group or others.
+    bool isPrivate(std::filesystem::path const& path, mode_t type, mode_t mode) {
+        struct stat status;
+        if (lstat(path.c_str(), &status) != 0) return false;
+        if ((status.st_mode & S_IFMT) != type || status.st_uid != geteuid()) return false;
+        if ((status.st_mode & 077) != 0 && chmod(path.c_str(), mode) != 0) return false;
+        return true;
+    }
+#endif
+
+    bool recentlyChanged(FileHashCache::Identity const& identity) {
+        uint64_t changed = (std::max)(identity.modified, identity.changed);
+        uint64_t current = now();
+        return changed > current || current - changed < oneSecond;
+    }
+}
+
+namespace YAM
+{
+    // The sequence is odd while the slot is being written.
+    struct FileHashCache::Slot {
+        std::atomic<uint64_t> sequence;
+        std::atomic<uint64_t> key0;
+        std::atomic<uint64_t> key1;
+        std::atomic<uint64_t> hash;
+    };
+
+    // Slots are accessed by multiple processes: their atomics must not
+    // use process-local locks.
+    static_assert(std::atomic<uint64_t>::is_always_lock_free);
+    static_assert(sizeof(FileHashCache::Identity) == 6 * sizeof(uint64_t));
+
+    struct FileHashCache::Mapping {
+        boost::interprocess::file_mapping file;
+        boost::interprocess::mapped_region region;
+    };
+
+    std::size_t FileHashCache::slotsFor(std::size_t nFiles) {
+        std::size_t nSlots = minSlots;
+        while (nSlots < 2 * nFiles && nSlots < maxSlots) nSlots *= 4;
+        return nSlots;
+    }
+
+    std::filesystem::path FileHashCache::defaultPath(std::size_t nSlots) {
+        std::string name = "fileHashCache_2_" + std::to_string(nSlots);
+#if defined( _WIN32 )
+        // The temp directory is private to the user.
+        return std::filesystem::temp_directory_path() / "yam_cache" / name;
+#else
+        // The temp directory is shared by all users, prefer the user's
+        // cache directory.
+        char const* cacheHome = std::getenv("XDG_CACHE_HOME");
+        if (cacheHome != nullptr && *cacheHome != '\0') return std::filesystem::path(cacheHome) / "yam" / name;
+        char const* home = std::getenv("HOME");
+        if (home != nullptr && *home != '\0') return std::filesystem::path(home) / ".cache" / "yam" / name;
+        std::string dir = "yam_cache_" + std::to_string(geteuid());
+        return std::filesystem::temp_directory_path() / dir / name;
+#endif
+    }
+
+    bool FileHashCache::identify(std::filesystem::path const& path, Identity& identity) {
+        return identifyFile(path, identity);
+    }
+
+    FileHashCache::FileHashCache(std::filesystem::path const& path, std::size_t nSlots)
+        : _nSlots(std::clamp(nSlots, minSlots, maxSlots))
+        , _slots(nullptr)
+    {
+        // A file filled with zeroes is an empty cache. Processes that
+        // concurrently create the file all extend it to the same size.
+        const uint64_t size = sizeof(Header) + _nSlots * sizeof(Slot);
+        std::error_code ec;
+        std::filesystem::create_directories(path.parent_path(), ec);
+#if !defined( _WIN32 )
+        // Another user must not be able to read or poison the hashes.
+        if (!isPrivate(path.parent_path(), S_IFDIR, 0700)) return;
+#endif
+        {
+            std::ofstream create(path, std::ios::binary | std::ios::app);
+        }
+#if !defined( _WIN32 )
+        if (!isPrivate(path, S_IFREG, 0600)) return;
+#endif
+        if (std::filesystem::file_size(path, ec) < size) std::filesystem::resize_file(path, size, ec);
+        if (std::filesystem::file_size(path, ec) != size || ec) return;
+        try {
+            _mapping = std::make_unique<Mapping>();
+            _mapping->file = boost::interprocess::file_mapping(path.string().c_str(), boost::interprocess::read_write);
+            _mapping->region = boost::interprocess::mapped_region(_mapping->file, boost::interprocess::read_write);
+        } catch (boost::interprocess::interprocess_exception const&) {
+            _mapping = nullptr;
+            return;
+        }
+        char* data = static_cast<char*>(_mapping->region.get_address());
+        Header* header = reinterpret_cast<Header*>(data);
+        uint64_t expected = 0;
+        if (header->magic.compare_exchange_strong(expected, magic) || expected == magic) {
+            _slots = reinterpret_cast<Slot*>(data + sizeof(Header));
+        }
+    }
+
+    FileHashCache::~FileHashCache() {
+    }
+
+    bool FileHashCache::find(Identity const& identity, FileAspect const& aspect, XXH64_hash_t& hash) const {
+        Key key = keyOf(identity, aspect);
+        Slot* bucket = _slots + (key.key0 % (_nSlots / slotsPerBucket)) * slotsPerBucket;
+        for (std::size_t i = 0; i < slotsPerBucket; ++i) {
+            Slot& slot = bucket[i];
+            uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence & 1) continue;
+            uint64_t key0 = slot.key0.load(std::memory_order_relaxed);
+            uint64_t key1 = slot.key1.load(std::memory_order_relaxed);
+            uint64_t slotHash = slot.hash.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != sequence) continue;
+            if (key0 == key.key0 && key1 == key.key1) {
+                hash = slotHash;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void FileHashCache::insert(Identity const& identity, FileAspect const& aspect, XXH64_hash_t hash) {
+        if (recentlyChanged(identity)) return;
+        Key key = keyOf(identity, aspect);
+        Slot* bucket = _slots + (key.key0 % (_nSlots / slotsPerBucket)) * slotsPerBucket;
+        auto writing = [](Slot const& slot) {
+            return (slot.sequence.load(std::memory_order_relaxed) & 1) != 0;
+        };
+        // Re-use the slot of the key, else an empty slot, else overwrite
+        // a slot selected by the key. Slots that are being written are
+        // not selected as empty or overwritten slot, hence a slot that
+        // remains odd because its writer died does not block insertion
+        // of other keys in its bucket.
+        Slot* slot = nullptr;
+        for (std::size_t i = 0; i < slotsPerBucket && slot == nullptr; ++i) {
+            uint64_t key0 = bucket[i].key0.load(std::memory_order_relaxed);
+            uint64_t key1 = bucket[i].key1.load(std::memory_order_relaxed);
+            if (key0 == key.key0 && key1 == key.key1) slot = &bucket[i];
+        }
+        for (std::size_t i = 0; i < slotsPerBucket && slot == nullptr; ++i) {
+            uint64_t key0 = bucket[i].key0.load(std::memory_order_relaxed);
+            uint64_t key1 = bucket[i].key1.load(std::memory_order_relaxed);
+            if (key0 == 0 && key1 == 0 && !writing(bucket[i])) slot = &bucket[i];
+        }
+        for (std::size_t i = 0; i < slotsPerBucket && slot == nullptr; ++i) {
+            Slot* victim = &bucket[(key.key1 + i) % slotsPerBucket];
+            if (!writing(*victim)) slot = victim;
+        }
+        if (slot == nullptr) return;
+
+        uint64_t sequence = slot->sequence.load(std::memory_order_relaxed);
+        if (sequence & 1) return;
+        if (!slot->sequence.compare_exchange_strong(sequence, sequence + 1, std::memory_order_relaxed)) return;
+        std::atomic_thread_fence(std::memory_order_release);
+        slot->key0.store(key.key0, std::memory_order_relaxed);
+        slot->key1.store(key.key1, std::memory_order_relaxed);
+        slot->hash.store(hash, std::memory_order_relaxed);
+        slot->sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    uint64_t FileHashCache::hashFile(
+        std::filesystem::path const& path,
+        std::vector<FileAspect> const& aspects,
+        FileAspectHashes& hashes,
+        IPriorityDispatcher* helpers
+    ) {
+        Identity identity;
+        if (!identify(path, identity)) return FileAspect::hashFile(path, aspects, hashes, helpers);
+        std::vector<FileAspect> uncached;
+        for (auto const& aspect : aspects) {
+            XXH64_hash_t hash;
+            if (find(identity, aspect, hash)) hashes.set(aspect, hash);
+            else uncached.push_back(aspect);
+        }
+        if (uncached.empty()) return 0;
+        bool readFailed = false;
+        uint64_t nBytesRead = FileAspect::hashFile(path, uncached, hashes, helpers, &readFailed);
+        Identity hashedIdentity;
+        if (!readFailed && identify(path, hashedIdentity) && hashedIdentity == identity) {
+            for (auto const& aspect : uncached) insert(identity, aspect, hashes[aspect]);
+        }
+        return nBytesRead;
+    }
+}
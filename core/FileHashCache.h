@@ -0,0 +1,125 @@
+#pragma once
+
+#include "xxhash.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace YAM
+{
+    class FileAspect;
+    class FileAspectHashes;
+    class IPriorityDispatcher;
+
+    // FileHashCache is a persistent cache of file aspect hashes, keyed by
+    // the file system identity of the file and by aspect name and version.
+    // The cache is a memory-mapped file that is shared by all yam processes
+    // of the user on the machine. It avoids rehashing files whose hashes
+    // were computed by another worktree or by a previous yamServer session.
+    //
+    // The cache is a fixed-size hash table, see slotsFor(nFiles) for its
+    // size. Slots are grouped in buckets, inserting in a full bucket
+    // overwrites one of its slots. Each slot is
+    // guarded by a sequence lock: a reader treats a slot that is being 
+    // written as a miss, a writer skips the insertion when another thread
+    // or process is writing the slot.
+    // A process that dies while writing a slot leaves the slot in the
+    // being-written state. Such a slot is no longer used: it is never
+    // found and inserting other keys uses the other slots of its bucket.
+    // The slot is reclaimed when the cache file is recreated, e.g. after
+    // a layout change, see defaultPath(nSlots).
+    //
+    // Class is MT-safe. Concurrent use by multiple processes is safe.
+    //
+    class __declspec(dllexport) FileHashCache
+    {
+    public:
+        // The file system identity of a file. Files with equal identity
+        // are assumed to have equal content.
+        struct Identity {
+            uint64_t device = 0;
+            // The 128-bit file id on Windows, the inode number on POSIX
+            // systems.
+            uint64_t fileIdLow = 0;
+            uint64_t fileIdHigh = 0;
+            uint64_t size = 0;
+            // Last modification and status change times in file system
+            // time units.
+            uint64_t modified = 0;
+            uint64_t changed = 0;
+
+            bool operator==(Identity const& rhs) const = default;
+        };
+
+        // A slot takes 32 bytes, a cache of maxSlots slots takes 512 MB
+        // of (sparse) file and address space.
+        static constexpr std::size_t minSlots = 256 * 1024;
+        static constexpr std::size_t maxSlots = 64 * minSlots;
+
+        // Return the number of slots of a cache for a repository with given
+        // number of files, i.e. the smallest of minSlots, 4*minSlots, ..,
+        // maxSlots that has at least 2 slots per file. Files with multiple
+        // aspects, files in other worktrees and hash collisions within a
+        // bucket make a less sparse table evict hashes that are still used.
+        // Repositories larger than maxSlots/2 files will see evictions.
+        static std::size_t slotsFor(std::size_t nFiles);
+
+        // Return the path of the cache file with given number of slots that
+        // is shared by all yam processes of the user. The file is in a
+        // directory that is only accessible by the user.
+        // The path contains a version number that must be incremented when
+        // the file layout changes.
+        static std::filesystem::path defaultPath(std::size_t nSlots = minSlots);
+
+        // Retrieve the identity of the file at given path.
+        // Return false when the identity cannot be retrieved.
+        static bool identify(std::filesystem::path const& path, Identity& identity);
+
+        // Open, or create when not existing, the cache file with given
+        // number of slots at given path.
+        // On POSIX systems the cache file and its directory must be owned
+        // by the effective user, group and other access is removed.
+        // See good().
+        FileHashCache(std::filesystem::path const& path, std::size_t nSlots = minSlots);
+        ~FileHashCache();
+
+        // Return whether the cache file was successfully opened.
+        // Pre for find and insert: good()
+        bool good() const { return _slots != nullptr; }
+
+        std::size_t nSlots() const { return _nSlots; }
+
+        // Lookup the hash of given aspect of the file with given identity.
+        // Return whether found.
+        bool find(Identity const& identity, FileAspect const& aspect, XXH64_hash_t& hash) const;
+
+        // Store the hash of given aspect of the file with given identity.
+        // Files that changed in the last second are not stored because a
+        // next modification may not change their identity, see
+        // https://git-scm.com/docs/racy-git.
+        void insert(Identity const& identity, FileAspect const& aspect, XXH64_hash_t hash);
+
+        // Like FileAspect::hashFile(path, aspects, hashes, helpers) but
+        // only read the file for the aspects whose hashes are not found in
+        // the cache. Store the computed hashes when the file was read and
+        // did not change while being hashed.
+        // Return the number of bytes read from the file.
+        uint64_t hashFile(
+            std::filesystem::path const& path,
+            std::vector<FileAspect> const& aspects,
+            FileAspectHashes& hashes,
+            IPriorityDispatcher* helpers = nullptr);
+
+    private:
+        struct Slot;
+        struct Mapping;
+
+        std::size_t _nSlots;
+        std::unique_ptr<Mapping> _mapping;
+        Slot* _slots;
+    };
+}
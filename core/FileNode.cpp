@@ -1,5 +1,6 @@
 #include "FileNode.h"
 #include "FileAspect.h"
+#include "FileHashCache.h"
 #include "ExecutionContext.h"
 #include "FileRepositoryNode.h"
 #include "ExecutionContext.h"
@@ -28,45 +29,40 @@ namespace YAM
         Node::start(prio);
         context()->statistics().registerSelfExecuted(this);
         auto d = Delegate<void>::CreateLambda([this]() {execute(); });
-        context()->threadPoolQueue().push(std::move(d), prio);
+        context()->ioQueue().push(std::move(d), prio);
     }
 
     void FileNode::execute() {
-        auto newState = Node::State::Ok;
-        std::map<std::string, XXH64_hash_t> newHashes;
-        auto lwt = _lastWriteTime;
-        auto newLastWriteTime = retrieveLastWriteTime();
-        if (newLastWriteTime != _lastWriteTime) {
+        _newState = Node::State::Ok;
+        _newHashes = FileAspectHashes();
+        _newLastWriteTime = retrieveLastWriteTime();
+        if (_newLastWriteTime != _lastWriteTime) {
             std::vector<FileAspect> aspects = context()->findFileAspects(name());
-            for (auto const& aspect : aspects) {
-                newHashes[aspect.name()] = aspect.hash(absolutePath());
-            }
+            std::filesystem::path path = absolutePath();
+            auto const& cache = context()->fileHashCache();
+            uint64_t nBytes = cache != nullptr
+                ? cache->hashFile(path, aspects, _newHashes, &context()->ioQueue())
+                : FileAspect::hashFile(path, aspects, _newHashes, &context()->ioQueue());
+            context()->statistics().registerRehashedBytes(nBytes);
             auto lastWriteTime = retrieveLastWriteTime();
-            if (lastWriteTime != newLastWriteTime) {
+            if (lastWriteTime != _newLastWriteTime) {
                 // file was modified while being hashed.
-                newState = Node::State::Failed;
-                for (auto const& pair : newHashes) {
-                    newHashes[pair.first] = rand();
-                }
+                _newState = Node::State::Failed;
+                _newHashes.randomize();
             }
         }
-        auto d = Delegate<void>::CreateLambda(
-            [this, newState, newLastWriteTime, newHashes]() {
-                finish(newState, newLastWriteTime, newHashes);
-            });
+        // The results are members, not captures, to fit the delegate in
+        // its inline buffer.
+        auto d = Delegate<void>::CreateLambda([this]() { finish(); });
         context()->mainThreadQueue().push(std::move(d));
     }
        
-    void FileNode::finish(
-        Node::State newState,
-        std::chrono::time_point<std::chrono::utc_clock> const& newLastWriteTime,
-        std::map<std::string, XXH64_hash_t> const& newHashes
-    ) {
-        if (newState == Node::State::Ok) {
-            if (newLastWriteTime != _lastWriteTime) {
-                _lastWriteTime = newLastWriteTime;
-                bool changedContent = _hashes != newHashes;
-                _hashes = newHashes;
+    void FileNode::finish() {
+        if (_newState == Node::State::Ok) {
+            if (_newLastWriteTime != _lastWriteTime) {
+                _lastWriteTime = _newLastWriteTime;
+                bool changedContent = _hashes != _newHashes;
+                _hashes = _newHashes;
                 modified(true);
                 if (changedContent) {
                     std::stringstream ss;
@@ -83,14 +79,13 @@ namespace YAM
             LogRecord error(LogRecord::Error, ss.str());
             context()->logBook()->add(error);
         }
-        Node::notifyCompletion(newState);
+        Node::notifyCompletion(_newState);
     }
 
-    XXH64_hash_t FileNode::hashOf(std::string const& aspectName) {
+    XXH64_hash_t FileNode::hashOf(FileAspect const& aspect) {
         if (state() == Node::State::Deleted) return rand();
-        auto it = _hashes.find(aspectName);
-        if (it == _hashes.end()) throw std::runtime_error("no such aspect");
-        return it->second;
+        if (!_hashes.contains(aspect)) throw std::runtime_error("no such aspect");
+        return _hashes[aspect];
     }
 
     void FileNode::setStreamableType(uint32_t type) {
@@ -104,6 +99,20 @@ namespace YAM
     void FileNode::stream(IStreamer* streamer) {
         Node::stream(streamer);
         streamer->stream(_lastWriteTime);
-        streamer->streamMap(_hashes);
+        if (streamer->writing()) {
+            // Hashes are stored by build state aspect index, see restore().
+            FileAspectHashes stored;
+            context()->fileAspectIndexMap().store(_hashes, stored);
+            stored.stream(streamer);
+        } else {
+            _hashes.stream(streamer);
+        }
+    }
+
+    bool FileNode::restore(void* context, std::unordered_set<IPersistable const*>& restored) {
+        if (!Node::restore(context, restored)) return false;
+        FileAspectHashes stored = _hashes;
+        this->context()->fileAspectIndexMap().retrieve(stored, _hashes);
+        return true;
     }
 }
\ No newline at end of file
@@ -105,24 +105,29 @@ namespace YAM
         // Pre: state() == State::Ok
         // Return the cached hash of given aspect.
         // Throw exception when aspect is unknown.
-        XXH64_hash_t hashOf(std::string const& aspectName);
+        XXH64_hash_t hashOf(FileAspect const& aspect);
+
+        // Return the cached hashes of the aspects of the file.
+        FileAspectHashes const& hashes() const { return _hashes; }
 
         static void setStreamableType(uint32_t type);
         // Inherited from IStreamable
         uint32_t typeId() const override;
         void stream(IStreamer* streamer) override;
+        // Inherited from IPersistable
+        bool restore(void* context, std::unordered_set<IPersistable const*>& restored) override;
 
     private:
         std::chrono::time_point<std::chrono::utc_clock> retrieveLastWriteTime() const;
         void execute();
-        void finish(
-            Node::State newState,
-            std::chrono::time_point<std::chrono::utc_clock> const& newLastWriteTime,
-            std::map<std::string, XXH64_hash_t> const& newHashes);
+        void finish();
 
         std::chrono::utc_clock::time_point _lastWriteTime;
-        // file aspect name => file aspect hash
-        std::map<std::string, XXH64_hash_t> _hashes;
+        FileAspectHashes _hashes;
+        // The results of execute(), accessed by finish() in main thread.
+        Node::State _newState = Node::State::Ok;
+        std::chrono::utc_clock::time_point _newLastWriteTime;
+        FileAspectHashes _newHashes;
     };
 }
 
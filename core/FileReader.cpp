@@ -0,0 +1,182 @@
+#include "FileReader.h"
+
+#include <memory>
+#include <new>
+
+#if defined( _WIN32 )
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    using namespace YAM;
+
+    const std::size_t pageSize = 4096;
+
+    // Page-aligned buffer of FileReader::mapThreshold bytes, allocated
+    // once per thread.
+    class ReadBuffer {
+    public:
+        ReadBuffer()
+            : _data(static_cast<char*>(::operator new(FileReader::mapThreshold, std::align_val_t(pageSize))))
+        {}
+        ~ReadBuffer() { ::operator delete(_data, std::align_val_t(pageSize)); }
+        char* data() const { return _data; }
+    private:
+        char* _data;
+    };
+
+    char* threadBuffer() {
+        thread_local ReadBuffer buffer;
+        return buffer.data();
+    }
+
+#if defined( _WIN32 )
+    class FileHandle {
+    public:
+        FileHandle(HANDLE handle) : _handle(handle) {}
+        ~FileHandle() { if (valid()) CloseHandle(_handle); }
+        bool valid() const { return _handle != NULL && _handle != INVALID_HANDLE_VALUE; }
+        HANDLE get() const { return _handle; }
+    private:
+        HANDLE _handle;
+    };
+
+    // Files larger than mapThreshold are read in a heap buffer.
+    bool readBuffered(HANDLE file, std::size_t size, Delegate<void, std::string_view> const& consumer) {
+        const std::size_t maxReadSize = 1024 * 1024 * 1024;
+        std::unique_ptr<char[]> heapBuffer;
+        if (size > FileReader::mapThreshold) heapBuffer = std::make_unique_for_overwrite<char[]>(size);
+        char* buffer = heapBuffer != nullptr ? heapBuffer.get() : threadBuffer();
+        std::size_t nRead = 0;
+        while (nRead < size) {
+            DWORD n = 0;
+            std::size_t remaining = size - nRead;
+            DWORD toRead = static_cast<DWORD>(remaining < maxReadSize ? remaining : maxReadSize);
+            if (!ReadFile(file, buffer + nRead, toRead, &n, NULL)) return false;
+            if (n == 0) break;
+            nRead += n;
+        }
+        consumer.Execute(std::string_view(buffer, nRead));
+        return true;
+    }
+
+    // Return whether file is on a network share. An I/O error on a mapped
+    // page raises EXCEPTION_IN_PAGE_ERROR, network failures make such
+    // errors likely.
+    bool isRemote(HANDLE file) {
+        FILE_REMOTE_PROTOCOL_INFO info;
+        return GetFileInformationByHandleEx(file, FileRemoteProtocolInfo, &info, sizeof(info)) != 0;
+    }
+
+    // The mapping has the given size: creating it fails when the file
+    // shrunk below size after its size was retrieved. While mapped, the
+    // file cannot be truncated (SetEndOfFile fails with
+    // ERROR_USER_MAPPED_FILE).
+    // EXCEPTION_IN_PAGE_ERROR is not handled: the consumer may access the
+    // view from helper threads, see TreeHash, hence the view cannot be
+    // safely unmapped after the exception. The exception terminates the
+    // process.
+    bool readMapped(HANDLE file, std::size_t size, Delegate<void, std::string_view> const& consumer) {
+        uint64_t size64 = static_cast<uint64_t>(size);
+        FileHandle mapping(CreateFileMappingW(
+            file, NULL, PAGE_READONLY,
+            static_cast<DWORD>(size64 >> 32), static_cast<DWORD>(size64 & 0xFFFFFFFF),
+            NULL));
+        if (!mapping.valid()) return false;
+        void const* view = MapViewOfFile(mapping.get(), FILE_MAP_READ, 0, 0, size);
+        if (view == nullptr) return false;
+        consumer.Execute(std::string_view(static_cast<char const*>(view), size));
+        UnmapViewOfFile(view);
+        return true;
+    }
+
+    bool readFile(std::filesystem::path const& path, Delegate<void, std::string_view> const& consumer) {
+        FileHandle file(CreateFileW(
+            path.wstring().c_str(),
+            GENERIC_READ,
+            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            NULL,
+            OPEN_EXISTING,
+            FILE_FLAG_SEQUENTIAL_SCAN,
+            NULL));
+        if (!file.valid()) return false;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file.get(), &fileSize)) return false;
+        uint64_t size = static_cast<uint64_t>(fileSize.QuadPart);
+        if (size > SIZE_MAX) return false;
+        if (size <= FileReader::mapThreshold || isRemote(file.get())) {
+            return readBuffered(file.get(), static_cast<std::size_t>(size), consumer);
+        }
+        return readMapped(file.get(), static_cast<std::size_t>(size), consumer);
+    }
+#else
+    class FileDescriptor {
+    public:
+        FileDescriptor(int fd) : _fd(fd) {}
+        ~FileDescriptor() { if (valid()) close(_fd); }
+        bool valid() const { return _fd >= 0; }
+        int get() const { return _fd; }
+    private:
+        int _fd;
+    };
+
+    bool readBuffered(int fd, std::size_t size, Delegate<void, std::string_view> const& consumer) {
+        char* buffer = threadBuffer();
+        std::size_t nRead = 0;
+        while (nRead < size) {
+            ssize_t n = pread(fd, buffer + nRead, size - nRead, static_cast<off_t>(nRead));
+            if (n < 0) return false;
+            if (n == 0) break;
+            nRead += static_cast<std::size_t>(n);
+        }
+        consumer.Execute(std::string_view(buffer, nRead));
+        return true;
+    }
+
+    // Truncating the file while it is mapped, or an I/O error, makes access
+    // to the affected pages raise SIGBUS. SIGBUS is not handled for the
+    // same reason as EXCEPTION_IN_PAGE_ERROR on Windows: the consumer may
+    // access the view from helper threads. The signal terminates the
+    // process.
+    bool readMapped(int fd, std::size_t size, Delegate<void, std::string_view> const& consumer) {
+        void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (view == MAP_FAILED) return false;
+        madvise(view, size, MADV_SEQUENTIAL);
+        consumer.Execute(std::string_view(static_cast<char const*>(view), size));
+        munmap(view, size);
+        // Small files are not released: they are typically sources and
+        // headers that are about to be read by a compiler.
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        return true;
+    }
+
+    bool readFile(std::filesystem::path const& path, Delegate<void, std::string_view> const& consumer) {
+        FileDescriptor fd(open(path.c_str(), O_RDONLY | O_CLOEXEC));
+        if (!fd.valid()) return false;
+        struct stat status;
+        if (fstat(fd.get(), &status) != 0 || !S_ISREG(status.st_mode)) return false;
+        std::size_t size = static_cast<std::size_t>(status.st_size);
+        if (size <= FileReader::mapThreshold) {
+            return readBuffered(fd.get(), size, consumer);
+        }
+        return readMapped(fd.get(), size, consumer);
+    }
+#endif
+}
+
+namespace YAM
+{
+    bool FileReader::read(
+        std::filesystem::path const& path,
+        Delegate<void, std::string_view> const& consumer
+    ) {
+        return readFile(path, consumer);
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Delegates.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+namespace YAM
+{
+    // FileReader makes the entire content of a file available in memory
+    // with as few system calls as possible.
+    // Files up to mapThreshold bytes are read with a single read call into
+    // a page-aligned buffer that is re-used by all reads in the calling
+    // thread. Larger files are memory mapped for sequential access. On
+    // POSIX systems their pages are released from the page cache after
+    // reading to avoid evicting the working set of concurrently running
+    // compilers. Windows has no such release, unmapped pages move to the
+    // standby list from where they are re-used first.
+    //
+    // An I/O error while reading a mapped file terminates the process, on
+    // POSIX systems so does truncating the file while it is read. Windows
+    // prevents truncation of mapped files and files on network shares are
+    // read in memory instead of mapped.
+    //
+    // Class is MT-safe.
+    //
+    class __declspec(dllexport) FileReader
+    {
+    public:
+        static constexpr std::size_t mapThreshold = 1024 * 1024;
+
+        // Call consumer with the content of the file at given path.
+        // The content is only valid during the call.
+        // Return false, without calling consumer, when the file cannot
+        // be opened or read.
+        static bool read(
+            std::filesystem::path const& path,
+            Delegate<void, std::string_view> const& consumer);
+    };
+}
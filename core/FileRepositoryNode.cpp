@@ -93,7 +93,7 @@ namespace YAM
             _type = newType;
             if (_type != RepoType::Ignore) {
                 if (_directoryNode == nullptr) {
-                    _directoryNode = std::make_shared<DirectoryNode>(context(), symbolicDirectory(), nullptr);
+                    _directoryNode = makeShared<DirectoryNode>(context(), symbolicDirectory(), nullptr);
                     _fileExecSpecsNode = std::make_shared<FileExecSpecsNode>(context(), symbolicDirectory());
                     context()->nodes().add(_directoryNode);
                     context()->nodes().add(_fileExecSpecsNode);
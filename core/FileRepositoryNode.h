@@ -298,6 +298,7 @@ namespace YAM
         // Inherited from Node
         void start(PriorityClass prio) override;
         std::string className() const override { return "FileRepositoryNode"; }
+        NodeKind kind() const override { return NodeKind::FileRepository; }
 
         static void setStreamableType(uint32_t type);
         // Inherited from IStreamer (via IPersistable)
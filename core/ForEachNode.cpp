@@ -198,6 +198,17 @@ namespace YAM
         return _script;
     }
 
+    void ForEachNode::resourceClaim(ResourceClaim const& claim) {
+        if (!(claim == _resourceClaim)) {
+            _resourceClaim = claim;
+            modified(true);
+            setState(State::Dirty);
+        }
+    }
+    ResourceClaim const& ForEachNode::resourceClaim() const {
+        return _resourceClaim;
+    }
+
     void ForEachNode::workingDirectory(std::shared_ptr<DirectoryNode> const& dir) {
         if (_workingDir.lock() != dir) {
             _workingDir = dir;
@@ -255,6 +266,7 @@ namespace YAM
         addHashes(_cmdInputs, hashes);
         addHashes(_orderOnlyInputs, hashes);
         _outputs.addHashes(hashes);
+        hashes.push_back(_resourceClaim.hash());
         XXH64_hash_t hash = XXH64(hashes.data(), sizeof(XXH64_hash_t) * hashes.size(), 0);
         return hash;
     }
@@ -389,6 +401,8 @@ namespace YAM
         auto& outputs = rule->outputs.outputs;
         outputs.insert(outputs.end(), _outputs.outputs.begin(), _outputs.outputs.end());
 
+        rule->resources = _resourceClaim;
+
         return rule;
     }
 
@@ -433,6 +447,7 @@ namespace YAM
         if (streamer->reading()) _workingDir = wdir;
         streamer->stream(_script);
         _outputs.stream(streamer);
+        _resourceClaim.stream(streamer);
         streamer->streamVector(_commands);
         streamer->stream(_executionHash);
     }
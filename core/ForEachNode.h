@@ -59,6 +59,7 @@ namespace YAM
         ~ForEachNode();
 
         std::string className() const override { return "ForEachNode"; }
+        NodeKind kind() const override { return NodeKind::ForEach; }
 
         // Pre: newInputs contains SourceFileNode and/or GeneratedFileNode
         // and/or GroupNode instances.
@@ -79,6 +80,10 @@ namespace YAM
         void outputs(BuildFile::Outputs const& outputs);
         BuildFile::Outputs const& outputs() const;
 
+        // Set/get the resource claim of the commands, see CommandNode.
+        void resourceClaim(ResourceClaim const& claim);
+        ResourceClaim const& resourceClaim() const;
+
         // The directory in which the script will be executed.
         // The repository root directory when nullptr.
         void workingDirectory(std::shared_ptr<DirectoryNode> const& dir);
@@ -123,6 +128,7 @@ namespace YAM
         std::weak_ptr<DirectoryNode> _workingDir;
         std::string _script;
         BuildFile::Outputs _outputs;
+        ResourceClaim _resourceClaim;
 
         // the group nodes in _cmdInputs
         std::vector<std::shared_ptr<GroupNode>> _inputGroups;
@@ -133,6 +139,7 @@ namespace YAM
         //    - groups in _cmdInputs and _orderOnlyInputs
         //    - _script, 
         //    - _outputs 
+        //    - _resourceClaim
         //    - _workingDir name
         XXH64_hash_t _executionHash;
     };
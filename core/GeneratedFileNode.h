@@ -19,6 +19,7 @@ namespace YAM
             std::shared_ptr<CommandNode> const& producer);
 
         std::string className() const override { return "GeneratedFileNode"; }
+        NodeKind kind() const override { return NodeKind::GeneratedFile; }
 
         std::shared_ptr<CommandNode> producer() const;
 
@@ -102,7 +102,7 @@ namespace YAM
             auto d = Delegate<void>::CreateLambda(
                 [this]() { executeGlob(); }
             );
-            context()->threadPoolQueue().push(std::move(d), PriorityClass::High);
+            context()->ioQueue().push(std::move(d), PriorityClass::High);
         }
     }
 
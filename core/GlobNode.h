@@ -25,6 +25,7 @@ namespace YAM
         ~GlobNode();
 
         std::string className() const override { return "GlobNode"; }
+        NodeKind kind() const override { return NodeKind::Glob; }
 
         void baseDirectory(std::shared_ptr<DirectoryNode> const& newBaseDir);
         std::shared_ptr<DirectoryNode> const& baseDirectory() const { return _baseDir;  }
@@ -0,0 +1,213 @@
+#include "GraphSnapshot.h"
+#include "ExecutionContext.h"
+#include "FileNode.h"
+#include "CommandNode.h"
+#include "DirectoryNode.h"
+#include "GlobNode.h"
+#include "ForEachNode.h"
+#include "GroupNode.h"
+#include "DotIgnoreNode.h"
+#include "FileRepositoryNode.h"
+#include "RepositoriesNode.h"
+#include "BuildFileParserNode.h"
+#include "BuildFileCompilerNode.h"
+#include "FileExecSpecsNode.h"
+
+#include <algorithm>
+
+namespace
+{
+    using namespace YAM;
+
+    XXH64_hash_t hashOf(Node* node) {
+        if (node->state() != Node::State::Ok) return 0;
+        switch (node->kind()) {
+        case NodeKind::SourceFile:
+        case NodeKind::GeneratedFile: {
+            FileAspectHashes const& hashes = static_cast<FileNode*>(node)->hashes();
+            FileAspect const& entireFile = FileAspect::entireFileAspect();
+            return hashes.contains(entireFile) ? hashes[entireFile] : 0;
+        }
+        case NodeKind::Command: return static_cast<CommandNode*>(node)->executionHash();
+        case NodeKind::Directory: return static_cast<DirectoryNode*>(node)->executionHash();
+        case NodeKind::Glob: return static_cast<GlobNode*>(node)->executionHash();
+        case NodeKind::ForEach: return static_cast<ForEachNode*>(node)->executionHash();
+        case NodeKind::BuildFileParser: return static_cast<BuildFileParserNode*>(node)->executionHash();
+        case NodeKind::BuildFileCompiler: return static_cast<BuildFileCompilerNode*>(node)->executionHash();
+        case NodeKind::FileExecSpecs: return static_cast<FileExecSpecsNode*>(node)->executionHash();
+        case NodeKind::Group: return static_cast<GroupNode*>(node)->hash();
+        case NodeKind::DotIgnore: return static_cast<DotIgnoreNode*>(node)->hash();
+        case NodeKind::FileRepository: return static_cast<FileRepositoryNode*>(node)->hash();
+        case NodeKind::Repositories: return static_cast<RepositoriesNode*>(node)->hash();
+        default: return 0;
+        }
+    }
+
+    void appendNameIds(std::vector<std::shared_ptr<Node>> const& nodes, std::vector<PathInterner::Id>& ids) {
+        ids.reserve(nodes.size());
+        for (auto const& node : nodes) ids.push_back(node->nameId());
+    }
+}
+
+namespace YAM
+{
+    // Adds, replaces and removes the node snapshots of a snapshot under
+    // construction. A shard that is shared with the previous snapshot is
+    // copied before its first modification.
+    class GraphSnapshot::Writer
+    {
+    public:
+        // Node snapshots that did not change since 'previous' (may be
+        // nullptr) are shared with 'previous'.
+        Writer(GraphSnapshot& snapshot, std::shared_ptr<const GraphSnapshot> const& previous)
+            : _snapshot(snapshot)
+            , _previous(previous)
+            , _owned(nShards, nullptr)
+        {}
+
+        void take(Node* node) {
+            PathInterner::Id nameId = node->nameId();
+            _kind = node->kind();
+            _state = node->state();
+            _hash = hashOf(node);
+            _inputs.clear();
+            _neighbors.clear();
+            node->getInputs(_neighbors);
+            appendNameIds(_neighbors, _inputs);
+            _outputs.clear();
+            _neighbors.clear();
+            node->getOutputs(_neighbors);
+            appendNameIds(_neighbors, _outputs);
+            std::shared_ptr<const NodeSnapshot> current = _snapshot.find(nameId);
+            if (unchanged(current)) return;
+            std::shared_ptr<const NodeSnapshot> previous =
+                _previous == nullptr ? nullptr : _previous->find(nameId);
+            if (!unchanged(previous)) {
+                previous = std::make_shared<const NodeSnapshot>(
+                    NodeSnapshot{ nameId, _kind, _state, _hash, _inputs, _outputs });
+            }
+            if (writable(nameId).insert_or_assign(nameId, previous).second) _snapshot._size += 1;
+        }
+
+        void remove(PathInterner::Id nameId) {
+            if (_snapshot.find(nameId) == nullptr) return;
+            writable(nameId).erase(nameId);
+            _snapshot._size -= 1;
+        }
+
+        // Repositories are not in context->nodes().
+        void takeRepositories(ExecutionContext* context) {
+            std::vector<PathInterner::Id>& ids = _snapshot._repositories;
+            ids.clear();
+            if (context->repositoriesNode() != nullptr) {
+                take(context->repositoriesNode().get());
+                ids.push_back(context->repositoriesNode()->nameId());
+            }
+            for (auto const& pair : context->repositories()) {
+                take(pair.second.get());
+                ids.push_back(pair.second->nameId());
+            }
+        }
+
+    private:
+        bool unchanged(std::shared_ptr<const NodeSnapshot> const& snapshot) const {
+            return
+                snapshot != nullptr
+                && snapshot->kind == _kind
+                && snapshot->state == _state
+                && snapshot->hash == _hash
+                && snapshot->inputs == _inputs
+                && snapshot->outputs == _outputs;
+        }
+
+        Nodes& writable(PathInterner::Id nameId) {
+            std::size_t index = nameId % nShards;
+            if (_owned[index] == nullptr) {
+                std::shared_ptr<const Nodes> const& shared = _snapshot._shards[index];
+                auto shard = shared == nullptr ? std::make_shared<Nodes>() : std::make_shared<Nodes>(*shared);
+                _owned[index] = shard.get();
+                _snapshot._shards[index] = shard;
+            }
+            return *_owned[index];
+        }
+
+        GraphSnapshot& _snapshot;
+        std::shared_ptr<const GraphSnapshot> _previous;
+        // The shards that were copied or created by this writer.
+        std::vector<Nodes*> _owned;
+
+        // The state of the node being taken. Copied to a new NodeSnapshot
+        // only when the node changed since the previous snapshot.
+        NodeKind _kind = NodeKind::Other;
+        Node::State _state = Node::State::Dirty;
+        XXH64_hash_t _hash = 0;
+        std::vector<PathInterner::Id> _inputs;
+        std::vector<PathInterner::Id> _outputs;
+        std::vector<std::shared_ptr<Node>> _neighbors;
+    };
+
+    GraphSnapshot::GraphSnapshot() 
+        : _epoch(0)
+        , _size(0)
+        , _shards(nShards)
+    {}
+
+    GraphSnapshot::GraphSnapshot(
+        ExecutionContext* context,
+        std::shared_ptr<const GraphSnapshot> const& previous,
+        uint64_t epoch
+    ) 
+        : _epoch(epoch)
+        , _size(0)
+        , _shards(nShards)
+    {
+        Writer writer(*this, previous);
+        auto takeNode = Delegate<void, std::shared_ptr<Node> const&>::CreateLambda(
+            [&writer](std::shared_ptr<Node> const& node) { writer.take(node.get()); });
+        context->nodes().foreach(takeNode);
+        writer.takeRepositories(context);
+    }
+
+    GraphSnapshot::GraphSnapshot(
+        ExecutionContext* context,
+        std::shared_ptr<const GraphSnapshot> const& previous,
+        std::unordered_set<PathInterner::Id> const& changed,
+        uint64_t epoch
+    )
+        : _epoch(epoch)
+        , _size(previous->_size)
+        , _shards(previous->_shards)
+    {
+        Writer writer(*this, previous);
+        for (PathInterner::Id nameId : changed) {
+            std::shared_ptr<Node> node = context->nodes().find(nameId);
+            if (node == nullptr) writer.remove(nameId);
+            else writer.take(node.get());
+        }
+        writer.takeRepositories(context);
+        for (PathInterner::Id nameId : previous->_repositories) {
+            bool isRepository = std::find(_repositories.begin(), _repositories.end(), nameId) != _repositories.end();
+            if (!isRepository && context->nodes().find(nameId) == nullptr) writer.remove(nameId);
+        }
+    }
+
+    void GraphSnapshot::foreach(Delegate<void, std::shared_ptr<const NodeSnapshot> const&> action) const {
+        for (auto const& shard : _shards) {
+            if (shard == nullptr) continue;
+            for (auto const& pair : *shard) action.Execute(pair.second);
+        }
+    }
+
+    std::shared_ptr<const NodeSnapshot> GraphSnapshot::find(PathInterner::Id nameId) const {
+        std::shared_ptr<const Nodes> const& shard = _shards[nameId % nShards];
+        if (shard == nullptr) return nullptr;
+        auto it = shard->find(nameId);
+        return it == shard->end() ? nullptr : it->second;
+    }
+
+    std::shared_ptr<const NodeSnapshot> GraphSnapshot::find(std::filesystem::path const& name) const {
+        PathInterner::Id nameId = PathInterner::names().find(name);
+        if (nameId == PathInterner::invalidId) return nullptr;
+        return find(nameId);
+    }
+}
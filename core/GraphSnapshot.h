@@ -0,0 +1,120 @@
+#pragma once
+
+#include "Node.h"
+#include "Delegates.h"
+#include "NodeKind.h"
+#include "PathInterner.h"
+#include "xxhash.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace YAM
+{
+    class ExecutionContext;
+
+    // The state of a node at the time a GraphSnapshot was taken.
+    // Inputs and outputs are the name ids of the nodes returned by
+    // Node::getInputs(..) and Node::getOutputs(..).
+    // hash is the hash that summarizes the last execution of the node:
+    //     - entire file hash for source and generated files
+    //     - execution hash for commands, directories, globs, foreach,
+    //       buildfile parsers, buildfile compilers and exec specs
+    //     - hash for groups, dotignores and repositories
+    // hash is 0 when the node is not in state Ok.
+    struct __declspec(dllexport) NodeSnapshot
+    {
+        PathInterner::Id nameId;
+        NodeKind kind;
+        Node::State state;
+        XXH64_hash_t hash;
+        std::vector<PathInterner::Id> inputs;
+        std::vector<PathInterner::Id> outputs;
+
+        std::filesystem::path const& name() const {
+            return PathInterner::names().path(nameId);
+        }
+
+        bool operator==(NodeSnapshot const& rhs) const = default;
+    };
+
+    // A GraphSnapshot is an immutable copy of the state, name, inputs,
+    // outputs and hash of the nodes in an ExecutionContext.
+    // Snapshots are taken in ExecutionContext::mainThread(), see
+    // ExecutionContext::publishSnapshot(), and can be queried in any thread
+    // while the build modifies the nodes. E.g. the Builder creates the
+    // DependencyIndex, used by 'yam query', from the snapshot in an io
+    // thread and the BuildService answers NodeStatusRequests from the
+    // snapshot in its service thread.
+    //
+    // The node snapshots are stored in a copy-on-write map: a fixed number
+    // of shards, each shard a hash map. A snapshot that is taken from a 
+    // previous snapshot and the set of changed nodes only visits the
+    // changed nodes and only copies the shards that contain them. The
+    // other shards, and the node snapshots of unchanged nodes, are shared
+    // with the previous snapshot.
+    //
+    // Class is MT-safe: a snapshot is never modified after construction.
+    //
+    class __declspec(dllexport) GraphSnapshot
+    {
+    public:
+        typedef std::unordered_map<PathInterner::Id, std::shared_ptr<const NodeSnapshot>> Nodes;
+
+        // Construct the empty snapshot with epoch 0.
+        GraphSnapshot();
+
+        // Take a snapshot of all nodes in context->nodes() and of the
+        // repositories in context.
+        // Share unchanged node snapshots with 'previous' (may be nullptr).
+        // Pre: called in context->mainThread()
+        GraphSnapshot(
+            ExecutionContext* context,
+            std::shared_ptr<const GraphSnapshot> const& previous,
+            uint64_t epoch);
+
+        // Take a snapshot that equals 'previous' updated with the nodes
+        // whose name ids are in 'changed': nodes that are no longer in
+        // context->nodes() are removed, the others are (re-)taken. The
+        // repositories in context are always re-taken.
+        // Pre: called in context->mainThread()
+        // Pre: 'changed' contains the nodes that were added, removed or 
+        // changed since 'previous' was taken, see NodeSet::snapshotChanges().
+        GraphSnapshot(
+            ExecutionContext* context,
+            std::shared_ptr<const GraphSnapshot> const& previous,
+            std::unordered_set<PathInterner::Id> const& changed,
+            uint64_t epoch);
+
+        // Return the sequence number of the snapshot. A snapshot with a
+        // larger epoch was taken later.
+        uint64_t epoch() const { return _epoch; }
+
+        std::size_t size() const { return _size; }
+
+        // Execute action on each node snapshot, in unspecified order.
+        void foreach(Delegate<void, std::shared_ptr<const NodeSnapshot> const&> action) const;
+
+        // Return the snapshot of the node with given name (id), nullptr when
+        // not found.
+        std::shared_ptr<const NodeSnapshot> find(PathInterner::Id nameId) const;
+        std::shared_ptr<const NodeSnapshot> find(std::filesystem::path const& name) const;
+
+    private:
+        static constexpr std::size_t nShards = 1024;
+
+        class Writer;
+
+        uint64_t _epoch;
+        std::size_t _size;
+        // A shard is nullptr when empty. Node with name id is in shard 
+        // id % nShards.
+        std::vector<std::shared_ptr<const Nodes>> _shards;
+        // The name ids of the repositories.
+        std::vector<PathInterner::Id> _repositories;
+    };
+}
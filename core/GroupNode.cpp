@@ -24,17 +24,22 @@ namespace
 
 namespace YAM
 {
-    GroupNode::GroupNode() : Node(), _hash(rand()) {}
+    GroupNode::GroupNode() : Node(), _contentHash(0), _hash(rand()) {}
     GroupNode::GroupNode(ExecutionContext* context, std::filesystem::path const& name)
         : Node(context, name)
+        , _contentHash(0)
         , _hash(rand())
     {}
 
     void GroupNode::content(std::vector<std::shared_ptr<Node>> newContent) {
         for (auto const& node : _content) unsubscribe(node);
         _content.clear();
+        resetMemberHashes();
         _content.insert(newContent.begin(), newContent.end());
-        for (auto const& node : _content) subscribe(node);
+        for (auto const& node : _content) {
+            subscribe(node);
+            addMemberHash(node.get());
+        }
         modified(true);
         setState(Node::State::Dirty);
     }
@@ -43,6 +48,7 @@ namespace YAM
         auto result = _content.insert(node);
         if (!result.second) throw std::runtime_error("Attempt to add duplicate");
         subscribe(node);
+        addMemberHash(node.get());
         modified(true);
         setState(Node::State::Dirty);
     }
@@ -54,6 +60,7 @@ namespace YAM
         }
         _content.erase(it);
         unsubscribe(node);
+        removeMemberHash(node.get());
         modified(true);
         setState(Node::State::Dirty);
     }
@@ -64,6 +71,7 @@ namespace YAM
             if (*it != node) throw std::runtime_error("Attempt to remove unknown node");
             _content.erase(it);
             unsubscribe(node);
+            removeMemberHash(node.get());
             modified(true);
             setState(Node::State::Dirty);
             return true;
@@ -113,10 +121,16 @@ namespace YAM
         startNodes(requisites, std::move(callback), prio);
     }
 
+    void GroupNode::handleDirtyOf(Node* observedNode) {
+        if (_commandHashes.contains(observedNode)) _staleCommands.insert(observedNode);
+        Node::handleDirtyOf(observedNode);
+    }
+
     void GroupNode::handleGroupCompletion(Node::State groupState) {
         context()->statistics().registerSelfExecuted(this);
         if (groupState == Node::State::Ok) {
             XXH64_hash_t prevHash = _hash;
+            updateStaleMemberHashes();
             _hash = computeHash();
             if (prevHash != _hash) modified(true);
             if (prevHash != _hash && context()->logBook()->mustLogAspect(LogRecord::Aspect::DirectoryChanges)) {
@@ -129,22 +143,61 @@ namespace YAM
         Node::notifyCompletion(groupState);
     }
 
-    XXH64_hash_t GroupNode::computeHash() const {
-        std::vector<XXH64_hash_t> hashes;
-        for (auto const& n : _content) {
-            hashes.push_back(XXH64_string(n->name().string()));
-            auto const& cmd = dynamic_pointer_cast<CommandNode>(n);
-            if (cmd != nullptr) {
-                std::vector<std::shared_ptr<GeneratedFileNode>> outputs = cmd->detectedOutputs();
-                for (auto const& n : outputs) {
-                    hashes.push_back(XXH64_string(n->name().string()));
-                }
-            } else {
-                //TODO: add ForEachNode
-            }
+    // The member hash of a node is the hash of its name. The member hash 
+    // of a command also covers the names of its detected outputs.
+    XXH64_hash_t GroupNode::memberHash(Node* node) const {
+        XXH64_hash_t nameHash = XXH64_string(node->name().string());
+        if (node->kind() != NodeKind::Command) return nameHash;
+        std::vector<XXH64_hash_t> hashes({ nameHash });
+        for (auto const& output : static_cast<CommandNode*>(node)->detectedOutputs()) {
+            hashes.push_back(XXH64_string(output->name().string()));
+        }
+        //TODO: add ForEachNode
+        return XXH64(hashes.data(), sizeof(XXH64_hash_t) * hashes.size(), 0);
+    }
+
+    void GroupNode::addMemberHash(Node* node) {
+        XXH64_hash_t hash = memberHash(node);
+        _contentHash += hash;
+        if (node->kind() == NodeKind::Command) {
+            _commandHashes[node] = hash;
+            // The detected outputs of a command that is not Ok may change 
+            // without the command becoming Dirty again.
+            if (node->state() != Node::State::Ok) _staleCommands.insert(node);
         }
-        XXH64_hash_t hash = XXH64(hashes.data(), sizeof(XXH64_hash_t) * hashes.size(), 0);
-        return hash;
+    }
+
+    void GroupNode::removeMemberHash(Node* node) {
+        auto it = _commandHashes.find(node);
+        if (it != _commandHashes.end()) {
+            _contentHash -= it->second;
+            _commandHashes.erase(it);
+            _staleCommands.erase(node);
+        } else {
+            _contentHash -= memberHash(node);
+        }
+    }
+
+    void GroupNode::resetMemberHashes() {
+        _contentHash = 0;
+        _commandHashes.clear();
+        _staleCommands.clear();
+    }
+
+    void GroupNode::updateStaleMemberHashes() {
+        for (Node* node : _staleCommands) {
+            auto it = _commandHashes.find(node);
+            if (it == _commandHashes.end()) throw std::runtime_error("corrupt _staleCommands");
+            _contentHash -= it->second;
+            it->second = memberHash(node);
+            _contentHash += it->second;
+        }
+        _staleCommands.clear();
+    }
+
+    XXH64_hash_t GroupNode::computeHash() const {
+        XXH64_hash_t hashes[2] = { _contentHash, static_cast<XXH64_hash_t>(_content.size()) };
+        return XXH64(hashes, sizeof(hashes), 0);
     }
 
     void GroupNode::subscribe(std::shared_ptr<Node> const& node) {
@@ -200,6 +253,7 @@ namespace YAM
         for (auto const& node: _content) unsubscribe(node);
         _content.clear();
         _contentVec.clear();
+        resetMemberHashes();
     }
 
     bool GroupNode::restore(void* context, std::unordered_set<IPersistable const*>& restored)  {
@@ -207,7 +261,10 @@ namespace YAM
         for (auto const& node : _contentVec) node->restore(context, restored);
         _content.insert(_contentVec.begin(), _contentVec.end());
         _contentVec.clear();
-        for (auto const& node : _content) subscribe(node);
+        for (auto const& node : _content) {
+            subscribe(node);
+            addMemberHash(node.get());
+        }
         return true;
     }
 }
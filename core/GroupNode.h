@@ -5,6 +5,8 @@
 #include <vector>
 #include <set>
 #include <memory>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace YAM
 {
@@ -25,6 +27,7 @@ namespace YAM
         GroupNode(ExecutionContext* context, std::filesystem::path const& name);
 
         std::string className() const override { return "GroupNode"; }
+        NodeKind kind() const override { return NodeKind::Group; }
 
         // Replace content by newContent.
         void content(std::vector<std::shared_ptr<Node>> newContent);
@@ -47,8 +50,12 @@ namespace YAM
 
         // Override Node
         void start(PriorityClass prio) override;
+        void handleDirtyOf(Node* observedNode) override;
 
-        // Return a hash of the names of the nodes in the group.
+        // Return a hash of the names of the nodes in the group and of the
+        // names of the detected outputs of the commands in the group.
+        // The hash is independent of the order of the nodes in the group.
+        // The hash is updated when the group completes execution.
         XXH64_hash_t hash() const { return _hash; }
 
         static void setStreamableType(uint32_t type);
@@ -62,6 +69,11 @@ namespace YAM
     private:
         void subscribe(std::shared_ptr<Node> const& node);
         void unsubscribe(std::shared_ptr<Node> const& node);
+        XXH64_hash_t memberHash(Node* node) const;
+        void addMemberHash(Node* node);
+        void removeMemberHash(Node* node);
+        void resetMemberHashes();
+        void updateStaleMemberHashes();
         XXH64_hash_t computeHash() const;
         void handleGroupCompletion(Node::State groupState);
 
@@ -82,6 +94,19 @@ namespace YAM
         // For a node X not being a GeneratedFileNode X is observed and
         // _observed[X]==1
         std::unordered_map<Node*, uint32_t> _observed;
+
+        // _contentHash is the sum of the member hashes of the nodes in 
+        // _content, see memberHash(..). Adding or removing a node adds or
+        // subtracts its member hash, i.e. takes O(1) instead of rehashing
+        // all nodes in the group.
+        XXH64_hash_t _contentHash;
+        // The member hashes of the CommandNodes in _content. The member hash
+        // of a command includes the names of its detected outputs. These 
+        // may change when the command re-executes.
+        std::unordered_map<Node*, XXH64_hash_t> _commandHashes;
+        // The commands in _commandHashes that became Dirty since the last
+        // execution of the group.
+        std::unordered_set<Node*> _staleCommands;
         XXH64_hash_t _hash;
     };
 }
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Delegates.h"
+#include "PriorityClass.h"
+
+#include <cstdint>
+
+namespace YAM
+{
+    class IDispatcherFrame;
+
+    // Interface of a thread-safe priority queue of delegates.
+    // Priorities range from 0 up to maxPriority(). Delegates with higher
+    // priority are popped before delegates with lower priority.
+    // See PriorityDispatcher, WorkStealingDispatcher and MpscDispatcher.
+    class __declspec(dllexport) IPriorityDispatcher
+    {
+    public:
+        virtual ~IPriorityDispatcher() {}
+
+        virtual uint32_t nPriorities() const = 0;
+        uint32_t maxPriority() const { return nPriorities() - 1; }
+        virtual uint32_t priorityOf(PriorityClass prio) const = 0;
+
+        // Append element to queue for given priority.
+        virtual void push(Delegate<void>& newAction, uint32_t prio) = 0;
+        virtual void push(Delegate<void>&& newAction, uint32_t prio) = 0;
+        virtual void push(Delegate<void>& newAction, PriorityClass prio = PriorityClass::Medium) = 0;
+        virtual void push(Delegate<void>&& newAction, PriorityClass prio = PriorityClass::Medium) = 0;
+
+        // Block calling thread until (!empty() && !suspended()) || stopped().
+        // When !stopped(): remove+return highest priority element from queue.
+        // When stopped(): return delegate that is not bound.
+        virtual Delegate<void> pop() = 0;
+
+        // Return number of elements in queue.
+        virtual std::size_t size() = 0;
+
+        // Return whether queue is empty.
+        virtual bool empty() = 0;
+
+        // Suspend dispatching until resumed. Also see pop()
+        virtual void suspend() = 0;
+        virtual void resume() = 0;
+        virtual bool suspended() = 0;
+
+        // Start dispatching, see pop()
+        virtual void start() = 0;
+
+        // Stop dispatching, see pop()
+        virtual void stop() = 0;
+
+        // Return wether dispatcher is started/stopped.
+        bool started() { return !stopped(); }
+        virtual bool stopped() = 0;
+
+        // Pop a delegate from queue and execute it.
+        virtual void popAndExecute() = 0;
+
+        // Execute the following loop:
+        //     while (!stopped()) popAndExecute();
+        virtual void run() = 0;
+
+        // Execute the following loop:
+        //     while (!frame.stopped() && !stopped()) popAndExecute();
+        // See PriorityDispatcher::run(IDispatcherFrame*).
+        virtual void run(IDispatcherFrame* frame) = 0;
+    };
+}
@@ -0,0 +1,48 @@
+#include "JobServer.h"
+
+#include <Windows.h>
+#include <atomic>
+#include <sstream>
+
+namespace
+{
+    std::atomic<uint32_t> jobServerCount(0);
+
+    std::string uniqueName() {
+        std::stringstream ss;
+        ss << "yam_jobserver_" << GetCurrentProcessId() << "_" << jobServerCount++;
+        return ss.str();
+    }
+}
+
+namespace YAM
+{
+    JobServer::JobServer(uint32_t nTokens)
+        : _nTokens(nTokens)
+        , _name(uniqueName())
+        , _semaphore(nullptr)
+    {
+        if (_nTokens == 0) throw std::exception("JobServer: nTokens must be > 0");
+        _semaphore = CreateSemaphoreA(nullptr, _nTokens, _nTokens, _name.c_str());
+        if (_semaphore == nullptr) throw std::exception("JobServer: failed to create semaphore");
+    }
+
+    JobServer::~JobServer() {
+        CloseHandle(_semaphore);
+    }
+
+    std::string JobServer::makeFlags() const {
+        std::stringstream ss;
+        ss << "-j" << _nTokens << " --jobserver-auth=" << _name;
+        return ss.str();
+    }
+
+    bool JobServer::acquire(std::chrono::milliseconds timeout) {
+        DWORD result = WaitForSingleObject(_semaphore, static_cast<DWORD>(timeout.count()));
+        return result == WAIT_OBJECT_0;
+    }
+
+    void JobServer::release() {
+        ReleaseSemaphore(_semaphore, 1, nullptr);
+    }
+}
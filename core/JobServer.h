@@ -0,0 +1,58 @@
+#pragma once
+
+#include <string>
+#include <chrono>
+#include <cstdint>
+
+namespace YAM
+{
+    // A JobServer shares a budget of job tokens between yam and the build
+    // tools (make, ninja, cargo) that are started by command scripts. 
+    // Without it each nested build tool runs its own -j jobs in parallel
+    // with the other yam commands, oversubscribing the machine.
+    //
+    // The server implements the GNU make jobserver protocol as supported
+    // by GNU make 4.x, ninja and cargo on Windows: tokens are the count of
+    // a named semaphore. Child processes find the semaphore via the 
+    // --jobserver-auth=<name> flag in the MAKEFLAGS environment variable, 
+    // see makeFlags().
+    //
+    // Yam acquires a token before it executes a command script and releases
+    // it when the script completes. This token is the implicit token of the 
+    // build tool started by the script. The build tool acquires additional
+    // tokens from the semaphore for each additional job it runs in parallel.
+    // Total concurrency of yam commands and nested jobs therefore does not
+    // exceed nTokens().
+    //
+    // Class is MT-safe.
+    //
+    class __declspec(dllexport) JobServer
+    {
+    public:
+        // Construct a jobserver with nTokens tokens.
+        // Throw std::exception when the semaphore cannot be created.
+        JobServer(uint32_t nTokens);
+        ~JobServer();
+
+        uint32_t nTokens() const { return _nTokens; }
+
+        // Return the name of the semaphore.
+        std::string const& name() const { return _name; }
+
+        // Return the value of the MAKEFLAGS environment variable that makes
+        // child processes use this jobserver.
+        std::string makeFlags() const;
+
+        // Wait at most timeout for a token to become available.
+        // Return whether a token was acquired. 
+        bool acquire(std::chrono::milliseconds timeout);
+
+        // Release a token acquired by acquire(..).
+        void release();
+
+    private:
+        uint32_t _nTokens;
+        std::string _name;
+        void* _semaphore;
+    };
+}
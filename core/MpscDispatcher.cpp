@@ -0,0 +1,196 @@
+#include "MpscDispatcher.h"
+#include "DispatcherFrame.h"
+
+namespace YAM
+{
+    MpscDispatcher::MpscDispatcher(uint32_t nPriorities)
+        : _nPriorities(nPriorities)
+        , _pushed(nullptr)
+        , _size(0)
+        , _batch(nPriorities)
+        , _batchSize(0)
+        , _highest(-1)
+        , _nBatches(0)
+        , _suspended(false)
+        , _stopped(false)
+        , _idle(false)
+    {
+        if (nPriorities == 0) throw std::exception("too few priorities");
+        if (nPriorities > 1024) throw std::exception("too many priorities");
+    }
+
+    MpscDispatcher::~MpscDispatcher() {
+        deleteItems(_pushed.exchange(nullptr));
+        for (auto& list : _batch) deleteItems(list.head);
+    }
+
+    void MpscDispatcher::deleteItems(Item* item) {
+        while (item != nullptr) {
+            Item* next = item->next;
+            delete item;
+            item = next;
+        }
+    }
+
+    uint32_t MpscDispatcher::priorityOf(PriorityClass prio) const {
+        uint32_t nPrios = nPriorities();
+        switch (prio)
+        {
+            case PriorityClass::VeryHigh: return nPrios;
+            case PriorityClass::High: return (nPrios * 3) / 4;
+            case PriorityClass::Medium:return nPrios / 2;
+            case PriorityClass::Low:return nPrios / 4;
+            case PriorityClass::VeryLow: return 0;
+            default: throw std::exception("invalid prio enum value");
+        }
+    }
+
+    void MpscDispatcher::push(Delegate<void>& action, uint32_t prio) {
+        pushItem(new Item{ action, prio, nullptr });
+    }
+
+    void MpscDispatcher::push(Delegate<void>&& action, uint32_t prio) {
+        pushItem(new Item{ std::move(action), prio, nullptr });
+    }
+
+    void MpscDispatcher::push(Delegate<void>& action, PriorityClass prio) {
+        push(action, priorityOf(prio));
+    }
+
+    void MpscDispatcher::push(Delegate<void>&& action, PriorityClass prio) {
+        push(std::move(action), priorityOf(prio));
+    }
+
+    void MpscDispatcher::pushItem(Item* item) {
+        if (item->prio > maxPriority()) item->prio = maxPriority();
+        item->next = _pushed.load();
+        while (!_pushed.compare_exchange_weak(item->next, item));
+        _size++;
+        // The consumer sets _idle before it evaluates _pushed. Hence either
+        // this thread sees _idle or the consumer sees the pushed item.
+        if (_idle) {
+            { std::lock_guard lk(_mtx); }
+            _cv.notify_one();
+        }
+    }
+
+    // Move all pushed items, in push order, to the batch.
+    void MpscDispatcher::drain() {
+        Item* pushed = _pushed.exchange(nullptr);
+        if (pushed == nullptr) return;
+        _nBatches++;
+        Item* reversed = nullptr;
+        while (pushed != nullptr) {
+            Item* next = pushed->next;
+            pushed->next = reversed;
+            reversed = pushed;
+            pushed = next;
+        }
+        while (reversed != nullptr) {
+            Item* item = reversed;
+            reversed = item->next;
+            item->next = nullptr;
+            ItemList& list = _batch[item->prio];
+            if (list.tail == nullptr) {
+                list.head = item;
+            } else {
+                list.tail->next = item;
+            }
+            list.tail = item;
+            _batchSize++;
+            if (static_cast<int32_t>(item->prio) > _highest) _highest = item->prio;
+        }
+    }
+
+    bool MpscDispatcher::popFromBatch(Delegate<void>& action) {
+        if (_pushed.load() != nullptr) drain();
+        if (_batchSize == 0) return false;
+        while (_batch[_highest].head == nullptr) _highest--;
+        ItemList& list = _batch[_highest];
+        Item* item = list.head;
+        list.head = item->next;
+        if (list.head == nullptr) list.tail = nullptr;
+        action = std::move(item->action);
+        delete item;
+        _batchSize--;
+        _size--;
+        if (_batchSize == 0) _highest = -1;
+        return true;
+    }
+
+    Delegate<void> MpscDispatcher::pop() {
+        Delegate<void> d;
+        while (!_stopped) {
+            if (!_suspended && popFromBatch(d)) break;
+            std::unique_lock lk(_mtx);
+            _idle = true;
+            _cv.wait(lk, [this] { 
+                return ((_batchSize > 0 || _pushed.load() != nullptr) && !_suspended) || _stopped;
+            });
+            _idle = false;
+        }
+        if (_stopped) d.Clear();
+        return d;
+    }
+
+    std::size_t MpscDispatcher::size() {
+        return _size;
+    }
+
+    bool MpscDispatcher::empty() {
+        return _size == 0;
+    }
+
+    void MpscDispatcher::suspend() {
+        {
+            std::lock_guard lk(_mtx);
+            _suspended = true;
+        }
+        _cv.notify_all();
+    }
+
+    void MpscDispatcher::resume() {
+        {
+            std::lock_guard lk(_mtx);
+            _suspended = false;
+        }
+        _cv.notify_all();
+    }
+
+    bool MpscDispatcher::suspended() {
+        return _suspended;
+    }
+
+    void MpscDispatcher::start() {
+        {
+            std::lock_guard lk(_mtx);
+            _stopped = false;
+        }
+        _cv.notify_all();
+    }
+
+    void MpscDispatcher::stop() {
+        {
+            std::lock_guard lk(_mtx);
+            _stopped = true;
+        }
+        _cv.notify_all();
+    }
+
+    bool MpscDispatcher::stopped() {
+        return _stopped;
+    }
+
+    void MpscDispatcher::popAndExecute() {
+        Delegate<void> d = pop();
+        if (d.IsBound()) d.Execute();
+    }
+
+    void MpscDispatcher::run() {
+        while (!stopped()) popAndExecute();
+    }
+
+    void MpscDispatcher::run(IDispatcherFrame* frame) {
+        while (!frame->stopped() && !stopped()) popAndExecute();
+    }
+}
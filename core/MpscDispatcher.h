@@ -0,0 +1,110 @@
+#pragma once
+
+#include "IPriorityDispatcher.h"
+
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+
+namespace YAM
+{
+    // Multi-producer/single-consumer priority queue intended to feed the
+    // main thread, see ExecutionContext::mainThreadQueue().
+    //
+    // All node completions are posted from the pool threads to the main
+    // thread. With PriorityDispatcher each push and each pop takes the
+    // dispatcher mutex, serializing producers and the main thread.
+    // In this dispatcher push() is lock-free: the delegate is prepended to
+    // an atomic singly-linked list. The consumer detaches the entire list
+    // in one atomic exchange and moves its delegates, in push order, into
+    // a consumer-private batch from which it pops without synchronization.
+    // The list is detached again as soon as new delegates were pushed,
+    // hence a delegate pushed with a higher priority than the ones in the
+    // batch is still popped first.
+    //
+    // The consumer only takes a mutex when it has to block because there
+    // is no work to do or because dispatching is suspended.
+    //
+    // Delegates are still executed one at a time, hence IDispatcherFrame
+    // semantics are unchanged: run(frame) checks frame->stopped() after
+    // each delegate. run(frame) may be called re-entrantly from a delegate
+    // that is executed by the consumer thread.
+    //
+    // pop(), popAndExecute() and run() must not be called concurrently, i.e.
+    // at most one thread at a time consumes from the dispatcher. All other
+    // member functions are MT-safe.
+    //
+    class __declspec(dllexport) MpscDispatcher : public IPriorityDispatcher
+    {
+    public:
+        // Construct dispatcher for priorities in range [0, nPriorities-1]
+        // in !suspended() && started() state.
+        MpscDispatcher(uint32_t nPriorities);
+        ~MpscDispatcher();
+
+        uint32_t nPriorities() const override { return _nPriorities; }
+        uint32_t priorityOf(PriorityClass prio) const override;
+
+        void push(Delegate<void>& newAction, uint32_t prio) override;
+        void push(Delegate<void>&& newAction, uint32_t prio) override;
+        void push(Delegate<void>& newAction, PriorityClass prio = PriorityClass::Medium) override;
+        void push(Delegate<void>&& newAction, PriorityClass prio = PriorityClass::Medium) override;
+
+        Delegate<void> pop() override;
+        std::size_t size() override;
+        bool empty() override;
+
+        void suspend() override;
+        void resume() override;
+        bool suspended() override;
+
+        void start() override;
+        void stop() override;
+        bool stopped() override;
+
+        void popAndExecute() override;
+        void run() override;
+        void run(IDispatcherFrame* frame) override;
+
+        // Return the number of times the consumer detached a non-empty list
+        // of pushed delegates. size() / nBatches() is the average batch size.
+        uint64_t nBatches() const { return _nBatches; }
+
+    private:
+        struct Item {
+            Delegate<void> action;
+            uint32_t prio;
+            Item* next;
+        };
+        struct ItemList {
+            Item* head = nullptr;
+            Item* tail = nullptr;
+        };
+
+        void pushItem(Item* item);
+        void drain();
+        bool popFromBatch(Delegate<void>& action);
+        static void deleteItems(Item* item);
+
+        uint32_t _nPriorities;
+
+        // Producer side: lock-free LIFO list of pushed items.
+        std::atomic<Item*> _pushed;
+        std::atomic<std::size_t> _size;
+
+        // Consumer side: FIFO list per priority, only accessed by consumer.
+        std::vector<ItemList> _batch;
+        std::size_t _batchSize;
+        int32_t _highest; // highest priority in _batch, -1 when empty
+        std::atomic<uint64_t> _nBatches;
+
+        std::atomic<bool> _suspended;
+        std::atomic<bool> _stopped;
+
+        // Consumer blocks on _cv when idle.
+        std::mutex _mtx;
+        std::condition_variable _cv;
+        std::atomic<bool> _idle;
+    };
+}
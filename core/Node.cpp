@@ -18,6 +18,34 @@ namespace {
         return true;
     }
 
+    // State of the dirty propagation pass, see Node::setState(..).
+    // Nodes are only accessed from the main thread of their context, hence
+    // there is at most one pass in progress per thread.
+    struct DirtyPass {
+        bool active = false;
+        // The nodes that became Dirty during the pass. Also the worklist
+        // of nodes whose observers are yet to be notified. A node is
+        // appended once because only its transition to Dirty appends it.
+        std::vector<Node*> dirtyNodes;
+    };
+    thread_local DirtyPass dirtyPass;
+
+    // Register the dirty nodes in their context in batches of nodes of
+    // the same context.
+    void registerDirtyNodes(std::vector<Node*> const& dirtyNodes) {
+        std::vector<Node*> batch;
+        ExecutionContext* context = nullptr;
+        for (auto node : dirtyNodes) {
+            if (node->context() != context) {
+                if (!batch.empty()) context->nodes().registerDirtyNodes(batch);
+                batch.clear();
+                context = node->context();
+            }
+            batch.push_back(node);
+        }
+        if (!batch.empty()) context->nodes().registerDirtyNodes(batch);
+    }
+
     bool isFailedOrCanceled(Node const* node) {
         return (
             node->state() == Node::State::Failed
@@ -29,24 +57,33 @@ namespace YAM
 {
     Node::Node()
         : _context(nullptr)
+        , _nameId(PathInterner::emptyId)
+        , _name(&PathInterner::names().path(PathInterner::emptyId))
         , _state(Node::State::Dirty)
         , _canceling(false)
         , _nExecutingNodes(0)
+        , _startingNodes(false)
         , _notifyingObservers(false)
+        , _listHook(this)
         , _modified(false) // because this instance will be deserialized
     {}
 
     Node::Node(ExecutionContext* context, std::filesystem::path const& name)
         : _context(context)
-        , _name(name)
+        , _nameId(PathInterner::names().intern(name))
+        , _name(&PathInterner::names().path(_nameId))
         , _state(Node::State::Dirty)
         , _canceling(false)
         , _nExecutingNodes(0)
+        , _startingNodes(false)
         , _notifyingObservers(false)
+        , _listHook(this)
         , _modified(true)
     {}
 
-    Node::~Node() {}
+    Node::~Node() {
+        NodeList::unlink(this);
+    }
 
     std::shared_ptr<FileRepositoryNode> const& Node::repository() const {
         auto repoName = FileRepositoryNode::repoNameFromPath(name());
@@ -64,13 +101,16 @@ namespace YAM
             }
             State oldState = _state;
             _state = newState;
+            _context->nodes().snapshotChange(_nameId);
             if (oldState == State::Failed || oldState == State::Canceled) {
                 _context->nodes().unregisterFailedOrCanceledNode(shared_from_this());
             } else if (oldState == State::Dirty) {
                 _context->nodes().unregisterDirtyNode(shared_from_this());
             }
             if (_state == State::Dirty) {
-                _context->nodes().registerDirtyNode(shared_from_this());
+                // registered in bulk by _propagateDirty()
+                _propagateDirty();
+                return;
             } else if (_state == State::Failed || _state == State::Canceled) {
                 _context->nodes().registerFailedOrCanceledNode(shared_from_this());
             }
@@ -79,11 +119,7 @@ namespace YAM
                 || _state == State::Failed
                 || _state == State::Canceled;
             _notifyingObservers = true;
-            if (_state == State::Dirty) {
-                for (auto observer : _observers) {
-                    observer->handleDirtyOf(this);
-                }
-            } else if (_state == State::Deleted) {
+            if (_state == State::Deleted) {
                 cleanup();
             }
             if (oldState == State::Executing && nowCompleted) {
@@ -92,15 +128,54 @@ namespace YAM
                 }
             }
             _notifyingObservers = false;
-            for (auto const& pair : _addedAndRemovedObservers) {
-                if (pair.second) {
-                    addObserver(pair.first);
-                } else {
-                    removeObserver(pair.first);
-                }
+            _updateObservers();
+        }
+    }
+
+    // Instead of recursing from observer to observer the pass maintains a 
+    // worklist of the nodes that became Dirty. Observers that become Dirty 
+    // while being notified, see handleDirtyOf(..), are appended to the
+    // worklist. Nodes are registered as dirty in context()->nodes() in
+    // bulk at the end of the pass.
+    void Node::_propagateDirty() {
+        dirtyPass.dirtyNodes.push_back(this);
+        if (dirtyPass.active) return;
+
+        dirtyPass.active = true;
+        std::vector<Node*>& dirtyNodes = dirtyPass.dirtyNodes;
+        try {
+            for (std::size_t i = 0; i < dirtyNodes.size(); ++i) {
+                dirtyNodes[i]->_notifyDirty();
+            }
+        } catch (...) {
+            registerDirtyNodes(dirtyNodes);
+            dirtyNodes.clear();
+            dirtyPass.active = false;
+            throw;
+        }
+        registerDirtyNodes(dirtyNodes);
+        dirtyNodes.clear();
+        dirtyPass.active = false;
+    }
+
+    void Node::_notifyDirty() {
+        _notifyingObservers = true;
+        for (auto observer : _observers) {
+            observer->handleDirtyOf(this);
+        }
+        _notifyingObservers = false;
+        _updateObservers();
+    }
+
+    void Node::_updateObservers() {
+        for (auto const& pair : _addedAndRemovedObservers) {
+            if (pair.second) {
+                addObserver(pair.first);
+            } else {
+                removeObserver(pair.first);
             }
-            _addedAndRemovedObservers.clear();
         }
+        _addedAndRemovedObservers.clear();
     }
 
     void Node::addObserver(StateObserver* observer) {
@@ -108,8 +183,7 @@ namespace YAM
             _addedAndRemovedObservers.push_back({ observer, true });
             return;
         }
-        auto p = _observers.insert(observer);
-        if (!p.second) {
+        if (!_observers.insert(observer)) {
             throw std::runtime_error("Attempt to add duplicate state observer");
         }
     }
@@ -134,6 +208,11 @@ namespace YAM
         Delegate<void, Node::State> const& callback,
         PriorityClass prio
     ) {
+        _callback = callback;
+        if (!_startNodes(nodes, prio)) _handleNodesCompletion();
+    }
+
+    bool Node::_startNodes(std::vector<Node*> const& nodes, PriorityClass prio) {
         ASSERT_MAIN_THREAD(_context);
         if (_state != Node::State::Executing) throw std::runtime_error("Attempt to start nodes while not in executing state");
         if (_nExecutingNodes != 0) throw std::runtime_error("Attempt to start nodes while already executing nodes");
@@ -142,13 +221,21 @@ namespace YAM
             stop = stop || isFailedOrCanceled(n);
             _nodesToExecute.insert(n);
         }
-        _callback = callback;
         if (stop) {
             cancel();
         } else {
-            for (auto n : _nodesToExecute) startNode(n, prio);
+            // A started node may complete before its start(..) returns, e.g.
+            // a command node whose inputs did not change. Its completion is
+            // counted by handleCompletionOf(..) but handled after the loop
+            // by the caller, see _startingNodes.
+            _startingNodes = true;
+            for (auto n : _nodesToExecute) {
+                if (_canceling) break;
+                startNode(n, prio);
+            }
+            _startingNodes = false;
         }
-        if (_nExecutingNodes == 0) _handleNodesCompletion();
+        return _nExecutingNodes != 0;
     }
 
     void Node::startNode(Node* node, PriorityClass prio) {
@@ -222,10 +309,10 @@ namespace YAM
         if (stopBuild) {
             cancel();
         }
-        if (_nExecutingNodes == 0) _handleNodesCompletion();
+        if (_nExecutingNodes == 0 && !_startingNodes) _handleNodesCompletion();
     }
 
-    void Node::_handleNodesCompletion() {
+    Node::State Node::_nodesCompletionState() {
         bool allOk = allNodesAreOk(_nodesToExecute);
         _nodesToExecute.clear();
 #ifdef _DEBUG
@@ -239,6 +326,11 @@ namespace YAM
         } else {
             state = State::Failed;
         }
+        return state;
+    }
+
+    void Node::_handleNodesCompletion() {
+        Node::State state = _nodesCompletionState();
         auto d = Delegate<void>::CreateLambda([this, state]()
         {
             _callback.Execute(state);
@@ -246,6 +338,10 @@ namespace YAM
         _context->mainThreadQueue().push(std::move(d));
     }
 
+    ResumeOn Node::resumeOnMainThread() const {
+        return ResumeOn(_context->mainThreadQueue(), PriorityClass::Medium, &_context->mainThread());
+    }
+
     void Node::postCompletion(Node::State newState) {
         auto d = Delegate<void>::CreateLambda([this, newState]()
         {
@@ -282,6 +378,9 @@ namespace YAM
     }
 
     void Node::modified(bool newValue) {
+        // Also when already modified: the node changed since the last
+        // published snapshot.
+        if (newValue) _context->nodes().snapshotChange(_nameId);
         if (_modified != newValue) {
             _modified = newValue;
             if (_modified) {
@@ -306,7 +405,13 @@ namespace YAM
     }
 
     void Node::stream(IStreamer* streamer) {
-        streamer->stream(_name);
+        std::filesystem::path name;
+        if (streamer->writing()) name = *_name;
+        streamer->stream(name);
+        if (streamer->reading()) {
+            _nameId = PathInterner::names().intern(name);
+            _name = &PathInterner::names().path(_nameId);
+        }
         uint32_t state;
         if (streamer->writing()) state = static_cast<uint32_t>(_state);
         streamer->stream(state);
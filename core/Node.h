@@ -3,7 +3,13 @@
 
 #include "Delegates.h"
 #include "IPersistable.h"
+#include "NodeKind.h"
+#include "NodeList.h"
 #include "PriorityClass.h"
+#include "NodeTask.h"
+#include "PathInterner.h"
+#include "SlabAllocator.h"
+#include "SmallVectorSet.h"
 
 #include <filesystem>
 #include <functional>
@@ -14,6 +20,7 @@
 #include <stdexcept>
 #include <atomic>
 #include <initializer_list>
+#include <coroutine>
 
 #ifdef _DEBUG
 #define ASSERT_MAIN_THREAD(contextPtr) (contextPtr)->assertMainThread()
@@ -76,10 +83,16 @@ namespace YAM
 
         // Return name of this name. name() format is: <repoName>\<path>
         // where <repoName> matches one of the names in context()->repositories().
-        std::filesystem::path const& name() const { return _name; }
+        std::filesystem::path const& name() const { return *_name; }
+
+        // Return the id of name() in PathInterner::names().
+        PathInterner::Id nameId() const { return _nameId; }
 
         virtual std::string className() const { return typeid(*this).name(); }
 
+        // Return the kind of the concrete class of this node.
+        virtual NodeKind kind() const { return NodeKind::Other; }
+
         // Return the repository that contains this node.
         std::shared_ptr<FileRepositoryNode> const& repository() const;
 
@@ -90,6 +103,12 @@ namespace YAM
         State state() const { return _state; }
 
         // Pre: state() != Node::State::Deleted
+        // Setting state Dirty notifies the observers of this node, and
+        // transitively their observers, in one iterative pass, see 
+        // StateObserver::handleDirtyOf(..). The observers are notified
+        // before setState(..) returns, unless setState(..) is called during
+        // a pass that is already in progress. In the latter case the 
+        // observers are notified later in the same pass.
         virtual void setState(State newState);
 
         // Start asynchronous execution with given priority.
@@ -118,7 +137,9 @@ namespace YAM
         // 
         void addObserver(StateObserver* observer);
         void removeObserver(StateObserver* observer);
-        std::unordered_set<StateObserver*> const& observers() const {
+        // Most nodes have one to three observers, see SmallVectorSet.
+        typedef SmallVectorSet<StateObserver*, 4> ObserverSet;
+        ObserverSet const& observers() const {
             return _observers;
         }
 
@@ -147,7 +168,7 @@ namespace YAM
         // Post: state() == Node::State::Dirty.
         // State changed will not be notified to subscribers.
         void undelete() override;
-        std::string describeName() const override { return _name.string(); }
+        std::string describeName() const override { return _name->string(); }
         std::string describeType() const override { return className(); }
 
         // Inherited from IStreamer (via IPersistable)
@@ -202,6 +223,51 @@ namespace YAM
             Delegate<void, Node::State> const& callback, 
             PriorityClass prio);
 
+        // Awaitable returned by awaitNodes(..).
+        class NodesAwaiter
+        {
+        public:
+            NodesAwaiter(Node* node, std::vector<Node*> const& nodes, PriorityClass prio)
+                : _node(node), _nodes(nodes), _prio(prio), _state(Node::State::Dirty)
+            {}
+
+            bool await_ready() const noexcept { return false; }
+            bool await_suspend(std::coroutine_handle<NodeTask::promise_type> handle) {
+                // The callback is only called when _startNodes(..) returns
+                // true, i.e. the coroutine is resumed exactly once.
+                _node->_callback = Delegate<void, Node::State>::CreateLambda(
+                    [this, handle](Node::State state) {
+                        _state = state;
+                        NodeTask::resume(handle);
+                    });
+                if (_node->_startNodes(_nodes, _prio)) return true;
+                _state = _node->_nodesCompletionState();
+                return false;
+            }
+            Node::State await_resume() const noexcept { return _state; }
+
+        private:
+            Node* _node;
+            std::vector<Node*> const& _nodes;
+            PriorityClass _prio;
+            Node::State _state;
+        };
+
+        // Coroutine alternative for startNodes(..), see NodeTask.
+        //     Node::State state = co_await awaitNodes(nodes, prio);
+        // starts execution of nodes and returns the state that startNodes 
+        // passes to its callback. Unlike startNodes the coroutine continues
+        // without a main thread queue round-trip when none of the nodes 
+        // needs execution.
+        // Pre: as for startNodes(..)
+        NodesAwaiter awaitNodes(std::vector<Node*> const& nodes, PriorityClass prio) {
+            return NodesAwaiter(this, nodes, prio);
+        }
+
+        // Return awaitable that resumes the awaiting coroutine in main
+        // thread, without suspension when already running in main thread.
+        ResumeOn resumeOnMainThread() const;
+
         // Push notifyCompletion(newState) to context()->mainThreadQueue()
         // To be called by subclass to notify execution completion from 
         // any thread.
@@ -215,11 +281,27 @@ namespace YAM
         void notifyCompletion(Node::State newState);
 
     private:
+        friend class NodeList;
+        NodeListHook& listHook() { return _listHook; }
+        NodeListHook const& listHook() const { return _listHook; }
+
         void startNode(Node* node, PriorityClass prio);
+        // Start nodes as specified by startNodes(..) without setting _callback.
+        // Return whether nodes are executing. If not: the caller must call
+        // _nodesCompletionState() or _handleNodesCompletion().
+        bool _startNodes(std::vector<Node*> const& nodes, PriorityClass prio);
+        // Return completion state of _nodesToExecute and clear it.
+        Node::State _nodesCompletionState();
         void _handleNodesCompletion();
+        // Notify observers of Dirty state as described by setState(..).
+        void _propagateDirty();
+        void _notifyDirty();
+        void _updateObservers();
 
         ExecutionContext* _context;
-        std::filesystem::path _name;
+        PathInterner::Id _nameId;
+        // Points to PathInterner::names().path(_nameId)
+        std::filesystem::path const* _name;
         State _state;
         std::atomic<bool> _canceling;
 
@@ -228,6 +310,9 @@ namespace YAM
         std::unordered_set<Node*> _nodesToExecute;
         // The size of the subset of _nodesToExecute that are executing.
         std::size_t _nExecutingNodes;
+        // True while _startNodes(..) starts _nodesToExecute. Completions
+        // during that time are handled when _startNodes(..) returns.
+        bool _startingNodes;
 #ifdef _DEBUG
         // nodes in _nodesToExecute that are executing  
         // _nExecutingNodes = _executingNodes.size()
@@ -236,7 +321,10 @@ namespace YAM
 
         MulticastDelegate<Node*> _completor;
         bool _notifyingObservers;
-        std::unordered_set<StateObserver*> _observers;
+        // Membership of the dirty or failed|canceled registry in
+        // context()->nodes().
+        NodeListHook _listHook;
+        ObserverSet _observers;
         // Observers that were added/removed while _notifyingObservers
         std::vector<std::pair<StateObserver*, bool>> _addedAndRemovedObservers;
 
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+
+namespace YAM
+{
+    // The concrete node classes. Used to index the dirty and failed|canceled
+    // node registries in NodeSet, see Node::kind().
+    enum class NodeKind : uint8_t {
+        Other = 0,          // classes that do not override Node::kind()
+        FileRepository,
+        Repositories,
+        Directory,
+        DotIgnore,
+        SourceFile,
+        GeneratedFile,
+        FileExecSpecs,
+        Command,
+        ForEach,
+        Glob,
+        Group,
+        BuildFileParser,
+        BuildFileCompiler,
+        Count               // number of kinds, not a kind
+    };
+}
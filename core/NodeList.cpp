@@ -0,0 +1,70 @@
+#include "NodeList.h"
+#include "Node.h"
+
+namespace YAM
+{
+    NodeList::NodeList()
+        : _head(nullptr)
+        , _tail(nullptr)
+        , _size(0)
+    {}
+
+    NodeList::~NodeList() {
+        clear();
+    }
+
+    void NodeList::pushBack(Node* node) {
+        NodeListHook& hook = node->listHook();
+        if (hook.list != nullptr) throw std::runtime_error("Attempt to add node that is already in a list");
+        hook.list = this;
+        hook.prev = _tail;
+        hook.next = nullptr;
+        if (_tail == nullptr) _head = &hook;
+        else _tail->next = &hook;
+        _tail = &hook;
+        _size += 1;
+    }
+
+    void NodeList::remove(Node* node) {
+        NodeListHook& hook = node->listHook();
+        if (hook.list != this) throw std::runtime_error("Attempt to remove node that is not in list");
+        if (hook.prev == nullptr) _head = hook.next;
+        else hook.prev->next = hook.next;
+        if (hook.next == nullptr) _tail = hook.prev;
+        else hook.next->prev = hook.prev;
+        hook.list = nullptr;
+        hook.prev = nullptr;
+        hook.next = nullptr;
+        _size -= 1;
+    }
+
+    void NodeList::unlink(Node* node) {
+        NodeList* list = node->listHook().list;
+        if (list != nullptr) list->remove(node);
+    }
+
+    bool NodeList::contains(Node const* node) const {
+        return node->listHook().list == this;
+    }
+
+    void NodeList::clear() {
+        NodeListHook* hook = _head;
+        while (hook != nullptr) {
+            NodeListHook* next = hook->next;
+            hook->list = nullptr;
+            hook->prev = nullptr;
+            hook->next = nullptr;
+            hook = next;
+        }
+        _head = nullptr;
+        _tail = nullptr;
+        _size = 0;
+    }
+
+    void NodeList::appendTo(std::vector<std::shared_ptr<Node>>& nodes) const {
+        nodes.reserve(nodes.size() + _size);
+        for (NodeListHook* hook = _head; hook != nullptr; hook = hook->next) {
+            nodes.push_back(hook->node->shared_from_this());
+        }
+    }
+}
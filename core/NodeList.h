@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+namespace YAM
+{
+    class Node;
+    class NodeList;
+
+    // The links of a node in a NodeList. Each Node embeds one hook, hence
+    // a node can be in at most one NodeList at a time.
+    struct __declspec(dllexport) NodeListHook
+    {
+        NodeListHook(Node* owner) : node(owner), list(nullptr), prev(nullptr), next(nullptr) {}
+
+        Node* node;
+        // The list that contains node, null when not in a list.
+        NodeList* list;
+        NodeListHook* prev;
+        NodeListHook* next;
+    };
+
+    // Intrusive doubly linked list of nodes. Links are stored in the nodes,
+    // see Node::listHook(), hence adding and removing a node is O(1) and
+    // does not allocate.
+    // The list does not own its nodes: a node removes itself from its list
+    // when it is destroyed.
+    //
+    // Class is not MT-safe.
+    //
+    class __declspec(dllexport) NodeList
+    {
+    public:
+        class const_iterator
+        {
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef Node* value_type;
+            typedef Node* reference;
+            typedef Node* const* pointer;
+            typedef std::ptrdiff_t difference_type;
+
+            const_iterator() : _hook(nullptr) {}
+
+            Node* operator*() const { return _hook->node; }
+            const_iterator& operator++() { _hook = _hook->next; return *this; }
+            const_iterator operator++(int) { const_iterator tmp = *this; _hook = _hook->next; return tmp; }
+            bool operator==(const_iterator const& rhs) const { return _hook == rhs._hook; }
+            bool operator!=(const_iterator const& rhs) const { return _hook != rhs._hook; }
+
+        private:
+            friend class NodeList;
+            explicit const_iterator(NodeListHook* hook) : _hook(hook) {}
+            NodeListHook* _hook;
+        };
+
+        NodeList();
+        NodeList(NodeList const&) = delete;
+        NodeList& operator=(NodeList const&) = delete;
+        // Unlink all nodes.
+        ~NodeList();
+
+        // Append node.
+        // Throw when node is already in a list.
+        void pushBack(Node* node);
+
+        // Remove node.
+        // Throw when node is not in this list.
+        void remove(Node* node);
+
+        // Remove node from the list that contains it, if any.
+        static void unlink(Node* node);
+
+        bool contains(Node const* node) const;
+
+        // Unlink all nodes.
+        void clear();
+
+        const_iterator begin() const { return const_iterator(_head); }
+        const_iterator end() const { return const_iterator(); }
+        std::size_t size() const { return _size; }
+        bool empty() const { return _size == 0; }
+
+        // Append the nodes in this list to nodes.
+        void appendTo(std::vector<std::shared_ptr<Node>>& nodes) const;
+
+    private:
+        NodeListHook* _head;
+        NodeListHook* _tail;
+        std::size_t _size;
+    };
+}
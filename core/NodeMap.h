@@ -0,0 +1,256 @@
+#pragma once
+
+#include "PathInterner.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <iterator>
+#include <memory>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace YAM
+{
+    // A NodeMap is a flat map of nodes keyed by node name. It replaces
+    // std::map<std::filesystem::path, std::shared_ptr<TNode>> for directory
+    // content and for command inputs and outputs.
+    //
+    // Nodes are stored in a vector sorted by node name, i.e. in the same
+    // order as in the std::map. Hashes computed over the map content
+    // therefore do not depend on the order in which names were interned.
+    // Each entry caches the interned name id of its node. Equal names are
+    // detected by comparing ids, only unequal names are compared by path,
+    // see computeNodeMapDifference(..).
+    //
+    // Lookup is a binary search, insert(..) and erase(..) are O(size()).
+    // Bulk updates must construct a new map or use update(..).
+    //
+    // Iteration yields std::pair<path const&, std::shared_ptr<TNode> const&>
+    // in which first == second->name(), like iteration of a std::map.
+    //
+    template <class TNode>
+    class NodeMap
+    {
+        struct Entry {
+            PathInterner::Id nameId;
+            std::shared_ptr<TNode> node;
+        };
+
+    public:
+        typedef std::pair<std::filesystem::path const&, std::shared_ptr<TNode> const&> value_type;
+
+        class const_iterator
+        {
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef NodeMap::value_type value_type;
+            typedef value_type reference;
+            typedef std::ptrdiff_t difference_type;
+            struct pointer {
+                value_type pair;
+                value_type const* operator->() const { return &pair; }
+            };
+
+            const_iterator() = default;
+
+            reference operator*() const { return value_type(_it->node->name(), _it->node); }
+            pointer operator->() const { return pointer{ **this }; }
+            const_iterator& operator++() { ++_it; return *this; }
+            const_iterator operator++(int) { const_iterator tmp = *this; ++_it; return tmp; }
+            bool operator==(const_iterator const& rhs) const { return _it == rhs._it; }
+            bool operator!=(const_iterator const& rhs) const { return _it != rhs._it; }
+
+            // Return the interned id of the name of the node.
+            PathInterner::Id nameId() const { return _it->nameId; }
+
+        private:
+            friend class NodeMap;
+            explicit const_iterator(typename std::vector<Entry>::const_iterator it) : _it(it) {}
+            typename std::vector<Entry>::const_iterator _it;
+        };
+        typedef const_iterator iterator;
+
+        NodeMap() = default;
+
+        // Construct map from nodes in arbitrary order. Of nodes with equal
+        // names only the first one is inserted.
+        explicit NodeMap(std::vector<std::shared_ptr<TNode>> const& nodes) {
+            _entries.reserve(nodes.size());
+            for (auto const& node : nodes) _entries.push_back(Entry{ node->nameId(), node });
+            std::stable_sort(_entries.begin(), _entries.end(), lessByName);
+            auto last = std::unique(_entries.begin(), _entries.end(), equalName);
+            _entries.erase(last, _entries.end());
+        }
+
+        const_iterator begin() const { return const_iterator(_entries.begin()); }
+        const_iterator end() const { return const_iterator(_entries.end()); }
+        std::size_t size() const { return _entries.size(); }
+        bool empty() const { return _entries.empty(); }
+        void clear() { _entries.clear(); }
+        void reserve(std::size_t n) { _entries.reserve(n); }
+
+        const_iterator find(std::filesystem::path const& name) const {
+            auto it = lowerBound(name);
+            if (it != _entries.end() && it->node->name() == name) return const_iterator(it);
+            return end();
+        }
+        bool contains(std::filesystem::path const& name) const {
+            return find(name) != end();
+        }
+
+        // Insert node when no node with same name is in the map.
+        // Return iterator to the node with node->name() and whether node
+        // was inserted.
+        std::pair<const_iterator, bool> insert(std::shared_ptr<TNode> const& node) {
+            auto it = lowerBound(node->name());
+            if (it != _entries.end() && it->nameId == node->nameId()) {
+                return { const_iterator(it), false };
+            }
+            it = _entries.insert(it, Entry{ node->nameId(), node });
+            return { const_iterator(it), true };
+        }
+
+        const_iterator erase(const_iterator pos) {
+            return const_iterator(_entries.erase(pos._it));
+        }
+        std::size_t erase(std::filesystem::path const& name) {
+            auto it = find(name);
+            if (it == end()) return 0;
+            erase(it);
+            return 1;
+        }
+
+        // Remove the nodes in 'removed' and insert the nodes in 'added' in
+        // one linear merge.
+        // Throw when a removed node is not in the map or when an added node
+        // is already in the map.
+        void update(
+            std::vector<std::shared_ptr<TNode>> const& removed,
+            std::vector<std::shared_ptr<TNode>> const& added
+        ) {
+            NodeMap toRemove(removed);
+            NodeMap toAdd(added);
+            std::vector<Entry> kept;
+            kept.reserve(_entries.size());
+            auto rit = toRemove._entries.begin();
+            auto rend = toRemove._entries.end();
+            for (auto const& entry : _entries) {
+                if (rit != rend && rit->nameId == entry.nameId) ++rit;
+                else kept.push_back(entry);
+            }
+            if (rit != rend) throw std::exception("no such node");
+            _entries.clear();
+            _entries.reserve(kept.size() + toAdd.size());
+            std::merge(
+                kept.begin(), kept.end(),
+                toAdd._entries.begin(), toAdd._entries.end(),
+                std::back_inserter(_entries),
+                lessByName);
+            auto duplicate = std::adjacent_find(_entries.begin(), _entries.end(), equalName);
+            if (duplicate != _entries.end()) throw std::exception("duplicate node");
+        }
+
+        // Append node without maintaining the sort order.
+        // Used when node names are not yet known, e.g. during deserialization.
+        // Call sort() before any other operation.
+        void append(std::shared_ptr<TNode> const& node) {
+            _entries.push_back(Entry{ PathInterner::invalidId, node });
+        }
+
+        // Update the cached name ids and restore the sort order.
+        void sort() {
+            for (auto& entry : _entries) entry.nameId = entry.node->nameId();
+            std::sort(_entries.begin(), _entries.end(), lessByName);
+        }
+
+        bool operator==(NodeMap const& rhs) const {
+            return std::equal(
+                _entries.begin(), _entries.end(),
+                rhs._entries.begin(), rhs._entries.end(),
+                [](Entry const& lhs, Entry const& rhs) { return lhs.node == rhs.node; });
+        }
+
+    private:
+        static bool lessByName(Entry const& lhs, Entry const& rhs) {
+            return lhs.nameId != rhs.nameId && lhs.node->name() < rhs.node->name();
+        }
+        static bool equalName(Entry const& lhs, Entry const& rhs) {
+            return lhs.nameId == rhs.nameId;
+        }
+
+        typename std::vector<Entry>::const_iterator lowerBound(std::filesystem::path const& name) const {
+            return std::lower_bound(
+                _entries.begin(), _entries.end(), name,
+                [](Entry const& entry, std::filesystem::path const& name) {
+                    return entry.node->name() < name;
+                });
+        }
+
+        std::vector<Entry> _entries;
+    };
+
+    // Compute in one linear merge the nodes whose names are in both in1
+    // and in2, only in in1 and only in in2. Output is sorted by name.
+    // inBoth receives the nodes of in1.
+    template <class TNode>
+    void computeNodeMapDifference(
+        NodeMap<TNode> const& in1,
+        NodeMap<TNode> const& in2,
+        std::vector<std::shared_ptr<TNode>>& inBoth,
+        std::vector<std::shared_ptr<TNode>>& onlyIn1,
+        std::vector<std::shared_ptr<TNode>>& onlyIn2
+    ) {
+        auto it1 = in1.begin();
+        auto it2 = in2.begin();
+        while (it1 != in1.end() && it2 != in2.end()) {
+            auto const& node1 = (*it1).second;
+            auto const& node2 = (*it2).second;
+            if (it1.nameId() == it2.nameId()) {
+                inBoth.push_back(node1);
+                ++it1;
+                ++it2;
+            } else if (node1->name() < node2->name()) {
+                onlyIn1.push_back(node1);
+                ++it1;
+            } else {
+                onlyIn2.push_back(node2);
+                ++it2;
+            }
+        }
+        for (; it1 != in1.end(); ++it1) onlyIn1.push_back((*it1).second);
+        for (; it2 != in2.end(); ++it2) onlyIn2.push_back((*it2).second);
+    }
+
+    // Compute in one linear merge the nodes in in1 whose names are in in2,
+    // the nodes in in1 whose names are not in in2 and the paths in in2 that
+    // are not the name of a node in in1. Output is sorted by name.
+    template <class TNode>
+    void computeNodeMapDifference(
+        NodeMap<TNode> const& in1,
+        std::set<std::filesystem::path> const& in2,
+        std::vector<std::shared_ptr<TNode>>& inBoth,
+        std::vector<std::shared_ptr<TNode>>& onlyIn1,
+        std::vector<std::filesystem::path>& onlyIn2
+    ) {
+        auto it1 = in1.begin();
+        auto it2 = in2.begin();
+        while (it1 != in1.end() && it2 != in2.end()) {
+            auto pair1 = *it1;
+            int cmp = pair1.first.compare(*it2);
+            if (cmp == 0) {
+                inBoth.push_back(pair1.second);
+                ++it1;
+                ++it2;
+            } else if (cmp < 0) {
+                onlyIn1.push_back(pair1.second);
+                ++it1;
+            } else {
+                onlyIn2.push_back(*it2);
+                ++it2;
+            }
+        }
+        for (; it1 != in1.end(); ++it1) onlyIn1.push_back((*it1).second);
+        onlyIn2.insert(onlyIn2.end(), it2, in2.end());
+    }
+}
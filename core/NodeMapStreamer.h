@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Node.h"
+#include "NodeMap.h"
 
 #include <map>
 #include <filesystem>
@@ -51,6 +52,37 @@ namespace YAM
             for (auto const& pair : map) restored.insert({ pair.second->name(), pair.second });
             map = restored;
         }
+
+        template<typename TNode>
+        static void stream(IStreamer* streamer, NodeMap<TNode>& map) {
+            uint32_t nItems;
+            if (streamer->writing()) {
+                const std::size_t length = map.size();
+                if (length > UINT_MAX) throw std::exception("map too large");
+                nItems = static_cast<uint32_t>(length);
+            }
+            streamer->stream(nItems);
+            if (streamer->writing()) {
+                for (auto const& pair : map) {
+                    std::shared_ptr<TNode> node = pair.second;
+                    streamer->stream(node);
+                }
+            } else {
+                // Node names may not yet have been streamed, see above.
+                // Sort the map in restore().
+                map.reserve(nItems);
+                for (std::size_t i = 0; i < nItems; ++i) {
+                    std::shared_ptr<TNode> node;
+                    streamer->stream(node);
+                    map.append(node);
+                }
+            }
+        }
+
+        template<typename TNode>
+        static void restore(NodeMap<TNode>& map) {
+            map.sort();
+        }
     };
 }
 
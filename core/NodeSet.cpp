@@ -4,7 +4,7 @@
 namespace YAM
 {
     void NodeSet::addIfAbsent(std::shared_ptr<Node> const& node) {
-        const auto result = _nodes.insert({ node->name(), node });
+        const auto result = _nodes.insert({ node->nameId(), node });
         if (result.second) {
             if (node->state() == Node::State::Dirty) {
                 registerDirtyNode(node);
@@ -16,7 +16,7 @@ namespace YAM
     }
 
     void NodeSet::add(std::shared_ptr<Node> const& node) {
-        const auto [it, success] = _nodes.insert({ node->name(), node });
+        const auto [it, success] = _nodes.insert({ node->nameId(), node });
         if (!success) throw std::runtime_error("failed to add node");
         if (node->state() == Node::State::Dirty) {
             registerDirtyNode(node);
@@ -27,30 +27,37 @@ namespace YAM
     }
 
     void NodeSet::remove(std::shared_ptr<Node> const& node) {
-        auto nRemoved = _nodes.erase(node->name());
+        auto nRemoved = _nodes.erase(node->nameId());
         if (nRemoved != 1) throw std::runtime_error("failed to remove node");
         node->setState(Node::State::Deleted);
-        _dirtyNodes[node->className()].erase(node);
+        NodeList::unlink(node.get());
         changeSetRemove(node);
     }
 
     void NodeSet::removeIfPresent(std::shared_ptr<Node> const& node) {
-        auto nRemoved = _nodes.erase(node->name());
+        auto nRemoved = _nodes.erase(node->nameId());
         if (nRemoved == 1) {
             node->setState(Node::State::Deleted);
-            _dirtyNodes[node->className()].erase(node);
+            NodeList::unlink(node.get());
             changeSetRemove(node);
         }
     }
 
     void NodeSet::clear() {
         for (auto const& pair : _nodes) changeSetRemove(pair.second);
-        _dirtyNodes.clear();
+        for (auto& list : _dirtyNodes) list.clear();
+        for (auto& list : _failedOrCanceledNodes) list.clear();
         _nodes.clear();
     }
 
     std::shared_ptr<Node> NodeSet::find(std::filesystem::path const& nodeName) const {
-        auto it = _nodes.find(nodeName);
+        PathInterner::Id nameId = PathInterner::names().find(nodeName);
+        if (nameId == PathInterner::invalidId) return std::shared_ptr<Node>();
+        return find(nameId);
+    }
+
+    std::shared_ptr<Node> NodeSet::find(PathInterner::Id nameId) const {
+        auto it = _nodes.find(nameId);
         if (it != _nodes.end())
         {
             return it->second;
@@ -78,8 +85,8 @@ namespace YAM
     }
 
     bool NodeSet::contains(std::filesystem::path const& nodeName) const {
-        auto it = _nodes.find(nodeName);
-        return (it != _nodes.end());
+        PathInterner::Id nameId = PathInterner::names().find(nodeName);
+        return nameId != PathInterner::invalidId && _nodes.contains(nameId);
     }
 
     std::size_t NodeSet::size() const {
@@ -87,7 +94,9 @@ namespace YAM
     }
 
     std::unordered_map<std::filesystem::path, std::shared_ptr<Node>> NodeSet::nodesMap() const {
-        return _nodes;
+        std::unordered_map<std::filesystem::path, std::shared_ptr<Node>> nodes;
+        for (auto const& pair : _nodes) nodes.insert({ pair.second->name(), pair.second });
+        return nodes;
     }
 
     std::vector<std::shared_ptr<Node>> NodeSet::nodes() const {
@@ -97,35 +106,53 @@ namespace YAM
     }
 
     void NodeSet::NodeSet::registerDirtyNode(std::shared_ptr<Node> const& node) {
-        if (!_nodes.contains(node->name())) return;
-        auto result = _dirtyNodes[node->className()].insert(node);
-        if (!result.second) throw std::runtime_error("Attempt to add duplicate dirty node");
+        if (!_nodes.contains(node->nameId())) return;
+        _dirtyNodes[static_cast<std::size_t>(node->kind())].pushBack(node.get());
+    }
+
+    void NodeSet::registerDirtyNodes(std::vector<Node*> const& nodes) {
+        for (auto node : nodes) {
+            if (!_nodes.contains(node->nameId())) continue;
+            // Skip nodes that left Dirty, or were registered, after they
+            // were collected by the dirty propagation pass.
+            if (node->state() != Node::State::Dirty) continue;
+            NodeList& dirtyNodes = _dirtyNodes[static_cast<std::size_t>(node->kind())];
+            if (!dirtyNodes.contains(node)) dirtyNodes.pushBack(node);
+        }
     }
 
     void NodeSet::unregisterDirtyNode(std::shared_ptr<Node> const& node) {
-        if (!_nodes.contains(node->name())) return;
-        std::size_t nRemoved = _dirtyNodes[node->className()].erase(node);
-        if (nRemoved != 1) throw std::runtime_error("Attempt to remove unknown dirty node");
+        if (!_nodes.contains(node->nameId())) return;
+        // node may not be registered yet when it leaves Dirty during the
+        // dirty propagation pass that made it Dirty.
+        NodeList& dirtyNodes = _dirtyNodes[static_cast<std::size_t>(node->kind())];
+        if (dirtyNodes.contains(node.get())) dirtyNodes.remove(node.get());
+    }
+
+    NodeList const& NodeSet::dirtyNodes(NodeKind kind) const {
+        return _dirtyNodes[static_cast<std::size_t>(kind)];
     }
 
-    std::unordered_map<std::string, std::unordered_set<std::shared_ptr<Node>>> const& NodeSet::dirtyNodes() const {
-        return _dirtyNodes;
+    void NodeSet::appendDirtyNodes(std::vector<std::shared_ptr<Node>>& dirtyNodes) const {
+        for (auto const& list : _dirtyNodes) list.appendTo(dirtyNodes);
     }
 
     void NodeSet::NodeSet::registerFailedOrCanceledNode(std::shared_ptr<Node> const& node) {
-        if (!_nodes.contains(node->name())) return;
-        auto result = _failedOrCanceledNodes[node->className()].insert(node);
-        if (!result.second) throw std::runtime_error("Attempt to add duplicate failed|canceled node");
+        if (!_nodes.contains(node->nameId())) return;
+        _failedOrCanceledNodes[static_cast<std::size_t>(node->kind())].pushBack(node.get());
     }
 
     void NodeSet::unregisterFailedOrCanceledNode(std::shared_ptr<Node> const& node) {
-        if (!_nodes.contains(node->name())) return;
-        std::size_t nRemoved = _failedOrCanceledNodes[node->className()].erase(node);
-        if (nRemoved != 1) throw std::runtime_error("Attempt to remove unknown failed|canceled node");
+        if (!_nodes.contains(node->nameId())) return;
+        _failedOrCanceledNodes[static_cast<std::size_t>(node->kind())].remove(node.get());
     }
 
-    std::unordered_map<std::string, std::unordered_set<std::shared_ptr<Node>>> const& NodeSet::failedOrCanceledNodes() const {
-        return _failedOrCanceledNodes;
+    NodeList const& NodeSet::failedOrCanceledNodes(NodeKind kind) const {
+        return _failedOrCanceledNodes[static_cast<std::size_t>(kind)];
+    }
+
+    void NodeSet::appendFailedOrCanceledNodes(std::vector<std::shared_ptr<Node>>& failedOrCanceledNodes) const {
+        for (auto const& list : _failedOrCanceledNodes) list.appendTo(failedOrCanceledNodes);
     }
 
     void NodeSet::changeSetModify(std::shared_ptr<Node> const& node) {
@@ -135,10 +162,12 @@ namespace YAM
     void NodeSet::changeSetAdd(std::shared_ptr<Node> const& node) {
         _modifiedNodes.erase(node);
         _addedNodes.insert(node);
+        _snapshotChanges.insert(node->nameId());
     }
     void NodeSet::changeSetRemove(std::shared_ptr<Node> const& node) {
         _modifiedNodes.erase(node);
         _removedNodes.insert(node);
+        _snapshotChanges.insert(node->nameId());
     }
 
     std::unordered_set<std::shared_ptr<Node>> const& NodeSet::addedNodes() const {
@@ -159,4 +188,14 @@ namespace YAM
         _modifiedNodes.clear();
         _removedNodes.clear();
     }
+
+    void NodeSet::snapshotChange(PathInterner::Id nameId) {
+        _snapshotChanges.insert(nameId);
+    }
+    std::unordered_set<PathInterner::Id> const& NodeSet::snapshotChanges() const {
+        return _snapshotChanges;
+    }
+    void NodeSet::clearSnapshotChanges() {
+        _snapshotChanges.clear();
+    }
 }
\ No newline at end of file
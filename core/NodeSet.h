@@ -1,6 +1,10 @@
 #pragma once
 
 #include "Delegates.h"
+#include "NodeKind.h"
+#include "NodeList.h"
+#include "PathInterner.h"
+#include <array>
 #include <filesystem>
 #include <memory>
 #include <unordered_map>
@@ -11,6 +15,11 @@ namespace YAM
     class Node;
 
     // Class to store nodes that have unique names.
+    // Nodes are keyed by Node::nameId(), lookup by name first looks up the
+    // name in PathInterner::names().
+    // The set registers its Dirty and its Failed|Canceled nodes in lists
+    // indexed by Node::kind(). The lists link the nodes via Node::listHook(),
+    // hence (un)registration is O(1) and does not allocate.
     class __declspec(dllexport) NodeSet
     {
     public:
@@ -18,6 +27,8 @@ namespace YAM
         // Nodes are identified by their name(). 
         // No duplicates allowed.
         NodeSet() = default;
+        NodeSet(NodeSet const&) = delete;
+        NodeSet& operator=(NodeSet const&) = delete;
 
         // Add node to the set.
         void addIfAbsent(std::shared_ptr<Node> const& node);
@@ -40,6 +51,10 @@ namespace YAM
         // Return null when not found.
         std::shared_ptr<Node> find(std::filesystem::path const& nodeName) const;
 
+        // Find and return node whose nameId() matches nameId.
+        // Return null when not found.
+        std::shared_ptr<Node> find(PathInterner::Id nameId) const;
+
         // Return in 'foundNodes' all nodes for which includeNode(node)==true.
         void find(
             Delegate<bool, std::shared_ptr<Node> const&> includeNode,
@@ -58,20 +73,28 @@ namespace YAM
 
         // Pre: node->state() == Node::State::Dirty
         void registerDirtyNode(std::shared_ptr<Node> const& node);
+        // Register the nodes in nodes that are Dirty and not yet registered.
+        void registerDirtyNodes(std::vector<Node*> const& nodes);
         // Pre: node->state() != Node::State::Dirty
+        // No-op when node is not registered.
         void unregisterDirtyNode(std::shared_ptr<Node> const& node);
-        // Return map from node class name to the set of instances of that class
-        // in state Node::State::Dirty
-        std::unordered_map<std::string, std::unordered_set<std::shared_ptr<Node>>> const& dirtyNodes() const;
+        // Return the nodes of given kind in state Node::State::Dirty
+        NodeList const& dirtyNodes(NodeKind kind) const;
+        // Append the nodes in state Node::State::Dirty to dirtyNodes, ordered
+        // by node kind.
+        void appendDirtyNodes(std::vector<std::shared_ptr<Node>>& dirtyNodes) const;
 
 
         // Pre: node->state() == Node::State::Failed || Node::State::Canceled
         void registerFailedOrCanceledNode(std::shared_ptr<Node> const& node);
         // Pre: node->state() != Node::State::Failed || Node::State::Canceled
         void unregisterFailedOrCanceledNode(std::shared_ptr<Node> const& node);
-        // Return map from node class name to the set of instances of that class
-        // in state Node::State::Failed || Node::State::Canceled
-        std::unordered_map<std::string, std::unordered_set<std::shared_ptr<Node>>> const& failedOrCanceledNodes() const;
+        // Return the nodes of given kind in state Node::State::Failed ||
+        // Node::State::Canceled
+        NodeList const& failedOrCanceledNodes(NodeKind kind) const;
+        // Append the nodes in state Node::State::Failed || Node::State::Canceled
+        // to failedOrCanceledNodes, ordered by node kind.
+        void appendFailedOrCanceledNodes(std::vector<std::shared_ptr<Node>>& failedOrCanceledNodes) const;
 
         // Register node as modified in changeset.
         // Pre: node->modified()
@@ -86,20 +109,33 @@ namespace YAM
         std::size_t changeSetSize() const;
         void clearChangeSet();
 
+        // Register that the node with given name id was added, removed or
+        // changed its state, hash, inputs or outputs, see GraphSnapshot.
+        // Nodes register themselves in Node::setState(..) and in
+        // Node::modified(true), the set registers added and removed nodes.
+        void snapshotChange(PathInterner::Id nameId);
+
+        // Return the name ids registered since the last call to
+        // clearSnapshotChanges(), see ExecutionContext::publishSnapshot().
+        std::unordered_set<PathInterner::Id> const& snapshotChanges() const;
+        void clearSnapshotChanges();
+
     private:
         void changeSetAdd(std::shared_ptr<Node> const& node);
         void changeSetRemove(std::shared_ptr<Node> const& node);
 
-        std::unordered_map<std::filesystem::path, std::shared_ptr<Node>> _nodes;
+        std::unordered_map<PathInterner::Id, std::shared_ptr<Node>> _nodes;
 
-        std::unordered_map<std::string, std::unordered_set<std::shared_ptr<Node>>> _dirtyNodes;
-        std::unordered_map<std::string, std::unordered_set<std::shared_ptr<Node>>> _failedOrCanceledNodes;
+        // Indexed by Node::kind()
+        std::array<NodeList, static_cast<std::size_t>(NodeKind::Count)> _dirtyNodes;
+        std::array<NodeList, static_cast<std::size_t>(NodeKind::Count)> _failedOrCanceledNodes;
 
         // Changeset
         std::unordered_set<std::shared_ptr<Node>> _addedNodes;
         std::unordered_set<std::shared_ptr<Node>> _modifiedNodes;
         std::unordered_set<std::shared_ptr<Node>> _removedNodes;
 
+        std::unordered_set<PathInterner::Id> _snapshotChanges;
     };
 }
 
@@ -0,0 +1,35 @@
+
+#include "NodeStatusRequest.h"
+#include "IStreamer.h"
+
+namespace
+{
+    uint32_t _streamableType = 0;
+}
+
+namespace YAM
+{
+    NodeStatusRequest::NodeStatusRequest(IStreamer* reader) {
+        stream(reader);
+    }
+
+    void NodeStatusRequest::nodes(std::vector<std::filesystem::path> const& newNodes) {
+        _nodes = newNodes;
+    }
+
+    std::vector<std::filesystem::path> const& NodeStatusRequest::nodes() const {
+        return _nodes;
+    }
+
+    void NodeStatusRequest::setStreamableType(uint32_t type) {
+        _streamableType = type;
+    }
+
+    uint32_t NodeStatusRequest::typeId() const {
+        return _streamableType;
+    }
+
+    void NodeStatusRequest::stream(IStreamer* streamer) {
+        streamer->streamVector(_nodes);
+    }
+}
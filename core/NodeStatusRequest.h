@@ -0,0 +1,31 @@
+#pragma once
+
+#include "IStreamable.h"
+
+#include <filesystem>
+#include <vector>
+
+namespace YAM
+{
+    // Request the state of nodes. The build service answers the request
+    // with a NodeStatusResult taken from the last published GraphSnapshot,
+    // also while a build is running.
+    class __declspec(dllexport) NodeStatusRequest : public IStreamable
+    {
+    public:
+        NodeStatusRequest() {}
+        NodeStatusRequest(IStreamer* reader);
+
+        // Set/get the names of the nodes to query.
+        void nodes(std::vector<std::filesystem::path> const& newNodes);
+        std::vector<std::filesystem::path> const& nodes() const;
+
+        static void setStreamableType(uint32_t type);
+        // Inherited via IStreamable
+        uint32_t typeId() const override;
+        void stream(IStreamer* streamer) override;
+
+    private:
+        std::vector<std::filesystem::path> _nodes;
+    };
+}
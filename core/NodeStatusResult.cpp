@@ -0,0 +1,60 @@
+
+#include "NodeStatusResult.h"
+#include "IStreamer.h"
+
+namespace
+{
+    uint32_t _streamableType = 0;
+}
+
+namespace YAM
+{
+    NodeStatusResult::NodeStatusResult()
+        : _epoch(0)
+    {}
+
+    NodeStatusResult::NodeStatusResult(IStreamer* reader)
+        : _epoch(0)
+    {
+        stream(reader);
+    }
+
+    void NodeStatusResult::epoch(uint64_t newEpoch) {
+        _epoch = newEpoch;
+    }
+
+    uint64_t NodeStatusResult::epoch() const {
+        return _epoch;
+    }
+
+    void NodeStatusResult::add(NodeStatus const& status) {
+        _nodes.push_back(status);
+    }
+
+    std::vector<NodeStatusResult::NodeStatus> const& NodeStatusResult::nodes() const {
+        return _nodes;
+    }
+
+    void NodeStatusResult::setStreamableType(uint32_t type) {
+        _streamableType = type;
+    }
+
+    uint32_t NodeStatusResult::typeId() const {
+        return _streamableType;
+    }
+
+    void NodeStatusResult::stream(IStreamer* streamer) {
+        streamer->stream(_epoch);
+        uint32_t nNodes = static_cast<uint32_t>(_nodes.size());
+        streamer->stream(nNodes);
+        if (streamer->reading()) _nodes.resize(nNodes);
+        for (auto& status : _nodes) {
+            streamer->stream(status.name);
+            streamer->stream(status.found);
+            uint32_t state;
+            if (streamer->writing()) state = static_cast<uint32_t>(status.state);
+            streamer->stream(state);
+            if (streamer->reading()) status.state = static_cast<Node::State>(state);
+        }
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "IStreamable.h"
+#include "Node.h"
+
+#include <filesystem>
+#include <vector>
+
+namespace YAM
+{
+    // The reply to a NodeStatusRequest: the state of the requested nodes in
+    // the GraphSnapshot with the given epoch.
+    class __declspec(dllexport) NodeStatusResult : public IStreamable
+    {
+    public:
+        struct NodeStatus {
+            std::filesystem::path name;
+            // Whether the node was found in the snapshot. When false the
+            // state is meaningless.
+            bool found;
+            Node::State state;
+
+            bool operator==(NodeStatus const& rhs) const = default;
+        };
+
+        NodeStatusResult();
+        NodeStatusResult(IStreamer* reader);
+
+        // Set/get the epoch of the snapshot from which the status was taken.
+        void epoch(uint64_t newEpoch);
+        uint64_t epoch() const;
+
+        void add(NodeStatus const& status);
+        std::vector<NodeStatus> const& nodes() const;
+
+        static void setStreamableType(uint32_t type);
+        // Inherited via IStreamable
+        uint32_t typeId() const override;
+        void stream(IStreamer* streamer) override;
+
+    private:
+        uint64_t _epoch;
+        std::vector<NodeStatus> _nodes;
+    };
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "IPriorityDispatcher.h"
+#include "Thread.h"
+
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <utility>
+
+namespace YAM
+{
+    // NodeTask is the return type of coroutines that implement node
+    // execution logic, e.g. CommandNode::execute(..).
+    //
+    // Node execution logic used to be a chain of member functions in which
+    // each function pushes the next one to the main thread queue or to a
+    // thread pool queue. A coroutine replaces such a chain by one function
+    // that suspends when it must switch thread, see ResumeOn, and when it
+    // must wait for completion of other nodes, see Node::awaitNodes(..).
+    // Besides being easier to read this avoids queue round-trips: the
+    // coroutine continues without suspension when the awaited nodes need
+    // no execution or when it is already running in the requested thread.
+    //
+    // Calling the coroutine returns a NodeTask that must be started by
+    // calling start(). The coroutine then runs until its first suspension.
+    // The coroutine frame is destroyed when the coroutine returns or when
+    // the NodeTask is destroyed without being started. A NodeTask cannot
+    // be awaited: completion of node execution is notified as usual by
+    // calling Node::notifyCompletion(..).
+    // An exception that escapes the coroutine is rethrown by the function
+    // that (re)started it: by start() or, after suspension, by the resume
+    // delegate that an awaiter pushed to a dispatcher, see resume(..).
+    //
+    class [[nodiscard]] NodeTask
+    {
+    public:
+        struct promise_type {
+            NodeTask get_return_object() noexcept {
+                return NodeTask(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+            std::suspend_always initial_suspend() const noexcept { return {}; }
+            std::suspend_never final_suspend() const noexcept { return {}; }
+            void return_void() const noexcept {}
+            void unhandled_exception() noexcept { *_exception = std::current_exception(); }
+
+            // Set by resume(..) before each resumption.
+            std::exception_ptr* _exception = nullptr;
+        };
+
+        NodeTask(NodeTask&& other) noexcept
+            : _handle(std::exchange(other._handle, nullptr))
+        {}
+        NodeTask(NodeTask const&) = delete;
+        NodeTask& operator=(NodeTask const&) = delete;
+        NodeTask& operator=(NodeTask&&) = delete;
+
+        ~NodeTask() {
+            if (_handle) _handle.destroy();
+        }
+
+        // Run the coroutine until its first suspension.
+        void start() {
+            resume(std::exchange(_handle, nullptr));
+        }
+
+        // Resume the coroutine. Rethrow the exception that escapes the
+        // coroutine before its next suspension.
+        // To be used by awaiters to resume a suspended coroutine.
+        static void resume(std::coroutine_handle<promise_type> handle) {
+            std::exception_ptr exception;
+            handle.promise()._exception = &exception;
+            handle.resume();
+            if (exception) std::rethrow_exception(exception);
+        }
+
+    private:
+        explicit NodeTask(std::coroutine_handle<promise_type> handle)
+            : _handle(handle)
+        {}
+
+        std::coroutine_handle<promise_type> _handle;
+    };
+
+    // Awaitable that resumes the awaiting coroutine by pushing it to a
+    // dispatcher. When 'thread' is not null and the coroutine is already
+    // running in 'thread' the coroutine continues without suspension.
+    // Usage:
+    //     co_await ResumeOn(context()->ioQueue(), PriorityClass::High);
+    //     ...code executed by an io thread...
+    //     co_await ResumeOn(context()->mainThreadQueue(), PriorityClass::Medium, &context()->mainThread());
+    //     ...code executed by main thread...
+    //
+    // Note: the coroutine may be resumed, and may even complete, before
+    // push returns. Hence await_suspend must not access the coroutine
+    // frame, nor this awaiter, after the push.
+    //
+    class ResumeOn
+    {
+    public:
+        ResumeOn(IPriorityDispatcher& dispatcher, uint32_t prio, Thread const* thread = nullptr)
+            : _dispatcher(dispatcher)
+            , _prio(prio)
+            , _thread(thread)
+        {}
+
+        ResumeOn(IPriorityDispatcher& dispatcher, PriorityClass prio, Thread const* thread = nullptr)
+            : ResumeOn(dispatcher, dispatcher.priorityOf(prio), thread)
+        {}
+
+        bool await_ready() const {
+            return _thread != nullptr && _thread->isThisThread();
+        }
+
+        void await_suspend(std::coroutine_handle<NodeTask::promise_type> handle) const {
+            _dispatcher.push(
+                Delegate<void>::CreateLambda([handle]() { NodeTask::resume(handle); }),
+                _prio);
+        }
+
+        void await_resume() const noexcept {}
+
+    private:
+        IPriorityDispatcher& _dispatcher;
+        uint32_t _prio;
+        Thread const* _thread;
+    };
+}
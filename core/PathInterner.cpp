@@ -0,0 +1,136 @@
+#include "PathInterner.h"
+
+#include <mutex>
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    std::size_t heapSize(std::filesystem::path::string_type const& s) {
+        return s.capacity() > std::filesystem::path::string_type().capacity()
+            ? (s.capacity() + 1) * sizeof(std::filesystem::path::value_type)
+            : 0;
+    }
+}
+
+namespace YAM
+{
+    PathInterner::PathInterner()
+        : _size(0)
+        , _memoryUsage(0)
+    {
+        for (auto& segment : _segments) segment = nullptr;
+        Entry* segment = new Entry[std::size_t(1) << firstSegmentBits];
+        _segments[0] = segment;
+        _memoryUsage += (std::size_t(1) << firstSegmentBits) * sizeof(Entry);
+        _size = 1; // emptyId
+        segment[emptyId].interned = true;
+    }
+
+    PathInterner::~PathInterner() {
+        for (auto& segment : _segments) delete[] segment.load();
+    }
+
+    PathInterner& PathInterner::names() {
+        static PathInterner interner;
+        return interner;
+    }
+
+    PathInterner::Id PathInterner::intern(std::filesystem::path const& path) {
+        Id id;
+        {
+            std::shared_lock<std::shared_mutex> lock(_mutex);
+            id = findLocked(path);
+            if (id != invalidId && entry(id).interned) return id;
+        }
+
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+        id = emptyId;
+        for (auto const& component : path) {
+            auto it = _children.find(Key{ id, component.native() });
+            id = (it == _children.end()) ? add(id, component) : it->second;
+        }
+        if (!entry(id).interned) storePath(id);
+        return id;
+    }
+
+    PathInterner::Id PathInterner::find(std::filesystem::path const& path) const {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        return findLocked(path);
+    }
+
+    std::filesystem::path PathInterner::rebuildPath(Id id) const {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        return rebuildPathLocked(id);
+    }
+
+    std::filesystem::path PathInterner::rebuildPathLocked(Id id) const {
+        std::vector<Entry const*> components;
+        Entry const* e = &entry(id);
+        for (; !e->interned; e = &entry(e->parent)) components.push_back(e);
+        std::filesystem::path path = e->path;
+        for (auto it = components.rbegin(); it != components.rend(); ++it) path /= (*it)->path;
+        return path;
+    }
+
+    PathInterner::Id PathInterner::findLocked(std::filesystem::path const& path) const {
+        Id id = emptyId;
+        for (auto const& component : path) {
+            auto it = _children.find(Key{ id, component.native() });
+            if (it == _children.end()) return invalidId;
+            id = it->second;
+        }
+        return id;
+    }
+
+    // Pre: _mutex is locked exclusively
+    PathInterner::Id PathInterner::add(Id parent, std::filesystem::path const& component) {
+        Id id = _size;
+        if (id == invalidId) throw std::runtime_error("PathInterner is full");
+        uint64_t v = uint64_t(id) + (1ull << firstSegmentBits);
+        uint32_t segment = static_cast<uint32_t>(std::bit_width(v)) - 1 - firstSegmentBits;
+        if (_segments[segment].load(std::memory_order_relaxed) == nullptr) {
+            std::size_t segmentSize = std::size_t(1) << (segment + firstSegmentBits);
+            _segments[segment].store(new Entry[segmentSize], std::memory_order_release);
+            _memoryUsage += segmentSize * sizeof(Entry);
+        }
+        Entry& e = const_cast<Entry&>(entry(id));
+        e.parent = parent;
+        e.path = component;
+        _children.insert({ Key{ parent, e.path.native() }, id });
+        _size = id + 1;
+
+        _memoryUsage += heapSize(e.path.native());
+        // approximation of hash table node and bucket
+        _memoryUsage += sizeof(Key) + sizeof(Id) + 3 * sizeof(void*);
+        return id;
+    }
+
+    // Replace the component of id by its full path.
+    // Pre: _mutex is locked exclusively, !entry(id).interned
+    void PathInterner::storePath(Id id) {
+        Entry& e = const_cast<Entry&>(entry(id));
+        std::filesystem::path path = rebuildPathLocked(id);
+        ComponentView native(path.native());
+        std::size_t componentSize = e.path.native().size();
+        ComponentView tail = native.substr(native.size() - std::min(native.size(), componentSize));
+        if (tail != e.path.native()) throw std::runtime_error("PathInterner: path does not end with component");
+        _children.erase(Key{ e.parent, e.path.native() });
+        _memoryUsage -= heapSize(e.path.native());
+        e.path = std::move(path);
+        e.interned = true;
+        native = e.path.native();
+        _children.insert({ Key{ e.parent, native.substr(native.size() - componentSize) }, id });
+        _memoryUsage += heapSize(e.path.native());
+    }
+
+    std::size_t PathInterner::size() const {
+        return _size;
+    }
+
+    std::size_t PathInterner::memoryUsage() const {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        return _memoryUsage;
+    }
+}
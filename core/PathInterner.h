@@ -0,0 +1,132 @@
+#pragma once
+
+#include <filesystem>
+#include <string_view>
+#include <unordered_map>
+#include <shared_mutex>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+
+namespace YAM
+{
+    // A PathInterner maps paths to 32-bit ids. Equal paths, as defined by
+    // std::filesystem::path::operator==, map to the same id.
+    //
+    // The interned paths are stored in a prefix trie: each id represents
+    // one path component and refers to the id of its parent path. Lookup
+    // of a path walks the trie component by component.
+    // An id that was returned by intern(..) stores its full path in order
+    // to return it by reference in path(id), see Node::name(). An id of a
+    // prefix that was not interned itself only stores its component, its
+    // full path is composed by rebuildPath(id).
+    // Note that directory nodes are interned as well, hence in a node
+    // graph nearly all entries store their full path.
+    //
+    // Interned paths are never removed: nodes, and GraphSnapshots of nodes
+    // that no longer exist, refer to names() by id and by reference.
+    // Interning a path that was interned before does not allocate, hence
+    // the size of names() is bounded by the number of distinct node names
+    // (and their prefixes) since process start, not by the number of
+    // builds, rescans or ExecutionContext::clearBuildState() calls. Only 
+    // a repository that keeps producing new file names, e.g. output files
+    // named after a timestamp, grows names() for the lifetime of yamServer.
+    // See memoryUsage().
+    //
+    // Class is MT-safe. path(id) does not lock.
+    //
+    class __declspec(dllexport) PathInterner
+    {
+    public:
+        typedef uint32_t Id;
+
+        // The id of the empty path.
+        static constexpr Id emptyId = 0;
+        // Returned by find(..) when path is not interned.
+        static constexpr Id invalidId = UINT32_MAX;
+
+        PathInterner();
+        ~PathInterner();
+
+        // Return the interner that is used for node names.
+        static PathInterner& names();
+
+        // Return the id of path, intern path when not yet interned.
+        Id intern(std::filesystem::path const& path);
+
+        // Return the id of path or invalidId when path is not interned.
+        Id find(std::filesystem::path const& path) const;
+
+        // Return the path identified by id.
+        // Pre: id was returned by intern(..)
+        std::filesystem::path const& path(Id id) const {
+            return entry(id).path;
+        }
+
+        // Return the path identified by id, composed from the components
+        // of id and of its ancestors.
+        // Pre: id was returned by intern(..), find(..) or parent(..)
+        std::filesystem::path rebuildPath(Id id) const;
+
+        // Return the id of the parent path of id.
+        // Pre: id != emptyId
+        Id parent(Id id) const {
+            return entry(id).parent;
+        }
+
+        // Return the number of interned ids, including emptyId.
+        std::size_t size() const;
+
+        // Return an estimate of the memory used by the interner.
+        std::size_t memoryUsage() const;
+
+    private:
+        typedef std::basic_string_view<std::filesystem::path::value_type> ComponentView;
+
+        // The path of an interned entry is the full path, else it is the
+        // component. The component is the tail of path.native(), hence 
+        // there is no need to store it separately.
+        struct Entry {
+            std::filesystem::path path;
+            Id parent = emptyId;
+            bool interned = false;
+        };
+
+        struct Key {
+            Id parent;
+            ComponentView component;
+            bool operator==(Key const& rhs) const {
+                return parent == rhs.parent && component == rhs.component;
+            }
+        };
+        struct KeyHash {
+            std::size_t operator()(Key const& key) const {
+                return std::hash<ComponentView>{}(key.component) ^ (std::size_t(key.parent) * 0x9E3779B97F4A7C15ull);
+            }
+        };
+
+        // Entries are stored in segments of increasing size to allow
+        // lock-free access while new entries are added. Segment s holds
+        // (firstSegmentSize << s) entries.
+        static constexpr uint32_t firstSegmentBits = 10;
+        static constexpr uint32_t nSegments = 33 - firstSegmentBits;
+
+        Entry const& entry(Id id) const {
+            uint64_t v = uint64_t(id) + (1ull << firstSegmentBits);
+            uint32_t segment = static_cast<uint32_t>(std::bit_width(v)) - 1 - firstSegmentBits;
+            uint64_t offset = v - (1ull << (segment + firstSegmentBits));
+            return _segments[segment].load(std::memory_order_acquire)[offset];
+        }
+
+        Id findLocked(std::filesystem::path const& path) const;
+        std::filesystem::path rebuildPathLocked(Id id) const;
+        Id add(Id parent, std::filesystem::path const& component);
+        void storePath(Id id);
+
+        mutable std::shared_mutex _mutex;
+        std::atomic<Entry*> _segments[nSegments];
+        std::atomic<uint32_t> _size;
+        std::unordered_map<Key, Id, KeyHash> _children;
+        std::size_t _memoryUsage;
+    };
+}
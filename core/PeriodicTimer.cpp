@@ -1,12 +1,12 @@
 #include "PeriodicTimer.h"
-#include "PriorityDispatcher.h"
+#include "IPriorityDispatcher.h"
 
 namespace YAM
 {
 
     PeriodicTimer::PeriodicTimer(
         std::chrono::system_clock::duration period,
-        PriorityDispatcher& dispatcher,
+        IPriorityDispatcher& dispatcher,
         Delegate<void> const &callback)
         : _period(period)
         , _dispatcher(dispatcher)
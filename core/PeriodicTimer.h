@@ -1,10 +1,12 @@
 #pragma once
 
 #include "Delegates.h"
-#include "PriorityDispatcher.h"
+#include "IPriorityDispatcher.h"
 
 #include <chrono>
 #include <thread>
+#include <mutex>
+#include <condition_variable>
 
 namespace YAM
 {
@@ -13,7 +15,7 @@ namespace YAM
     public:
         PeriodicTimer(
             std::chrono::system_clock::duration period,
-            PriorityDispatcher& dispatcher,
+            IPriorityDispatcher& dispatcher,
             Delegate<void> const &callback);
 
         ~PeriodicTimer();
@@ -25,7 +27,7 @@ namespace YAM
         void run();
 
         std::chrono::system_clock::duration _period;
-        PriorityDispatcher& _dispatcher;
+        IPriorityDispatcher& _dispatcher;
         Delegate<void> _callback;
         std::mutex _mutex;
         std::condition_variable _cond;
@@ -106,6 +106,11 @@ namespace YAM
 {
     PersistentBuildState::Key nullPtrKey = UINT64_MAX;
 
+    // The tree that stores the file aspect names of the build state, see
+    // FileAspectIndexMap. The tree index is not a node type id.
+    const BTree::TreeIndex aspectNamesTreeIndex = 255;
+    const PersistentBuildState::Key aspectNamesKey = 0;
+
     // Class that allocates unique type ids to the node classes. 
     class BuildStateTypes
     {
@@ -170,16 +175,16 @@ namespace YAM
             switch (tid) {
             case TypeId::BuildFileCompilerNode: return std::make_shared<YAM::BuildFileCompilerNode>();
             case TypeId::BuildFileParserNode: return std::make_shared<YAM::BuildFileParserNode>();
-            case TypeId::CommandNode: return std::make_shared<YAM::CommandNode>();
-            case TypeId::DirectoryNode: return std::make_shared<YAM::DirectoryNode>();
+            case TypeId::CommandNode: return makeShared<YAM::CommandNode>();
+            case TypeId::DirectoryNode: return makeShared<YAM::DirectoryNode>();
             case TypeId::DotIgnoreNode: return std::make_shared<YAM::DotIgnoreNode>();
             case TypeId::FileExecSpecsNode: return std::make_shared<YAM::FileExecSpecsNode>();
             case TypeId::ForEachNode: return std::make_shared<YAM::ForEachNode>();
-            case TypeId::GeneratedFileNode: return std::make_shared<YAM::GeneratedFileNode>();
+            case TypeId::GeneratedFileNode: return makeShared<YAM::GeneratedFileNode>();
             case TypeId::GlobNode: return std::make_shared<YAM::GlobNode>();
             case TypeId::GroupNode: return std::make_shared<YAM::GroupNode>();
             case TypeId::RepositoriesNode: return std::make_shared<YAM::RepositoriesNode>();
-            case TypeId::SourceFileNode: return std::make_shared<YAM::SourceFileNode>();
+            case TypeId::SourceFileNode: return makeShared<YAM::SourceFileNode>();
             case TypeId::FileRepositoryNode: return std::make_shared<YAM::FileRepositoryNode>();
             default: throw std::exception("unknown node type");
             }
@@ -324,6 +329,13 @@ namespace YAM
         return forest;
     }
 
+    BTree::StreamingTree<PersistentBuildState::Key>* createAspectNamesTree(BTree::Forest& forest) {
+        if (forest.contains(aspectNamesTreeIndex)) {
+            return forest.accessStreamingTree<PersistentBuildState::Key>(aspectNamesTreeIndex);
+        }
+        return forest.plantStreamingTree<PersistentBuildState::Key>(aspectNamesTreeIndex);
+    }
+
 }
 
 namespace YAM
@@ -336,6 +348,7 @@ namespace YAM
         , _context(context)
         , _pool(createPagePool(stateFile))
         , _forest(createForest(*_pool, _typeToTree))
+        , _aspectNamesTree(createAspectNamesTree(*_forest))
         , _nextId(1)
     {
     }
@@ -359,6 +372,7 @@ namespace YAM
 
     void PersistentBuildState::retrieve() {
         reset();
+        retrieveAspectNames();
         retrieveAll();
         for (auto const& pair : _keyToObject) {
             auto key = pair.first;
@@ -451,6 +465,29 @@ namespace YAM
         btreeVReader.close();
     }
 
+    void PersistentBuildState::retrieveAspectNames() {
+        std::vector<std::string> names;
+        if (_aspectNamesTree->contains(aspectNamesKey)) {
+            auto& btreeVReader = _aspectNamesTree->at(aspectNamesKey);
+            YAM::ValueStreamer vReader(btreeVReader);
+            Streamer reader(&vReader, nullptr);
+            reader.streamVector(names);
+            btreeVReader.close();
+        }
+        _context->fileAspectIndexMap().names(names);
+    }
+
+    void PersistentBuildState::storeAspectNames() {
+        FileAspectIndexMap& map = _context->fileAspectIndexMap();
+        std::vector<std::string> names = map.names();
+        auto& btreeVWriter = _aspectNamesTree->insert(aspectNamesKey);
+        YAM::ValueStreamer vWriter(btreeVWriter);
+        Streamer writer(&vWriter, nullptr);
+        writer.streamVector(names);
+        btreeVWriter.close();
+        map.modified(false);
+    }
+
     // Called by SharedPersistableReader to get the object stored at key
     std::shared_ptr<IPersistable> PersistentBuildState::getObject(Key key) {
         std::shared_ptr<IPersistable> object; 
@@ -534,6 +571,8 @@ namespace YAM
             store(_deletedObjectToKey[p.get()], p);
             p->modified(false);
         }
+        // Storing file nodes may have added aspect names.
+        if (_context->fileAspectIndexMap().modified()) storeAspectNames();
         auto replaceDeletedTime = std::chrono::system_clock::now();
 
         if (_context->logBook()->mustLogAspect(LogRecord::Performance)) {
@@ -707,11 +746,16 @@ namespace YAM
             addToBuildState(object);
         }
 
-        if (!toReplace.empty()) {
+        if (!toReplace.empty() || !toAdd.empty()) {
+            // Restore only the re-streamed objects: restoring a FileNode maps
+            // its streamed hashes to process aspect indices.
             std::unordered_set<IPersistable const*> restored;
             for (auto const& pair : _objectToKey) {
                 restored.insert(pair.first);
             }
+            for (auto const& pair : _deletedObjectToKey) {
+                restored.insert(pair.first);
+            }
             for (auto const& object : toReplace) {
                 restored.erase(object.get());
             }
@@ -87,6 +87,8 @@ namespace YAM
         void retrieveAll();
         void retrieveKey(Key key);
         void retrieveKey(Key key, BTree::ValueReader<Key>& reader);
+        void retrieveAspectNames();
+        void storeAspectNames();
 
         Key bindToKey(std::shared_ptr<IPersistable> const& object);
         Key allocateKey(IPersistable* object);
@@ -104,6 +106,8 @@ namespace YAM
         ExecutionContext* _context;
 
         std::map<BTree::TreeIndex, BTree::StreamingTree<Key>*> _typeToTree;
+        // Stores the aspect names of _context->fileAspectIndexMap().
+        BTree::StreamingTree<Key>* _aspectNamesTree;
         std::shared_ptr<BTree::PersistentPagePool> _pool;
         std::shared_ptr<BTree::Forest> _forest;
 
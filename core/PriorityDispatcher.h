@@ -1,7 +1,6 @@
 #pragma once
 
-#include "Delegates.h"
-#include "PriorityClass.h"
+#include "IPriorityDispatcher.h"
 
 #include <queue>
 #include <map>
@@ -10,11 +9,11 @@
 
 namespace YAM
 {
-    class IDispatcherFrame;
-
     // Thread-safe FIFO priority queue.
     // Priorities range from 0 up to a given maximum.
-    class __declspec(dllexport) PriorityDispatcher
+    // All producers and consumers share one mutex. For the thread pool queue
+    // see WorkStealingDispatcher.
+    class __declspec(dllexport) PriorityDispatcher : public IPriorityDispatcher
     {
     public:
         // Construct dispatcher for priorities in range [0, nPriorities-1] 
@@ -22,48 +21,46 @@ namespace YAM
         // Memory complexity for empty queue is O(nPriorities).
         PriorityDispatcher(uint32_t nPriorities);
 
-        uint32_t nPriorities() const { return static_cast<uint32_t>(_queues.size()); }
-        uint32_t maxPriority() const { return nPriorities() - 1; }
-        uint32_t priorityOf(PriorityClass prio) const;
+        uint32_t nPriorities() const override { return static_cast<uint32_t>(_queues.size()); }
+        uint32_t priorityOf(PriorityClass prio) const override;
 
         // Append element to end of queue for given priority.
-        void push(Delegate<void>& newAction, uint32_t prio);
-        void push(Delegate<void>&& newAction, uint32_t prio);
-        void push(Delegate<void>& newAction, PriorityClass prio = PriorityClass::Medium);
-        void push(Delegate<void>&& newAction, PriorityClass prio = PriorityClass::Medium);
+        void push(Delegate<void>& newAction, uint32_t prio) override;
+        void push(Delegate<void>&& newAction, uint32_t prio) override;
+        void push(Delegate<void>& newAction, PriorityClass prio = PriorityClass::Medium) override;
+        void push(Delegate<void>&& newAction, PriorityClass prio = PriorityClass::Medium) override;
 
         // Block calling thread until (!empty() && !suspended()) || stopped(). 
         // When !stopped(): remove+return highest priority element from queue.
         // When stopped(): return delegate that is not bound.
-        Delegate<void> pop();
+        Delegate<void> pop() override;
 
         // Return number of elements in queue.
-        std::size_t size();
+        std::size_t size() override;
 
         // Return whether queue is empty.
-        bool empty();
+        bool empty() override;
 
         // Suspend dispatching until resumed. Also see pop()
-        void suspend();
-        void resume();
-        bool suspended();
+        void suspend() override;
+        void resume() override;
+        bool suspended() override;
 
         // Start dispatching, see pop()
-        void start();
+        void start() override;
 
         // Stop dispatching, see pop()
-        void stop();
+        void stop() override;
 
         // Return wether dispatcher is started/stopped.
-        bool started() { return !stopped(); }
-        bool stopped();
+        bool stopped() override;
 
         // Pop a delegate from queue and execute it.
-        void popAndExecute();
+        void popAndExecute() override;
 
         // Execute the following loop: 
         //     while (!stopped()) popAndExecute();
-        void run();
+        void run() override;
 
         // Execute the following loop: 
         //     while (!frame.stopped() && !stopped()) popAndExecute();
@@ -80,7 +77,7 @@ namespace YAM
         //         // the stop event have been processed.
         //         dispatcher->run(frame);
         //     }
-        void run(IDispatcherFrame* frame);
+        void run(IDispatcherFrame* frame) override;
 
     private:
         bool _suspended;
@@ -242,7 +242,7 @@ namespace YAM
     )
         : Node(context, "repositories")
         , _ignoreConfigFile(true)
-        , _configFile(std::make_shared<SourceFileNode>(context, homeRepo->symbolicDirectory()/ RepositoriesNode::configFilePath()))
+        , _configFile(makeShared<SourceFileNode>(context, homeRepo->symbolicDirectory()/ RepositoriesNode::configFilePath()))
         , _homeRepo(homeRepo)
         , _configFileHash(rand())
         , _modified(true)
@@ -362,7 +362,7 @@ namespace YAM
     void RepositoriesNode::handleRequisitesCompletion(Node::State newState) {
         if (newState != Node::State::Ok) {
             notifyCompletion(newState);
-        } else if (_configFileHash == _configFile->hashOf(FileAspect::entireFileAspect().name())) {
+        } else if (_configFileHash == _configFile->hashOf(FileAspect::entireFileAspect())) {
             notifyCompletion(Node::State::Ok);
         } else {
             std::stringstream ss;
@@ -373,7 +373,7 @@ namespace YAM
             LogRecord change(LogRecord::FileChanges, ss.str());
             context()->addToLogBook(change);
 
-            _configFileHash = _configFile->hashOf(FileAspect::entireFileAspect().name());
+            _configFileHash = _configFile->hashOf(FileAspect::entireFileAspect());
             if (parseAndUpdate()) {
                 notifyCompletion(Node::State::Ok);
             } else {
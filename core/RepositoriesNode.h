@@ -94,6 +94,7 @@ namespace YAM
         // Inherited from Node
         void start(PriorityClass prio) override;
         std::string className() const override { return "RepositoriesNode"; }
+        NodeKind kind() const override { return NodeKind::Repositories; }
 
         static void setStreamableType(uint32_t type);
         // Inherited from IStreamer (via IPersistable)
@@ -0,0 +1,20 @@
+#include "ResourceClaim.h"
+#include "IStreamer.h"
+
+namespace YAM
+{
+    XXH64_hash_t ResourceClaim::hash() const {
+        XXH64_hash_t hashes[3] = { XXH64_string(pool), capacity, tokens };
+        return XXH64(hashes, sizeof(hashes), 0);
+    }
+
+    void ResourceClaim::stream(IStreamer* streamer) {
+        streamer->stream(pool);
+        streamer->stream(capacity);
+        streamer->stream(tokens);
+    }
+
+    bool ResourceClaim::operator==(ResourceClaim const& rhs) const {
+        return pool == rhs.pool && capacity == rhs.capacity && tokens == rhs.tokens;
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "xxhash.h"
+
+#include <string>
+#include <cstdint>
+
+namespace YAM
+{
+    class IStreamer;
+
+    // A ResourceClaim specifies the number of tokens that a command claims
+    // from a named resource pool for the duration of its script execution.
+    // The pool has a fixed number of tokens: its capacity. E.g. a pool 'link'
+    // with capacity 4 and commands that claim 1 token limits the number of
+    // concurrently executing link commands to 4. E.g. a pool 'memory' with
+    // capacity 32 (GB) and commands that claim their estimated memory usage
+    // limits the memory used by concurrently executing commands. 
+    // See ResourcePool.
+    struct __declspec(dllexport) ResourceClaim {
+        // Empty when no tokens are claimed.
+        std::string pool;
+        // Number of tokens in the pool.
+        uint32_t capacity = 0;
+        // Number of tokens claimed.
+        uint32_t tokens = 1;
+
+        bool empty() const { return pool.empty(); }
+        XXH64_hash_t hash() const;
+        void stream(IStreamer* streamer);
+        bool operator==(ResourceClaim const& rhs) const;
+    };
+}
@@ -0,0 +1,89 @@
+#include "ResourcePool.h"
+#include "IPriorityDispatcher.h"
+
+namespace YAM
+{
+    ResourcePool::ResourcePool(
+        std::string const& name,
+        uint32_t capacity,
+        IPriorityDispatcher& dispatcher)
+        : _name(name)
+        , _dispatcher(dispatcher)
+        , _capacity(capacity)
+        , _claimed(0)
+    {
+        if (capacity == 0) throw std::exception("resource pool capacity must be > 0");
+    }
+
+    void ResourcePool::capacity(uint32_t newCapacity) {
+        if (newCapacity == 0) throw std::exception("resource pool capacity must be > 0");
+        std::vector<std::pair<Delegate<void>, uint32_t>> admitted;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _capacity = newCapacity;
+            for (auto& pair : _waiting) {
+                if (pair.second.tokens > _capacity) pair.second.tokens = _capacity;
+            }
+            admitWaiting(admitted);
+        }
+        push(admitted);
+    }
+
+    uint32_t ResourcePool::capacity() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _capacity;
+    }
+
+    uint32_t ResourcePool::available() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _claimed < _capacity ? _capacity - _claimed : 0;
+    }
+
+    std::size_t ResourcePool::nWaiting() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _waiting.size();
+    }
+
+    void ResourcePool::admit(Delegate<void>&& action, uint32_t prio, uint32_t tokens) {
+        std::vector<std::pair<Delegate<void>, uint32_t>> admitted;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (tokens > _capacity) tokens = _capacity;
+            _waiting.insert({ prio, Waiting{ std::move(action), tokens } });
+            admitWaiting(admitted);
+        }
+        push(admitted);
+    }
+
+    void ResourcePool::release(uint32_t tokens) {
+        std::vector<std::pair<Delegate<void>, uint32_t>> admitted;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (tokens > _claimed) throw std::exception("released more tokens than claimed");
+            _claimed -= tokens;
+            admitWaiting(admitted);
+        }
+        push(admitted);
+    }
+
+    void ResourcePool::admitWaiting(std::vector<std::pair<Delegate<void>, uint32_t>>& admitted) {
+        while (!_waiting.empty()) {
+            auto it = _waiting.begin();
+            if (_claimed + it->second.tokens > _capacity) break;
+            uint32_t tokens = it->second.tokens;
+            _claimed += tokens;
+            auto self = shared_from_this();
+            auto execute = Delegate<void>::CreateLambda(
+                [self, action = std::move(it->second.action), tokens]() {
+                    action.Execute();
+                    self->release(tokens);
+                });
+            admitted.push_back({ std::move(execute), it->first });
+            _waiting.erase(it);
+        }
+    }
+
+    void ResourcePool::push(std::vector<std::pair<Delegate<void>, uint32_t>>& admitted) {
+        for (auto& pair : admitted) _dispatcher.push(std::move(pair.first), pair.second);
+    }
+}
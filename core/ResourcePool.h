@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Delegates.h"
+
+#include <string>
+#include <map>
+#include <mutex>
+#include <functional>
+#include <memory>
+
+namespace YAM
+{
+    class IPriorityDispatcher;
+
+    // A ResourcePool limits the concurrent execution of delegates that use
+    // a scarce resource, e.g. memory-hungry link commands.
+    //
+    // The pool has capacity() tokens. A delegate is admitted to the 
+    // dispatcher only when the tokens it claims are available. Delegates 
+    // that cannot be admitted wait in the pool, not in the dispatcher, so
+    // that the dispatcher threads remain available for delegates that do
+    // not claim tokens. Waiting delegates are admitted in priority order
+    // when tokens are released. A waiting delegate that claims more tokens
+    // than available blocks admission of lower priority delegates to avoid
+    // its starvation.
+    //
+    // Class is MT-safe.
+    //
+    class __declspec(dllexport) ResourcePool : public std::enable_shared_from_this<ResourcePool>
+    {
+    public:
+        // Construct pool with given capacity. Admitted delegates are pushed
+        // to dispatcher.
+        ResourcePool(std::string const& name, uint32_t capacity, IPriorityDispatcher& dispatcher);
+
+        std::string const& name() const { return _name; }
+
+        // Set/get the number of tokens in the pool.
+        // Pre: newCapacity > 0
+        void capacity(uint32_t newCapacity);
+        uint32_t capacity();
+
+        // Return the number of tokens that are not claimed.
+        uint32_t available();
+
+        // Return the number of delegates that wait for tokens.
+        std::size_t nWaiting();
+
+        // Claim 'tokens' tokens and push 'action' to the dispatcher with 
+        // priority 'prio'. When not enough tokens are available: wait until
+        // enough tokens are released. The tokens are released when 'action'
+        // has been executed.
+        // Claims larger than capacity() are reduced to capacity().
+        // Pre: pool is owned by a std::shared_ptr
+        void admit(Delegate<void>&& action, uint32_t prio, uint32_t tokens);
+
+    private:
+        struct Waiting {
+            Delegate<void> action;
+            uint32_t tokens;
+        };
+
+        void release(uint32_t tokens);
+        void admitWaiting(std::vector<std::pair<Delegate<void>, uint32_t>>& admitted);
+        void push(std::vector<std::pair<Delegate<void>, uint32_t>>& admitted);
+
+        std::string _name;
+        IPriorityDispatcher& _dispatcher;
+        std::mutex _mutex;
+        uint32_t _capacity;
+        uint32_t _claimed;
+        // Waiting delegates in priority order, FIFO for equal priority.
+        std::multimap<uint32_t, Waiting, std::greater<uint32_t>> _waiting;
+    };
+}
@@ -0,0 +1,201 @@
+#include "SlabAllocator.h"
+
+#include <vector>
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace
+{
+    using namespace YAM;
+
+    std::size_t const minSlabSize = 64 * 1024;
+    std::size_t const minBlocksPerSlab = 16;
+
+    std::size_t roundUp(std::size_t size, std::size_t alignment) {
+        return (size + alignment - 1) / alignment * alignment;
+    }
+
+    // Return size bytes of memory aligned at size.
+    // Slabs are allocated from the system instead of by aligned operator
+    // new because the MSVC aligned operator new over-allocates by the
+    // alignment, i.e. would commit up to twice the slab size.
+    // Pre: size is a power of 2 multiple of 64 KB.
+    void* allocateSlab(std::size_t size) {
+#if defined(_WIN32)
+        // VirtualAlloc aligns at the 64 KB allocation granularity. A larger
+        // slab is allocated at an aligned address found by reserving twice
+        // the slab size.
+        void* memory = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+        if (memory == nullptr) throw std::bad_alloc();
+        if ((reinterpret_cast<std::uintptr_t>(memory) & (size - 1)) == 0) return memory;
+        VirtualFree(memory, 0, MEM_RELEASE);
+        for (int attempt = 0; attempt < 16; ++attempt) {
+            void* reserved = VirtualAlloc(nullptr, 2 * size, MEM_RESERVE, PAGE_NOACCESS);
+            if (reserved == nullptr) throw std::bad_alloc();
+            auto aligned = roundUp(reinterpret_cast<std::uintptr_t>(reserved), size);
+            VirtualFree(reserved, 0, MEM_RELEASE);
+            // Fails when another thread reserved the address meanwhile.
+            memory = VirtualAlloc(reinterpret_cast<void*>(aligned), size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+            if (memory != nullptr) return memory;
+        }
+        throw std::bad_alloc();
+#else
+        // Map twice the slab size and unmap the unaligned head and tail.
+        void* reserved = mmap(nullptr, 2 * size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (reserved == MAP_FAILED) throw std::bad_alloc();
+        auto address = reinterpret_cast<std::uintptr_t>(reserved);
+        auto aligned = roundUp(address, size);
+        if (aligned > address) munmap(reserved, aligned - address);
+        munmap(reinterpret_cast<void*>(aligned + size), address + size - aligned);
+        return reinterpret_cast<void*>(aligned);
+#endif
+    }
+
+    void freeSlab(void* slab, std::size_t size) {
+#if defined(_WIN32)
+        VirtualFree(slab, 0, MEM_RELEASE);
+#else
+        munmap(slab, size);
+#endif
+    }
+
+    std::mutex poolsMutex;
+    std::vector<SlabPool*>& pools() {
+        static std::vector<SlabPool*>* pools = new std::vector<SlabPool*>();
+        return *pools;
+    }
+}
+
+namespace YAM
+{
+    // The header of a slab is located at the start of the slab.
+    // A free block stores the pointer to the next free block.
+    struct SlabPool::Slab {
+        Slab* previous;
+        Slab* next;
+        void* freeBlocks;
+        // Blocks at index >= nTouched have never been allocated.
+        std::size_t nTouched;
+        std::size_t nUsed;
+    };
+
+    SlabPool::SlabPool(std::size_t blockSize, std::size_t alignment)
+        : _available(nullptr)
+        , _empty(nullptr)
+        , _nSlabs(0)
+        , _nBlocks(0)
+    {
+        if (alignment < alignof(void*)) alignment = alignof(void*);
+        _blockSize = roundUp(blockSize < sizeof(void*) ? sizeof(void*) : blockSize, alignment);
+        _headerSize = roundUp(sizeof(Slab), alignment);
+        _slabSize = minSlabSize;
+        while (_slabSize < _headerSize + minBlocksPerSlab * _blockSize) _slabSize *= 2;
+        _blocksPerSlab = (_slabSize - _headerSize) / _blockSize;
+        std::lock_guard<std::mutex> lock(poolsMutex);
+        pools().push_back(this);
+    }
+
+    SlabPool::Slab* SlabPool::newSlab() {
+        void* memory = allocateSlab(_slabSize);
+        Slab* slab = static_cast<Slab*>(memory);
+        slab->previous = nullptr;
+        slab->next = nullptr;
+        slab->freeBlocks = nullptr;
+        slab->nTouched = 0;
+        slab->nUsed = 0;
+        _nSlabs += 1;
+        return slab;
+    }
+
+    void SlabPool::link(Slab*& list, Slab* slab) {
+        slab->previous = nullptr;
+        slab->next = list;
+        if (list != nullptr) list->previous = slab;
+        list = slab;
+    }
+
+    void SlabPool::unlink(Slab*& list, Slab* slab) {
+        if (slab->previous != nullptr) slab->previous->next = slab->next;
+        if (slab->next != nullptr) slab->next->previous = slab->previous;
+        if (list == slab) list = slab->next;
+        slab->previous = nullptr;
+        slab->next = nullptr;
+    }
+
+    // Allocate from partially used slabs first to give other slabs a
+    // chance to become empty.
+    void* SlabPool::allocate() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_available == nullptr) {
+            Slab* slab = _empty;
+            if (slab != nullptr) {
+                unlink(_empty, slab);
+            } else {
+                slab = newSlab();
+            }
+            link(_available, slab);
+        }
+        Slab* slab = _available;
+        void* block;
+        if (slab->freeBlocks != nullptr) {
+            block = slab->freeBlocks;
+            slab->freeBlocks = *static_cast<void**>(block);
+        } else {
+            block = reinterpret_cast<char*>(slab) + _headerSize + slab->nTouched * _blockSize;
+            slab->nTouched += 1;
+        }
+        slab->nUsed += 1;
+        if (slab->nUsed == _blocksPerSlab) unlink(_available, slab);
+        _nBlocks += 1;
+        return block;
+    }
+
+    void SlabPool::deallocate(void* block) {
+        auto address = reinterpret_cast<std::uintptr_t>(block);
+        Slab* slab = reinterpret_cast<Slab*>(address & ~(std::uintptr_t(_slabSize) - 1));
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (slab->nUsed == _blocksPerSlab) link(_available, slab);
+        *static_cast<void**>(block) = slab->freeBlocks;
+        slab->freeBlocks = block;
+        slab->nUsed -= 1;
+        _nBlocks -= 1;
+        if (slab->nUsed == 0) {
+            unlink(_available, slab);
+            link(_empty, slab);
+        }
+    }
+
+    std::size_t SlabPool::releaseEmptySlabs() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::size_t nReleased = 0;
+        while (_empty != nullptr) {
+            Slab* slab = _empty;
+            unlink(_empty, slab);
+            freeSlab(slab, _slabSize);
+            _nSlabs -= 1;
+            nReleased += 1;
+        }
+        return nReleased;
+    }
+
+    std::size_t SlabPool::releaseAllEmptySlabs() {
+        std::lock_guard<std::mutex> lock(poolsMutex);
+        std::size_t nReleased = 0;
+        for (auto pool : pools()) nReleased += pool->releaseEmptySlabs();
+        return nReleased;
+    }
+
+    std::size_t SlabPool::nSlabs() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _nSlabs;
+    }
+
+    std::size_t SlabPool::nBlocks() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _nBlocks;
+    }
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+
+namespace YAM
+{
+    // A SlabPool allocates blocks of one fixed size from slabs. A slab is a
+    // large, slab-size aligned, chunk of memory that is divided in blocks.
+    // Allocating objects of one type from their own pool avoids that the
+    // graph's millions of long-living nodes fragment the heap over the
+    // uptime of yamServer.
+    //
+    // A slab whose blocks are all free is not returned to the system until
+    // releaseEmptySlabs() is called. This avoids repeated allocation and
+    // release of slabs when nodes are removed and added during a build.
+    //
+    // Pools are never destroyed because their blocks may be released during
+    // destruction of static objects.
+    //
+    // Class is MT-safe.
+    //
+    class __declspec(dllexport) SlabPool
+    {
+    public:
+        // Construct a pool for blocks of given size and alignment.
+        // The pool registers itself for releaseAllEmptySlabs().
+        SlabPool(std::size_t blockSize, std::size_t alignment);
+
+        // Return a block of blockSize() bytes.
+        void* allocate();
+
+        // Return block to the pool.
+        // Pre: block was allocated by this pool.
+        void deallocate(void* block);
+
+        // Release the slabs in which all blocks are free.
+        // Return the number of released slabs.
+        std::size_t releaseEmptySlabs();
+
+        // Call releaseEmptySlabs() on all pools.
+        // Return the number of released slabs.
+        static std::size_t releaseAllEmptySlabs();
+
+        std::size_t blockSize() const { return _blockSize; }
+        std::size_t slabSize() const { return _slabSize; }
+        // Return the number of allocated slabs.
+        std::size_t nSlabs();
+        // Return the number of allocated blocks.
+        std::size_t nBlocks();
+
+    private:
+        struct Slab;
+
+        Slab* newSlab();
+        static void link(Slab*& list, Slab* slab);
+        static void unlink(Slab*& list, Slab* slab);
+
+        std::size_t _blockSize;
+        std::size_t _slabSize;
+        std::size_t _headerSize;
+        std::size_t _blocksPerSlab;
+
+        std::mutex _mutex;
+        // Doubly linked lists of slabs that have both used and free blocks
+        // and of slabs that only have free blocks.
+        Slab* _available;
+        Slab* _empty;
+        std::size_t _nSlabs;
+        std::size_t _nBlocks;
+    };
+
+    // The SlabPool that is shared by all SlabAllocator<T, Tag> for given Tag.
+    template <class Tag>
+    class SlabPoolOf
+    {
+    public:
+        // Return the pool, null when not yet created.
+        static SlabPool* pool() { return _pool.load(std::memory_order_acquire); }
+
+        // Return the pool, create it for given block size and alignment
+        // when not yet created.
+        static SlabPool& pool(std::size_t blockSize, std::size_t alignment) {
+            SlabPool* p = pool();
+            if (p == nullptr) {
+                std::call_once(_created, [blockSize, alignment]() {
+                    _pool.store(new SlabPool(blockSize, alignment), std::memory_order_release);
+                });
+                p = pool();
+            }
+            return *p;
+        }
+
+    private:
+        inline static std::atomic<SlabPool*> _pool = nullptr;
+        inline static std::once_flag _created;
+    };
+
+    // Allocator that allocates single objects from SlabPoolOf<Tag>. 
+    // Rebinding to another type U preserves Tag, hence 
+    //     std::allocate_shared<T>(SlabAllocator<T>(), args...)
+    // allocates T and its shared_ptr control block in one block of the
+    // pool for T. See makeShared.
+    // Objects that do not fit in the pool's blocks, and arrays, are 
+    // allocated from the heap.
+    //
+    template <class T, class Tag = T>
+    class SlabAllocator
+    {
+    public:
+        typedef T value_type;
+        template <class U> struct rebind { typedef SlabAllocator<U, Tag> other; };
+
+        SlabAllocator() noexcept = default;
+        template <class U> SlabAllocator(SlabAllocator<U, Tag> const&) noexcept {}
+
+        T* allocate(std::size_t n) {
+            if (n == 1) {
+                SlabPool& pool = SlabPoolOf<Tag>::pool(sizeof(T), alignof(T));
+                if (fits(pool)) return static_cast<T*>(pool.allocate());
+            }
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+
+        void deallocate(T* p, std::size_t n) noexcept {
+            SlabPool* pool = SlabPoolOf<Tag>::pool();
+            if (n == 1 && pool != nullptr && fits(*pool)) {
+                pool->deallocate(p);
+            } else {
+                ::operator delete(p);
+            }
+        }
+
+        template <class U>
+        bool operator==(SlabAllocator<U, Tag> const&) const noexcept { return true; }
+        template <class U>
+        bool operator!=(SlabAllocator<U, Tag> const&) const noexcept { return false; }
+
+    private:
+        static bool fits(SlabPool const& pool) {
+            return sizeof(T) <= pool.blockSize() && pool.blockSize() % alignof(T) == 0;
+        }
+    };
+
+    // Return std::allocate_shared<T>(SlabAllocator<T>(), args...)
+    template <class T, class... Args>
+    std::shared_ptr<T> makeShared(Args&&... args) {
+        return std::allocate_shared<T>(SlabAllocator<T>(), std::forward<Args>(args)...);
+    }
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+
+namespace YAM
+{
+    // A SmallVectorSet is a set of trivially copyable values, e.g. pointers,
+    // that is optimized for sets that hold a few values. It replaces
+    // std::unordered_set<StateObserver*> for the observers of a node: most
+    // nodes have one to three observers while a few nodes, e.g. a header
+    // file included by all compilations, have many thousands.
+    //
+    // Up to N values are stored inline, i.e. without heap allocation. When
+    // the set overflows the values are moved to a heap array that grows by
+    // doubling. The set moves back inline when it has shrunk to N/2 values.
+    // Lookup is a linear search until the set exceeds indexThreshold values.
+    // Larger sets maintain a hash map from value to position.
+    //
+    // Values are stored contiguously in unspecified order. erase(..) moves
+    // the last value to the position of the erased value.
+    //
+    template <class T, std::size_t N>
+    class SmallVectorSet
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+        static_assert(N > 0, "N must be > 0");
+
+    public:
+        typedef T value_type;
+        typedef T const* const_iterator;
+        typedef const_iterator iterator;
+
+        static constexpr std::size_t indexThreshold = 32;
+
+        SmallVectorSet() : _size(0), _capacity(N) {}
+        SmallVectorSet(SmallVectorSet const&) = delete;
+        SmallVectorSet& operator=(SmallVectorSet const&) = delete;
+        ~SmallVectorSet() {
+            if (onHeap()) delete[] _heap;
+        }
+
+        const_iterator begin() const { return data(); }
+        const_iterator end() const { return data() + _size; }
+        std::size_t size() const { return _size; }
+        bool empty() const { return _size == 0; }
+
+        bool contains(T const& value) const {
+            return indexOf(value) != npos;
+        }
+
+        // Insert value when not in the set.
+        // Return whether value was inserted.
+        bool insert(T const& value) {
+            if (contains(value)) return false;
+            if (_size == _capacity) grow();
+            data()[_size] = value;
+            if (_index != nullptr) _index->insert({ value, _size });
+            _size += 1;
+            if (_index == nullptr && _size > indexThreshold) buildIndex();
+            return true;
+        }
+
+        // Remove value from the set.
+        // Return the number of removed values (0 or 1).
+        std::size_t erase(T const& value) {
+            T* values = data();
+            std::size_t last = _size - 1;
+            std::size_t i;
+            if (_index != nullptr) {
+                auto it = _index->find(value);
+                if (it == _index->end()) return 0;
+                i = it->second;
+                _index->erase(it);
+                if (i != last) _index->find(values[last])->second = static_cast<uint32_t>(i);
+            } else {
+                i = indexOf(value);
+                if (i == npos) return 0;
+            }
+            values[i] = values[last];
+            _size -= 1;
+            if (_index != nullptr && _size <= indexThreshold / 2) _index.reset();
+            if (onHeap() && _size <= N / 2) moveInline();
+            return 1;
+        }
+
+        void clear() {
+            _size = 0;
+            _index.reset();
+            if (onHeap()) moveInline();
+        }
+
+    private:
+        static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+        bool onHeap() const { return _capacity > N; }
+        T* data() { return onHeap() ? _heap : _inline; }
+        T const* data() const { return onHeap() ? _heap : _inline; }
+
+        std::size_t indexOf(T const& value) const {
+            if (_index != nullptr) {
+                auto it = _index->find(value);
+                return it == _index->end() ? npos : it->second;
+            }
+            T const* values = data();
+            for (std::size_t i = 0; i < _size; ++i) {
+                if (values[i] == value) return i;
+            }
+            return npos;
+        }
+
+        void grow() {
+            std::size_t capacity = 2 * static_cast<std::size_t>(_capacity);
+            if (capacity > UINT32_MAX) throw std::runtime_error("SmallVectorSet overflow");
+            T* values = new T[capacity];
+            std::memcpy(values, data(), _size * sizeof(T));
+            if (onHeap()) delete[] _heap;
+            _heap = values;
+            _capacity = static_cast<uint32_t>(capacity);
+        }
+
+        void moveInline() {
+            T* values = _heap;
+            std::memcpy(_inline, values, _size * sizeof(T));
+            delete[] values;
+            _capacity = N;
+        }
+
+        void buildIndex() {
+            _index = std::make_unique<std::unordered_map<T, uint32_t>>();
+            _index->reserve(2 * _size);
+            T const* values = data();
+            for (std::size_t i = 0; i < _size; ++i) _index->insert({ values[i], static_cast<uint32_t>(i) });
+        }
+
+        uint32_t _size;
+        // N when values are inline, else the size of _heap.
+        uint32_t _capacity;
+        union {
+            T _inline[N];
+            T* _heap;
+        };
+        // Position of each value, only when _size > indexThreshold.
+        std::unique_ptr<std::unordered_map<T, uint32_t>> _index;
+    };
+}
@@ -11,6 +11,7 @@ namespace  YAM
         SourceFileNode(ExecutionContext* context, std::filesystem::path const& name);
 
         std::string className() const override { return "SourceFileNode"; }
+        NodeKind kind() const override { return NodeKind::SourceFile; }
 
         static void setStreamableType(uint32_t type);
         // Inherited from IStreamable
@@ -1,11 +1,12 @@
 #include "Thread.h"
-#include "PriorityDispatcher.h"
+#include "IPriorityDispatcher.h"
+#include "DispatcherFrame.h"
 #include <Windows.h>
 
 namespace
 {
-    void run(YAM::PriorityDispatcher* dispatcher) {
-        dispatcher->run();
+    void run(YAM::IPriorityDispatcher* dispatcher, YAM::DispatcherFrame* frame) {
+        dispatcher->run(frame);
     }
 
         namespace {
@@ -58,10 +59,10 @@ namespace
 
 namespace YAM
 {
-    Thread::Thread(PriorityDispatcher* dispatcher, std::string const& name)
+    Thread::Thread(IPriorityDispatcher* dispatcher, std::string const& name)
         : _dispatcher(dispatcher)
         , _name(name)
-        , _thread(&run, _dispatcher)
+        , _thread(&run, _dispatcher, &_frame)
     {
         SetThreadName(&_thread, name.c_str());
     }
@@ -76,7 +77,7 @@ namespace YAM
         return _name;
     }
 
-    PriorityDispatcher* Thread::dispatcher() const {
+    IPriorityDispatcher* Thread::dispatcher() const {
         return _dispatcher;
     }
 
@@ -93,5 +94,9 @@ namespace YAM
         auto tid = std::this_thread::get_id();
         return id == tid;
     }
+
+    void Thread::stop() {
+        _frame.stop();
+    }
 }
 
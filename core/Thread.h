@@ -1,20 +1,23 @@
 #pragma once
 
+#include "DispatcherFrame.h"
+
 #include <thread>
 #include <string>
 
 namespace YAM
 {
-    class PriorityDispatcher;
+    class IPriorityDispatcher;
     class __declspec(dllexport) Thread
     {
     public:
-        // Construct (and start) a thread that executes dispatcher->run().
-        Thread(PriorityDispatcher* dispatcher, std::string const & name);
+        // Construct (and start) a thread that executes dispatcher->run(frame)
+        // where frame is owned by this thread. 
+        Thread(IPriorityDispatcher* dispatcher, std::string const & name);
         ~Thread();
 
         std::string const& name() const;
-        PriorityDispatcher* dispatcher() const;
+        IPriorityDispatcher* dispatcher() const;
 
         bool joinable();
         void join();
@@ -22,9 +25,16 @@ namespace YAM
         // Return whether call is made in this thread.
         bool isThisThread() const;
 
+        // Request the thread to stop after it has executed the delegate
+        // it is currently executing. Note that this does not unblock the
+        // thread when it is blocked in dispatcher()->pop(). Typically stop()
+        // is called from a delegate that is executed by this thread.
+        void stop();
+
     private:
-        PriorityDispatcher* _dispatcher;
+        IPriorityDispatcher* _dispatcher;
         std::string _name;
+        DispatcherFrame _frame;
         std::thread _thread;
     };
 }
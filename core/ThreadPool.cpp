@@ -1,55 +1,117 @@
 #include "ThreadPool.h"
 #include <sstream>
+#include <algorithm>
 
 namespace YAM
 {
-    ThreadPool::ThreadPool(PriorityDispatcher* dispatcher, std::string const& name, std::size_t nThreads)
+    ThreadPool::ThreadPool(IPriorityDispatcher* dispatcher, std::string const& name, std::size_t nThreads)
         : _dispatcher(dispatcher)
         , _name(name)
+        , _nRetiring(0)
+        , _nCreated(0)
     {
         size(nThreads);
     }
 
     ThreadPool::~ThreadPool() {
-        size(0);
+        // Stopping the dispatcher will stop all threads:
+        //        - threads busy executing a delegate run the delegate to completion and
+        //          then stop.
+        //        - threads blocked on pop-ing a delegate from the dispatcher will
+        //          unblock and stop. 
+        _dispatcher->stop();
+        _threads.clear(); // join with stopped threads (see Thread::~Thread)
+        _retired.clear();
+        _dispatcher->start();
     }
 
     std::size_t ThreadPool::size() const {
-        return  _threads.size();
+        std::lock_guard<std::mutex> lock(_mutex);
+        return  _threads.size() - _nRetiring;
     }
 
     void ThreadPool::size(std::size_t newSize) {
-        if (size() != newSize) {
-            // Stopping the dispatcher will stop all threads:
-            //        - threads busy executing a delegate run the delegate to completion and
-            //          then stop.
-            //        - threads blocked on pop-ing a delegate from the dispatcher will
-            //          unblock and stop. 
-            _dispatcher->stop();
-
-            // Clearing the threads vector will join with the threads (see Thread::~Thread)
-            // and hence block the calling thread for the time needed to complete the 
-            // delegates that were executing at time of size adjustment request. 
-            _threads.clear(); 
-
+        std::lock_guard<std::mutex> lock(_mutex);
+        joinRetired();
+        std::size_t currentSize = _threads.size() - _nRetiring;
+        if (currentSize < newSize) {
             // Newly created threads will finish immediately when the dispatcher is in
-            // stopped state. Hence restart dispatcher before creating new threads.
-            _dispatcher->start();
-
-            for (std::size_t i = 0; i < newSize; ++i) {
+            // stopped state, e.g. after join(). 
+            if (_threads.empty()) _dispatcher->start();
+            for (std::size_t i = currentSize; i < newSize; ++i) {
                 std::stringstream tname;
-                tname << _name << "_" << i;
-                auto t = std::make_shared<Thread>(_dispatcher, tname.str());
-                _threads.push_back(t);
+                tname << _name << "_" << _nCreated++;
+                _threads.push_back(std::make_shared<Thread>(_dispatcher, tname.str()));
+            }
+        } else {
+            for (std::size_t i = newSize; i < currentSize; ++i) {
+                _nRetiring++;
+                _dispatcher->push(Delegate<void>::CreateRaw(this, &ThreadPool::retire), _dispatcher->maxPriority());
             }
         }
     }
 
+    // Executed by the pool thread that pops the retire request.
+    void ThreadPool::retire() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = std::find_if(_threads.begin(), _threads.end(), [](std::shared_ptr<Thread> const& t) {
+            return t->isThisThread();
+        });
+        if (it == _threads.end()) {
+            // Not executed by a pool thread, leave request for a pool thread.
+            _dispatcher->push(Delegate<void>::CreateRaw(this, &ThreadPool::retire), _dispatcher->maxPriority());
+        } else {
+            (*it)->stop();
+            _retired.push_back(*it);
+            _threads.erase(it);
+            _nRetiring--;
+        }
+    }
+
+    // Retired threads have returned from retire() and only need to return
+    // from Thread::run. Joining them will therefore not block for long.
+    void ThreadPool::joinRetired() {
+        _retired.clear();
+    }
+
     void ThreadPool::join() {
-        if (0 < _threads.size()) {
+        std::vector<std::shared_ptr<Thread>> threads;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_threads.empty()) {
+                joinRetired();
+                return;
+            }
             // Finish all pending work before stopping dispatcher
-            _dispatcher->push(Delegate<void>::CreateRaw(_dispatcher, &PriorityDispatcher::stop), 0);
-            _threads.clear(); // join with stopped threads
+            _dispatcher->push(Delegate<void>::CreateRaw(this, &ThreadPool::stopWhenDrained), 0);
+        }
+        // Join without holding the mutex: pending retire requests still 
+        // need to acquire it.
+        while (true) {
+            std::shared_ptr<Thread> t;
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (_threads.empty()) break;
+                t = _threads.back();
+            }
+            t->join();
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto it = std::find(_threads.begin(), _threads.end(), t);
+            if (it != _threads.end()) _threads.erase(it);
+        }
+        std::lock_guard<std::mutex> lock(_mutex);
+        joinRetired();
+        _nRetiring = 0;
+    }
+
+    // A WorkStealingDispatcher does not guarantee FIFO order between its
+    // worker queues. The stop request is therefore re-queued until all
+    // pending work has been popped.
+    void ThreadPool::stopWhenDrained() {
+        if (_dispatcher->empty()) {
+            _dispatcher->stop();
+        } else {
+            _dispatcher->push(Delegate<void>::CreateRaw(this, &ThreadPool::stopWhenDrained), 0);
         }
     }
-}
\ No newline at end of file
+}
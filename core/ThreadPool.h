@@ -1,57 +1,69 @@
 #pragma once
 
-#include "PriorityDispatcher.h"
+#include "IPriorityDispatcher.h"
 #include "Thread.h"
 
 #include <vector>
 #include <string>
 #include <memory>
 #include <thread>
+#include <mutex>
 
 namespace YAM
 {
+    // A pool of threads that execute the delegates pushed to a dispatcher.
+    // Member functions are MT-safe, except for destruction.
     class __declspec(dllexport) ThreadPool
     {
     public:
-        ThreadPool(PriorityDispatcher* dispatcher, std::string const& name, std::size_t nThreads);
+        ThreadPool(IPriorityDispatcher* dispatcher, std::string const& name, std::size_t nThreads);
         ~ThreadPool();
 
-        // Return the number of threads in the pool.
+        IPriorityDispatcher* dispatcher() const { return _dispatcher; }
+
+        // Return the number of threads in the pool, excluding threads that 
+        // are requested to retire.
         std::size_t size() const;
 
         // Adjust the number of threads in the pool. 
         // 
-        // YAM only adjusts size (when the users requests a non-default size) 
-        // at the start of a build, i.e. when the dispatcher queue is empty and
-        // no delegate processing is in progress. Implementation is therefore 
-        // kept simple: 
-        //      - stop dispatcher to request all threads to stop
-        //      - join and destruct all threads
-        //      - start dispatcher and create new threads.
-        // 
-        // Stopping a thread that is busy executing a delegate will not
-        // cancel the delegate. Instead the thread will run the delegate
-        // to completion and then stop. Adjusting size will therefore block
-        // the calling thread for the time needed to complete all delegates
-        // that were executing at time of size adjustment request. 
+        // Size is adjusted while the pool continues to process delegates, 
+        // e.g. by ThreadPoolSizeController during a build:
+        //      - growing creates the additional threads.
+        //      - shrinking pushes one retire request per surplus thread to
+        //        the dispatcher, at maxPriority(). The thread that executes
+        //        the request stops, without taking new delegates.
+        // Adjusting size does not block the calling thread on delegates 
+        // that are in progress. Retired threads are joined by a next call
+        // of size(..) or by join().
         // 
-        // In YAM delegates typically dispatch a completion delegate to the
-        // main thread. Adjusting size from the main thread will block it, 
-        // causing these completion delegates to remain queued on the main 
-        // thread until size adjustment has completed.
+        // Note: shrinking takes effect when a thread finishes its current
+        // delegate or is idle. Retire requests are not executed while the
+        // dispatcher is suspended.
         //
         void size(std::size_t newSize);
 
         // Join with all threads in pool.
         // Block caller until all dispatched delegates have been executed, 
         // then stop dispatcher and join with threads in pool.
+        // Must not be called concurrently with size(..).
         // Post: size() == 0
         void join();
 
     private:
-        PriorityDispatcher* _dispatcher;
+        void stopWhenDrained();
+        void retire();
+        void joinRetired();
+
+        IPriorityDispatcher* _dispatcher;
         std::string _name;
+        mutable std::mutex _mutex;
         std::vector<std::shared_ptr<Thread>> _threads;
+        // Threads that stopped, pending join.
+        std::vector<std::shared_ptr<Thread>> _retired;
+        // Number of retire requests that are queued in the dispatcher.
+        std::size_t _nRetiring;
+        // Used to give each new thread a unique name.
+        std::size_t _nCreated;
     };
 }
-
@@ -0,0 +1,202 @@
+#include "ThreadPoolSizeController.h"
+#include "ThreadPool.h"
+#include "IPriorityDispatcher.h"
+#include "ILogBook.h"
+#include "LogRecord.h"
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+namespace
+{
+    using namespace YAM;
+
+    bool readFile(std::string const& path, std::string& content) {
+        std::ifstream stream(path);
+        if (!stream.is_open()) return false;
+        std::stringstream ss;
+        ss << stream.rdbuf();
+        content = ss.str();
+        return true;
+    }
+
+    // Return the avg10 value in line, e.g. in:
+    //    some avg10=1.53 avg60=0.87 avg300=0.26 total=83209483
+    bool parseAvg10(std::string const& line, double& avg10) {
+        std::size_t pos = line.find("avg10=");
+        if (pos == std::string::npos) return false;
+        std::istringstream ss(line.substr(pos + 6));
+        ss >> avg10;
+        return !ss.fail();
+    }
+
+    bool samplePressure(std::string const& path, double& some, double& full) {
+        std::string content;
+        return readFile(path, content) && SystemLoad::parsePressure(content, some, full);
+    }
+}
+
+namespace YAM
+{
+    SystemLoad SystemLoad::sample() {
+        SystemLoad load;
+        double full = 0;
+        std::string loadavg;
+        load.valid =
+            samplePressure("/proc/pressure/cpu", load.cpuSome, full)
+            && samplePressure("/proc/pressure/io", load.ioSome, full)
+            && samplePressure("/proc/pressure/memory", load.memorySome, load.memoryFull)
+            && readFile("/proc/loadavg", loadavg)
+            && parseLoadAverage(loadavg, load.loadAverage);
+        load.nCores = std::thread::hardware_concurrency();
+        return load;
+    }
+
+    bool SystemLoad::parsePressure(std::string const& text, double& some, double& full) {
+        bool foundSome = false;
+        std::istringstream lines(text);
+        std::string line;
+        while (std::getline(lines, line)) {
+            if (line.starts_with("some ")) {
+                foundSome = parseAvg10(line, some);
+            } else if (line.starts_with("full ")) {
+                parseAvg10(line, full);
+            }
+        }
+        return foundSome;
+    }
+
+    bool SystemLoad::parseLoadAverage(std::string const& text, double& loadAverage) {
+        std::istringstream ss(text);
+        ss >> loadAverage;
+        return !ss.fail();
+    }
+
+    std::string ThreadPoolSizeController::Decision::toString() const {
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(2);
+        ss << "ThreadPool size " << oldSize << " -> " << newSize << ": " << reason
+            << " (cpu=" << load.cpuSome << "%"
+            << " io=" << load.ioSome << "%"
+            << " memory=" << load.memorySome << "%"
+            << " load=" << load.loadAverage << "/" << load.nCores << " cores)";
+        return ss.str();
+    }
+
+    ThreadPoolSizeController::ThreadPoolSizeController(
+        ThreadPool& pool,
+        Config const& config,
+        std::shared_ptr<ILogBook> logBook,
+        Delegate<SystemLoad> const& sampler
+    )
+        : _pool(pool)
+        , _config(config)
+        , _logBook(logBook)
+        , _sampler(sampler)
+        , _stop(true)
+    {
+        bounds(_config.minSize, _config.maxSize);
+        if (_config.step == 0) _config.step = 1;
+    }
+
+    void ThreadPoolSizeController::bounds(std::size_t minSize, std::size_t maxSize) {
+        if (minSize == 0) throw std::exception("ThreadPoolSizeController: minSize must be > 0");
+        if (maxSize < minSize) throw std::exception("ThreadPoolSizeController: maxSize must be >= minSize");
+        _config.minSize = minSize;
+        _config.maxSize = maxSize;
+    }
+
+    ThreadPoolSizeController::~ThreadPoolSizeController() {
+        stop();
+    }
+
+    void ThreadPoolSizeController::start() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_stop) {
+            if (_thread.joinable()) _thread.join();
+            _stop = false;
+            _thread = std::thread(&ThreadPoolSizeController::run, this);
+        }
+    }
+
+    void ThreadPoolSizeController::stop() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _cond.notify_one();
+        if (_thread.joinable()) _thread.join();
+    }
+
+    bool ThreadPoolSizeController::running() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return !_stop;
+    }
+
+    void ThreadPoolSizeController::run() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (!_stop) {
+            _cond.wait_for(lock, _config.period, [this]() { return _stop; });
+            if (!_stop) {
+                lock.unlock();
+                update();
+                lock.lock();
+            }
+        }
+    }
+
+    bool ThreadPoolSizeController::update() {
+        return update(_sampler.Execute());
+    }
+
+    bool ThreadPoolSizeController::update(SystemLoad const& load) {
+        if (!load.valid) return false;
+
+        std::size_t oldSize = _pool.size();
+        std::size_t newSize = oldSize;
+        std::string reason;
+        double loadPerCore = load.nCores == 0 ? 0 : load.loadAverage / load.nCores;
+        if (load.memorySome >= _config.memoryHigh) {
+            reason = "memory pressure";
+        } else if (load.ioSome >= _config.ioHigh) {
+            reason = "io pressure";
+        } else if (load.cpuSome >= _config.cpuHigh) {
+            reason = "cpu pressure";
+        } else if (loadPerCore >= _config.loadHigh) {
+            reason = "load average";
+        }
+        if (!reason.empty()) {
+            newSize = oldSize > _config.step ? oldSize - _config.step : 0;
+        } else if (
+            load.cpuSome < _config.cpuLow
+            && loadPerCore < _config.loadLow
+            && !_pool.dispatcher()->empty()
+        ) {
+            reason = "cpu available";
+            newSize = oldSize + _config.step;
+        }
+        std::size_t boundedSize = std::clamp(newSize, _config.minSize, _config.maxSize);
+        if (boundedSize != newSize && (oldSize < _config.minSize || oldSize > _config.maxSize)) {
+            reason = "bounds";
+        }
+        newSize = boundedSize;
+        if (newSize == oldSize) return false;
+
+        _pool.size(newSize);
+        Decision decision{ std::chrono::system_clock::now(), load, oldSize, newSize, reason };
+        if (_logBook != nullptr) {
+            _logBook->add(LogRecord(LogRecord::Aspect::Performance, decision.toString()));
+        }
+        std::lock_guard<std::mutex> lock(_mutex);
+        _decisions.push_back(decision);
+        while (_decisions.size() > _config.maxDecisions) _decisions.pop_front();
+        return true;
+    }
+
+    std::vector<ThreadPoolSizeController::Decision> ThreadPoolSizeController::decisions() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return std::vector<Decision>(_decisions.begin(), _decisions.end());
+    }
+}
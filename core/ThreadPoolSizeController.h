@@ -0,0 +1,139 @@
+#pragma once
+
+#include "Delegates.h"
+
+#include <chrono>
+#include <deque>
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace YAM
+{
+    class ThreadPool;
+    class ILogBook;
+
+    // Snapshot of the system load.
+    // Pressure values are the 'avg10' percentages of the Linux PSI (pressure
+    // stall information), i.e. the percentage of the last 10 seconds in which
+    // some (or all) tasks stalled waiting for the resource.
+    struct __declspec(dllexport) SystemLoad
+    {
+        // False when load information is not available.
+        bool valid = false;
+        double cpuSome = 0;
+        double ioSome = 0;
+        double memorySome = 0;
+        double memoryFull = 0;
+        // 1 minute load average
+        double loadAverage = 0;
+        unsigned int nCores = 0;
+
+        // Sample /proc/pressure/{cpu,io,memory} and /proc/loadavg.
+        // Return !valid when these files are not available, e.g. on Windows
+        // and on Linux kernels without PSI support.
+        static SystemLoad sample();
+
+        // Parse the avg10 values of the 'some' and 'full' lines in the content
+        // of a /proc/pressure file. Return whether the 'some' line was found.
+        static bool parsePressure(std::string const& text, double& some, double& full);
+
+        // Parse the 1 minute load average in the content of /proc/loadavg.
+        static bool parseLoadAverage(std::string const& text, double& loadAverage);
+    };
+
+    // A ThreadPoolSizeController periodically samples the system load and 
+    // grows or shrinks a thread pool within configured bounds:
+    //    - shrink when tasks stall on memory, I/O or cpu, or when the load
+    //      average exceeds the number of cores.
+    //    - grow when cpu is under-utilized and the pool has queued work.
+    //    - otherwise keep size.
+    // Size changes by at most Config::step threads per sample.
+    // Each size change is recorded as a Decision, see decisions(), and is
+    // logged as LogRecord::Aspect::Performance. Only the last
+    // Config::maxDecisions decisions are kept.
+    //
+    // The controller is inactive when SystemLoad is not valid.
+    //
+    class __declspec(dllexport) ThreadPoolSizeController
+    {
+    public:
+        struct Config {
+            std::size_t minSize = 1;
+            std::size_t maxSize = 1;
+            std::chrono::milliseconds period = std::chrono::milliseconds(2000);
+            std::size_t step = 1;
+            // Pressure thresholds in percent. Shrink when pressure is at or
+            // above threshold. Grow only when cpu pressure is below cpuLow.
+            double cpuHigh = 40;
+            double cpuLow = 10;
+            double ioHigh = 40;
+            double memoryHigh = 20;
+            // Load average per core. Shrink at or above loadHigh, grow only
+            // below loadLow.
+            double loadHigh = 1.5;
+            double loadLow = 1.0;
+            // Number of decisions kept by decisions().
+            std::size_t maxDecisions = 100;
+        };
+
+        struct Decision {
+            std::chrono::system_clock::time_point time;
+            SystemLoad load;
+            std::size_t oldSize;
+            std::size_t newSize;
+            std::string reason;
+
+            std::string toString() const;
+        };
+
+        // Construct a stopped controller that uses sampler to sample the
+        // system load.
+        ThreadPoolSizeController(
+            ThreadPool& pool,
+            Config const& config,
+            std::shared_ptr<ILogBook> logBook = nullptr,
+            Delegate<SystemLoad> const& sampler = Delegate<SystemLoad>::CreateStatic(&SystemLoad::sample));
+        ~ThreadPoolSizeController();
+
+        Config const& config() const { return _config; }
+
+        // Set config().minSize and config().maxSize.
+        // Throw std::exception when minSize == 0 or maxSize < minSize.
+        // Pre: !running()
+        void bounds(std::size_t minSize, std::size_t maxSize);
+
+        // Start/stop periodic sampling and adjustment in a private thread.
+        void start();
+        void stop();
+        bool running() const;
+
+        // Sample the system load and adjust the pool size.
+        // Return whether pool size was changed.
+        bool update();
+
+        // Adjust the pool size for given load.
+        // Return whether pool size was changed.
+        bool update(SystemLoad const& load);
+
+        // Return the last config().maxDecisions decisions, in order.
+        std::vector<Decision> decisions() const;
+
+    private:
+        void run();
+
+        ThreadPool& _pool;
+        Config _config;
+        std::shared_ptr<ILogBook> _logBook;
+        Delegate<SystemLoad> _sampler;
+
+        mutable std::mutex _mutex;
+        std::condition_variable _cond;
+        bool _stop;
+        std::thread _thread;
+        std::deque<Decision> _decisions;
+    };
+}
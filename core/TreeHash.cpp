@@ -0,0 +1,87 @@
+#include "TreeHash.h"
+#include "Xxh3.h"
+#include "IPriorityDispatcher.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+    using namespace YAM;
+
+    // The chunks of content are claimed, one at a time, by the threads
+    // that run the job.
+    class ChunkJob {
+    public:
+        ChunkJob(std::string_view content)
+            : _content(content)
+            , _hashes((content.size() + TreeHash::chunkSize - 1) / TreeHash::chunkSize)
+            , _nextChunk(0)
+            , _nDone(0)
+        {}
+
+        std::size_t nChunks() const { return _hashes.size(); }
+
+        // Hash chunks until all chunks are claimed.
+        void run() {
+            for (std::size_t i = _nextChunk++; i < _hashes.size(); i = _nextChunk++) {
+                std::string_view chunk = _content.substr(i * TreeHash::chunkSize, TreeHash::chunkSize);
+                _hashes[i] = Xxh3::hash64(chunk.data(), chunk.size());
+                if (++_nDone == _hashes.size()) {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    _done.notify_all();
+                }
+            }
+        }
+
+        // Block until all chunks are hashed. Return the chunk hashes.
+        std::vector<XXH64_hash_t> const& wait() {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _done.wait(lock, [this]() { return _nDone == _hashes.size(); });
+            return _hashes;
+        }
+
+    private:
+        // Only accessed while chunks are unclaimed or in progress, i.e.
+        // while the thread that owns the content waits for completion.
+        std::string_view _content;
+        std::vector<XXH64_hash_t> _hashes;
+        std::atomic<std::size_t> _nextChunk;
+        std::atomic<std::size_t> _nDone;
+        std::mutex _mutex;
+        std::condition_variable _done;
+    };
+}
+
+namespace YAM
+{
+    XXH64_hash_t TreeHash::hash64(std::string_view content, IPriorityDispatcher* helpers) {
+        if (content.size() <= treeThreshold) return Xxh3::hash64(content.data(), content.size());
+        return root(chunkHashes(content, helpers), content.size());
+    }
+
+    std::vector<XXH64_hash_t> TreeHash::chunkHashes(std::string_view content, IPriorityDispatcher* helpers) {
+        // Helper delegates keep the job alive when they execute after
+        // all chunks were hashed.
+        auto job = std::make_shared<ChunkJob>(content);
+        if (helpers != nullptr && job->nChunks() > 1) {
+            std::size_t nHelpers = std::min<std::size_t>(job->nChunks() - 1, std::thread::hardware_concurrency());
+            for (std::size_t i = 0; i < nHelpers; ++i) {
+                helpers->push(Delegate<void>::CreateLambda([job]() { job->run(); }), PriorityClass::VeryHigh);
+            }
+        }
+        job->run();
+        return job->wait();
+    }
+
+    XXH64_hash_t TreeHash::root(std::vector<XXH64_hash_t> const& chunkHashes, uint64_t size) {
+        Xxh3::State state;
+        state.update(chunkHashes.data(), chunkHashes.size() * sizeof(XXH64_hash_t));
+        state.update(&size, sizeof(size));
+        return state.digest64();
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "xxhash.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace YAM
+{
+    class IPriorityDispatcher;
+
+    // TreeHash hashes content larger than treeThreshold as a two-level
+    // Merkle tree: the content is split in chunks of chunkSize bytes, the
+    // chunks are hashed with XXH3-64 and the root hash is the XXH3-64 hash
+    // of the chunk hashes and the content size. Chunks are hashed in
+    // parallel when a helper dispatcher is given.
+    // Smaller content is hashed with plain XXH3-64, i.e. for such content
+    // hash64(content) == Xxh3::hash64(content).
+    //
+    // Chunk hashes identify identical chunks in different content, e.g.
+    // to store large files with chunk-level deduplication.
+    //
+    // Class is MT-safe.
+    //
+    class __declspec(dllexport) TreeHash
+    {
+    public:
+        static constexpr std::size_t chunkSize = 8 * 1024 * 1024;
+        static constexpr std::size_t treeThreshold = 4 * chunkSize;
+
+        // Return the hash of content.
+        // When helpers is not null: hash the chunks in the calling thread
+        // and in delegates pushed to helpers. The calling thread does not
+        // wait for helpers that did not start, hence hashing also
+        // completes when all helper threads are busy.
+        static XXH64_hash_t hash64(std::string_view content, IPriorityDispatcher* helpers = nullptr);
+
+        // Return the XXH3-64 hashes of the consecutive chunks of content.
+        // The last chunk is shorter than chunkSize when content size is not
+        // a multiple of chunkSize.
+        static std::vector<XXH64_hash_t> chunkHashes(std::string_view content, IPriorityDispatcher* helpers = nullptr);
+
+        // Return the root hash of the given chunk hashes of content of
+        // given size.
+        static XXH64_hash_t root(std::vector<XXH64_hash_t> const& chunkHashes, uint64_t size);
+    };
+}
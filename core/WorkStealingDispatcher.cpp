@@ -0,0 +1,229 @@
+#include "WorkStealingDispatcher.h"
+#include "DispatcherFrame.h"
+
+namespace
+{
+    using namespace YAM;
+
+    // The worker queue to which the current thread is bound.
+    // See WorkStealingDispatcher::run()
+    struct WorkerBinding {
+        WorkStealingDispatcher* dispatcher;
+        uint32_t worker;
+    };
+    thread_local WorkerBinding binding = { nullptr, 0 };
+}
+
+namespace YAM
+{
+    WorkStealingDispatcher::WorkStealingDispatcher(uint32_t nPriorities, uint32_t nWorkers)
+        : _nPriorities(nPriorities)
+        , _pending(new std::atomic<uint32_t>[nPriorities])
+        , _size(0)
+        , _nextWorker(0)
+        , _nStolen(0)
+        , _maxSize(0)
+        , _nPushed(0)
+        , _suspended(false)
+        , _stopped(false)
+        , _nIdle(0)
+    {
+        if (nPriorities == 0) throw std::exception("too few priorities");
+        if (nPriorities > 1024) throw std::exception("too many priorities");
+        if (nWorkers == 0) nWorkers = 1;
+        for (uint32_t i = 0; i < nPriorities; ++i) _pending[i] = 0;
+        for (uint32_t i = 0; i < nWorkers; ++i) {
+            auto worker = std::make_unique<Worker>();
+            worker->queues.resize(nPriorities);
+            _workers.push_back(std::move(worker));
+        }
+    }
+
+    uint32_t WorkStealingDispatcher::priorityOf(PriorityClass prio) const {
+        uint32_t nPrios = nPriorities();
+        switch (prio)
+        {
+            case PriorityClass::VeryHigh: return nPrios;
+            case PriorityClass::High: return (nPrios * 3) / 4;
+            case PriorityClass::Medium:return nPrios / 2;
+            case PriorityClass::Low:return nPrios / 4;
+            case PriorityClass::VeryLow: return 0;
+            default: throw std::exception("invalid prio enum value");
+        }
+    }
+
+    void WorkStealingDispatcher::resetStatistics() {
+        _maxSize = _size.load();
+        _nPushed = 0;
+    }
+
+    uint32_t WorkStealingDispatcher::thisWorker() {
+        if (binding.dispatcher == this) return binding.worker;
+        return _nextWorker++ % nWorkers();
+    }
+
+    void WorkStealingDispatcher::bindThisThread() {
+        binding.dispatcher = this;
+        binding.worker = _nextWorker++ % nWorkers();
+    }
+
+    void WorkStealingDispatcher::push(Delegate<void>& action, uint32_t prio) {
+        pushToWorker(Delegate<void>(action), prio);
+    }
+
+    void WorkStealingDispatcher::push(Delegate<void>&& action, uint32_t prio) {
+        pushToWorker(std::move(action), prio);
+    }
+
+    void WorkStealingDispatcher::push(Delegate<void>& action, PriorityClass prio) {
+        pushToWorker(Delegate<void>(action), priorityOf(prio));
+    }
+
+    void WorkStealingDispatcher::push(Delegate<void>&& action, PriorityClass prio) {
+        pushToWorker(std::move(action), priorityOf(prio));
+    }
+
+    void WorkStealingDispatcher::pushToWorker(Delegate<void>&& action, uint32_t prio) {
+        if (prio > maxPriority()) prio = maxPriority();
+        Worker& worker = *_workers[thisWorker()];
+        {
+            // Count the delegate before releasing the lock: another thread
+            // can pop the delegate as soon as the lock is released. Counting
+            // after that would let tryPopFrom() decrement _pending and _size
+            // below the number of queued delegates.
+            std::lock_guard lk(worker.mutex);
+            worker.queues[prio].push_back(std::move(action));
+            _pending[prio]++;
+            std::size_t newSize = ++_size;
+            _nPushed++;
+            std::size_t maxSize = _maxSize;
+            while (newSize > maxSize && !_maxSize.compare_exchange_weak(maxSize, newSize));
+        }
+        // An idle thread increments _nIdle before it evaluates _size. 
+        // Hence either this thread sees _nIdle > 0 or the idle thread 
+        // sees the incremented _size.
+        if (_nIdle > 0) {
+            { std::lock_guard lk(_idleMtx); }
+            _idleCv.notify_one();
+        }
+    }
+
+    bool WorkStealingDispatcher::tryPopFrom(
+        Worker& worker,
+        uint32_t prio,
+        bool steal,
+        Delegate<void>& action
+    ) {
+        {
+            std::lock_guard lk(worker.mutex);
+            auto& queue = worker.queues[prio];
+            if (queue.empty()) return false;
+            if (steal) {
+                action = std::move(queue.back());
+                queue.pop_back();
+            } else {
+                action = std::move(queue.front());
+                queue.pop_front();
+            }
+            _pending[prio]--;
+            _size--;
+        }
+        return true;
+    }
+
+    bool WorkStealingDispatcher::tryPop(Delegate<void>& action) {
+        uint32_t self = thisWorker();
+        uint32_t n = nWorkers();
+        for (int32_t prio = static_cast<int32_t>(maxPriority()); prio >= 0; --prio) {
+            if (_pending[prio] == 0) continue;
+            if (tryPopFrom(*_workers[self], prio, false, action)) return true;
+            for (uint32_t i = 1; i < n; ++i) {
+                if (tryPopFrom(*_workers[(self + i) % n], prio, true, action)) {
+                    _nStolen++;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    Delegate<void> WorkStealingDispatcher::pop() {
+        Delegate<void> d;
+        while (!_stopped) {
+            if (!_suspended && _size > 0 && tryPop(d)) break;
+            std::unique_lock lk(_idleMtx);
+            _nIdle++;
+            _idleCv.wait(lk, [this] { return (_size > 0 && !_suspended) || _stopped; });
+            _nIdle--;
+        }
+        if (_stopped) d.Clear();
+        return d;
+    }
+
+    std::size_t WorkStealingDispatcher::size() {
+        return _size;
+    }
+
+    bool WorkStealingDispatcher::empty() {
+        return _size == 0;
+    }
+
+    void WorkStealingDispatcher::suspend() {
+        {
+            std::lock_guard lk(_idleMtx);
+            _suspended = true;
+        }
+        _idleCv.notify_all();
+    }
+
+    void WorkStealingDispatcher::resume() {
+        {
+            std::lock_guard lk(_idleMtx);
+            _suspended = false;
+        }
+        _idleCv.notify_all();
+    }
+
+    bool WorkStealingDispatcher::suspended() {
+        return _suspended;
+    }
+
+    void WorkStealingDispatcher::start() {
+        {
+            std::lock_guard lk(_idleMtx);
+            _stopped = false;
+        }
+        _idleCv.notify_all();
+    }
+
+    void WorkStealingDispatcher::stop() {
+        {
+            std::lock_guard lk(_idleMtx);
+            _stopped = true;
+        }
+        _idleCv.notify_all();
+    }
+
+    bool WorkStealingDispatcher::stopped() {
+        return _stopped;
+    }
+
+    void WorkStealingDispatcher::popAndExecute() {
+        Delegate<void> d = pop();
+        if (d.IsBound()) d.Execute();
+    }
+
+    void WorkStealingDispatcher::run() {
+        WorkerBinding previous = binding;
+        bindThisThread();
+        while (!stopped()) popAndExecute();
+        binding = previous;
+    }
+
+    void WorkStealingDispatcher::run(IDispatcherFrame* frame) {
+        WorkerBinding previous = binding;
+        bindThisThread();
+        while (!frame->stopped() && !stopped()) popAndExecute();
+        binding = previous;
+    }
+}
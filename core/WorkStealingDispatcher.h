@@ -0,0 +1,124 @@
+#pragma once
+
+#include "IPriorityDispatcher.h"
+
+#include <deque>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+
+namespace YAM
+{
+    // Thread-safe priority queue intended to feed a ThreadPool.
+    //
+    // PriorityDispatcher protects all of its queues with one mutex. When
+    // many pool threads push and pop small delegates (e.g. file hashing
+    // after a branch switch) that mutex becomes the bottleneck. This
+    // dispatcher instead distributes delegates over nWorkers worker queues,
+    // each protected by its own mutex. Each worker queue is a set of deques,
+    // one deque per priority.
+    //
+    // A thread that executes run() is bound to one of the worker queues.
+    // Delegates pushed by a bound thread are appended to its own worker
+    // queue. Delegates pushed by other threads (e.g. the main thread) are
+    // distributed round-robin over the worker queues.
+    // pop() takes the highest priority delegate from the front of the
+    // caller's own worker queue. When that queue has no delegate of that
+    // priority it steals one from the back of another worker queue.
+    //
+    // Priorities are honored globally: a delegate with priority p is only
+    // popped when no delegate with priority > p was queued at the time of
+    // the pop. FIFO order is only guaranteed for delegates of equal priority
+    // pushed to the same worker queue.
+    //
+    // Threads only block on the shared mutex when there is no work to do.
+    //
+    class __declspec(dllexport) WorkStealingDispatcher : public IPriorityDispatcher
+    {
+    public:
+        // Construct dispatcher for priorities in range [0, nPriorities-1]
+        // with nWorkers worker queues in !suspended() && started() state.
+        // nWorkers is typically the number of threads in the pool. Pools
+        // with more threads than workers share worker queues.
+        WorkStealingDispatcher(uint32_t nPriorities, uint32_t nWorkers);
+
+        uint32_t nPriorities() const override { return _nPriorities; }
+        uint32_t priorityOf(PriorityClass prio) const override;
+        uint32_t nWorkers() const { return static_cast<uint32_t>(_workers.size()); }
+
+        void push(Delegate<void>& newAction, uint32_t prio) override;
+        void push(Delegate<void>&& newAction, uint32_t prio) override;
+        void push(Delegate<void>& newAction, PriorityClass prio = PriorityClass::Medium) override;
+        void push(Delegate<void>&& newAction, PriorityClass prio = PriorityClass::Medium) override;
+
+        Delegate<void> pop() override;
+        std::size_t size() override;
+        bool empty() override;
+
+        void suspend() override;
+        void resume() override;
+        bool suspended() override;
+
+        void start() override;
+        void stop() override;
+        bool stopped() override;
+
+        void popAndExecute() override;
+
+        // Bind calling thread to a worker queue and execute:
+        //     while (!stopped()) popAndExecute();
+        void run() override;
+
+        // Bind calling thread to a worker queue and execute:
+        //     while (!frame.stopped() && !stopped()) popAndExecute();
+        void run(IDispatcherFrame* frame) override;
+
+        // Return the number of delegates that were stolen from another
+        // worker queue since construction.
+        uint64_t nStolen() const { return _nStolen; }
+
+        // Return the maximum value of size() since construction or since 
+        // last resetStatistics().
+        std::size_t maxSize() const { return _maxSize; }
+
+        // Return the number of pushed delegates since construction or 
+        // since last resetStatistics().
+        uint64_t nPushed() const { return _nPushed; }
+
+        // Post: maxSize() == size() && nPushed() == 0
+        void resetStatistics();
+
+    private:
+        struct Worker {
+            std::mutex mutex;
+            // delegate queue per priority
+            std::vector<std::deque<Delegate<void>>> queues;
+        };
+
+        void pushToWorker(Delegate<void>&& action, uint32_t prio);
+        bool tryPop(Delegate<void>& action);
+        bool tryPopFrom(Worker& worker, uint32_t prio, bool steal, Delegate<void>& action);
+        uint32_t thisWorker();
+        void bindThisThread();
+
+        uint32_t _nPriorities;
+        std::vector<std::unique_ptr<Worker>> _workers;
+        // _pending[prio] is the number of queued delegates with priority prio
+        std::unique_ptr<std::atomic<uint32_t>[]> _pending;
+        std::atomic<std::size_t> _size;
+        std::atomic<uint32_t> _nextWorker;
+        std::atomic<uint64_t> _nStolen;
+        std::atomic<std::size_t> _maxSize;
+        std::atomic<uint64_t> _nPushed;
+
+        std::atomic<bool> _suspended;
+        std::atomic<bool> _stopped;
+
+        // Idle threads block on _idleCv.
+        std::mutex _idleMtx;
+        std::condition_variable _idleCv;
+        std::atomic<uint32_t> _nIdle;
+    };
+}
@@ -0,0 +1,182 @@
+#include "Xxh3.h"
+#include "Xxh3Functions.h"
+#include "FileReader.h"
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define YAM_XXH3_X64
+#if defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace
+{
+    using namespace YAM;
+
+#ifdef YAM_XXH3_X64
+    void cpuid(int info[4], int function, int subfunction) {
+#if defined(_MSC_VER)
+        __cpuidex(info, function, subfunction);
+#else
+        unsigned int regs[4] = { 0, 0, 0, 0 };
+        __cpuid_count(function, subfunction, regs[0], regs[1], regs[2], regs[3]);
+        for (int i = 0; i < 4; ++i) info[i] = static_cast<int>(regs[i]);
+#endif
+    }
+
+    // Return the register state that the operating system saves on
+    // context switches.
+    uint64_t xgetbv0() {
+#if defined(_MSC_VER)
+        return _xgetbv(0);
+#else
+        uint32_t eax, edx;
+        __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+    }
+
+    bool detect(Xxh3::Isa isa) {
+        if (isa == Xxh3::Isa::Sse2) return true;
+        int info[4];
+        cpuid(info, 0, 0);
+        if (info[0] < 7) return false;
+        cpuid(info, 1, 0);
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        const bool avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx) return false;
+        uint64_t xcr0 = xgetbv0();
+        cpuid(info, 7, 0);
+        const uint32_t ebx = static_cast<uint32_t>(info[1]);
+        if (isa == Xxh3::Isa::Avx2) {
+            // XMM and YMM state
+            return (xcr0 & 0x6) == 0x6 && (ebx & (1u << 5)) != 0;
+        }
+        // XMM, YMM, opmask and ZMM state; AVX-512 F, DQ, BW and VL.
+        const uint32_t avx512 = (1u << 16) | (1u << 17) | (1u << 30) | (1u << 31);
+        return (xcr0 & 0xE6) == 0xE6 && (ebx & avx512) == avx512;
+    }
+#else
+    bool detect(Xxh3::Isa isa) {
+        return isa == Xxh3::Isa::Sse2;
+    }
+#endif
+
+    Xxh3Functions const& functionsOf(Xxh3::Isa isa) {
+#ifdef YAM_XXH3_X64
+        if (isa == Xxh3::Isa::Avx512) return xxh3Avx512Functions();
+        if (isa == Xxh3::Isa::Avx2) return xxh3Avx2Functions();
+#endif
+        return xxh3Sse2Functions();
+    }
+
+    struct Selection {
+        Selection() : isa(Xxh3::bestIsa()), functions(&functionsOf(isa)) {}
+
+        std::atomic<Xxh3::Isa> isa;
+        std::atomic<Xxh3Functions const*> functions;
+    };
+
+    Selection& selection() {
+        static Selection selected;
+        return selected;
+    }
+
+    Xxh3Functions const& functions() {
+        return *(selection().functions.load(std::memory_order_relaxed));
+    }
+
+    Xxh3Hash128 toHash(Xxh3Hash128Value value) {
+        return { value.low64, value.high64 };
+    }
+}
+
+namespace YAM
+{
+    bool Xxh3::supported(Isa isa) {
+        static const bool supportedIsas[3] = { detect(Isa::Sse2), detect(Isa::Avx2), detect(Isa::Avx512) };
+        return supportedIsas[static_cast<uint8_t>(isa)];
+    }
+
+    Xxh3::Isa Xxh3::bestIsa() {
+        if (supported(Isa::Avx512)) return Isa::Avx512;
+        if (supported(Isa::Avx2)) return Isa::Avx2;
+        return Isa::Sse2;
+    }
+
+    void Xxh3::isa(Isa isa) {
+        if (!supported(isa)) throw std::runtime_error(isaName(isa) + " is not supported by this CPU");
+        Selection& selected = selection();
+        selected.isa = isa;
+        selected.functions = &functionsOf(isa);
+    }
+
+    Xxh3::Isa Xxh3::isa() {
+        return selection().isa;
+    }
+
+    std::string Xxh3::isaName(Isa isa) {
+        switch (isa) {
+        case Isa::Sse2: return "SSE2";
+        case Isa::Avx2: return "AVX2";
+        case Isa::Avx512: return "AVX-512";
+        default: throw std::runtime_error("unknown Xxh3::Isa");
+        }
+    }
+
+    XXH64_hash_t Xxh3::hash64(void const* data, std::size_t length, XXH64_hash_t seed) {
+        return functions().hash64(data, length, seed);
+    }
+
+    XXH64_hash_t Xxh3::hash64(std::string const& s, XXH64_hash_t seed) {
+        return functions().hash64(s.data(), s.length(), seed);
+    }
+
+    Xxh3Hash128 Xxh3::hash128(void const* data, std::size_t length, XXH64_hash_t seed) {
+        return toHash(functions().hash128(data, length, seed));
+    }
+
+    XXH64_hash_t Xxh3::file64(std::filesystem::path const& path, XXH64_hash_t seed) {
+        XXH64_hash_t hash = 0;
+        FileReader::read(path, Delegate<void, std::string_view>::CreateLambda(
+            [&hash, seed](std::string_view content) {
+                hash = hash64(content.data(), content.size(), seed);
+            }));
+        return hash;
+    }
+
+    Xxh3::State::State(XXH64_hash_t seed)
+        : _functions(&functions())
+        , _state(_functions->createState())
+    {
+        if (_state == nullptr) throw std::bad_alloc();
+        _functions->reset(_state, seed);
+    }
+
+    Xxh3::State::~State() {
+        _functions->freeState(_state);
+    }
+
+    void Xxh3::State::reset(XXH64_hash_t seed) {
+        _functions->reset(_state, seed);
+    }
+
+    void Xxh3::State::update(void const* data, std::size_t length) {
+        _functions->update(_state, data, length);
+    }
+
+    XXH64_hash_t Xxh3::State::digest64() const {
+        return _functions->digest64(_state);
+    }
+
+    Xxh3Hash128 Xxh3::State::digest128() const {
+        return toHash(_functions->digest128(_state));
+    }
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "xxhash.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+namespace YAM
+{
+    struct Xxh3Functions;
+
+    struct __declspec(dllexport) Xxh3Hash128
+    {
+        XXH64_hash_t low64;
+        XXH64_hash_t high64;
+
+        bool operator==(Xxh3Hash128 const& rhs) const = default;
+    };
+
+    // Xxh3 computes XXH3-64 and XXH3-128 hashes, see
+    // https://github.com/Cyan4973/xxHash. XXH3 is several times faster than
+    // XXH64 on large inputs because it processes its input with SIMD
+    // instructions.
+    //
+    // The XXH3 implementation is compiled for several instruction sets.
+    // On first use Xxh3 selects the fastest instruction set supported by
+    // the CPU. All instruction sets compute the same hash values.
+    //
+    // Class is MT-safe.
+    //
+    class __declspec(dllexport) Xxh3
+    {
+    public:
+        enum class Isa : uint8_t {
+            Sse2 = 0,   // baseline of the target: SSE2 on x64
+            Avx2 = 1,
+            Avx512 = 2, // AVX-512 F, BW, DQ and VL
+        };
+
+        // Return whether the CPU and operating system support isa.
+        static bool supported(Isa isa);
+
+        // Return the fastest supported instruction set.
+        static Isa bestIsa();
+
+        // Set/get the instruction set used by the hash functions.
+        // Throw std::runtime_error when isa is not supported.
+        // Intended for testing and benchmarking.
+        static void isa(Isa isa);
+        static Isa isa();
+
+        static std::string isaName(Isa isa);
+
+        static XXH64_hash_t hash64(void const* data, std::size_t length, XXH64_hash_t seed = 0);
+        static XXH64_hash_t hash64(std::string const& s, XXH64_hash_t seed = 0);
+        static Xxh3Hash128 hash128(void const* data, std::size_t length, XXH64_hash_t seed = 0);
+
+        // Return the XXH3-64 hash of the content of the file with given path,
+        // read by FileReader.
+        // Return 0 when the file cannot be opened, similar to XXH64_file.
+        static XXH64_hash_t file64(std::filesystem::path const& path, XXH64_hash_t seed = 0);
+
+        // Streaming interface: hashing the concatenation of the updates
+        // results in the same hash as hashing the concatenation in one go.
+        class __declspec(dllexport) State
+        {
+        public:
+            State(XXH64_hash_t seed = 0);
+            State(State const&) = delete;
+            State& operator=(State const&) = delete;
+            ~State();
+
+            void reset(XXH64_hash_t seed = 0);
+            void update(void const* data, std::size_t length);
+            XXH64_hash_t digest64() const;
+            Xxh3Hash128 digest128() const;
+
+        private:
+            // The functions of the instruction set that was selected when
+            // the state was constructed.
+            Xxh3Functions const* _functions;
+            void* _state;
+        };
+    };
+}
@@ -0,0 +1,9 @@
+// XXH3 for AVX2. This file is compiled with /arch:AVX2, see core.vcxproj.
+// Xxh3 only calls these functions when the CPU supports AVX2.
+#if defined(_M_X64) || defined(__x86_64__)
+#ifndef __AVX2__
+#error "Xxh3Avx2.cpp must be compiled with /arch:AVX2"
+#endif
+#define XXH3_FUNCTIONS xxh3Avx2Functions
+#include "Xxh3Functions.inl"
+#endif
@@ -0,0 +1,9 @@
+// XXH3 for AVX-512. This file is compiled with /arch:AVX512, see core.vcxproj.
+// Xxh3 only calls these functions when the CPU supports AVX-512.
+#if defined(_M_X64) || defined(__x86_64__)
+#ifndef __AVX512F__
+#error "Xxh3Avx512.cpp must be compiled with /arch:AVX512"
+#endif
+#define XXH3_FUNCTIONS xxh3Avx512Functions
+#include "Xxh3Functions.inl"
+#endif
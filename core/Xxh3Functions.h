@@ -0,0 +1,39 @@
+#pragma once
+
+// Internal to Xxh3.cpp and the Xxh3<Isa>.cpp files.
+// Only includes C headers: the Xxh3<Isa>.cpp files are compiled with
+// instruction set specific compiler options. Inline C++ library code
+// compiled in these files could be selected by the linker for use in
+// other files, causing illegal instructions on CPUs that do not support
+// the instruction set.
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace YAM
+{
+    struct Xxh3Hash128Value {
+        uint64_t low64;
+        uint64_t high64;
+    };
+
+    // The XXH3 functions compiled for one instruction set.
+    // State functions operate on an opaque XXH3_state_t.
+    struct Xxh3Functions {
+        uint64_t (*hash64)(void const* data, size_t length, uint64_t seed);
+        Xxh3Hash128Value (*hash128)(void const* data, size_t length, uint64_t seed);
+        void* (*createState)();
+        void (*freeState)(void* state);
+        void (*reset)(void* state, uint64_t seed);
+        void (*update)(void* state, void const* data, size_t length);
+        uint64_t (*digest64)(void const* state);
+        Xxh3Hash128Value (*digest128)(void const* state);
+    };
+
+    // Xxh3Sse2.cpp: compiled for the baseline instruction set of the
+    // target, i.e. SSE2 on x64 and NEON on arm64.
+    Xxh3Functions const& xxh3Sse2Functions();
+    // Xxh3Avx2.cpp and Xxh3Avx512.cpp, x64 only.
+    Xxh3Functions const& xxh3Avx2Functions();
+    Xxh3Functions const& xxh3Avx512Functions();
+}
@@ -0,0 +1,63 @@
+// Included by the Xxh3<Isa>.cpp files after defining XXH3_FUNCTIONS as the
+// name of the function that returns the Xxh3Functions table. The file is
+// compiled with the instruction set specific compiler options; xxhash08.h
+// selects the matching XXH_VECTOR implementation.
+
+#include "Xxh3Functions.h"
+
+#define XXH_INLINE_ALL
+#include "xxhash08.h"
+
+namespace
+{
+    using namespace YAM;
+
+    Xxh3Hash128Value toValue(XXH128_hash_t hash) {
+        return { hash.low64, hash.high64 };
+    }
+
+    uint64_t hash64(void const* data, size_t length, uint64_t seed) {
+        return XXH3_64bits_withSeed(data, length, seed);
+    }
+
+    Xxh3Hash128Value hash128(void const* data, size_t length, uint64_t seed) {
+        return toValue(XXH3_128bits_withSeed(data, length, seed));
+    }
+
+    void* createState() {
+        return XXH3_createState();
+    }
+
+    void freeState(void* state) {
+        XXH3_freeState(static_cast<XXH3_state_t*>(state));
+    }
+
+    // The 64 and 128 bit variants share reset and update, only the
+    // digests differ.
+    void reset(void* state, uint64_t seed) {
+        XXH3_128bits_reset_withSeed(static_cast<XXH3_state_t*>(state), seed);
+    }
+
+    void update(void* state, void const* data, size_t length) {
+        XXH3_128bits_update(static_cast<XXH3_state_t*>(state), data, length);
+    }
+
+    uint64_t digest64(void const* state) {
+        return XXH3_64bits_digest(static_cast<XXH3_state_t const*>(state));
+    }
+
+    Xxh3Hash128Value digest128(void const* state) {
+        return toValue(XXH3_128bits_digest(static_cast<XXH3_state_t const*>(state)));
+    }
+
+    Xxh3Functions const functions = {
+        hash64, hash128, createState, freeState, reset, update, digest64, digest128
+    };
+}
+
+namespace YAM
+{
+    Xxh3Functions const& XXH3_FUNCTIONS() {
+        return functions;
+    }
+}
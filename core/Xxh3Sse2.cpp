@@ -0,0 +1,3 @@
+// XXH3 for the baseline instruction set of the target: SSE2 on x64.
+#define XXH3_FUNCTIONS xxh3Sse2Functions
+#include "Xxh3Functions.inl"
@@ -147,7 +147,7 @@ namespace YAMTest
             EXPECT_EQ(expected->getSubDirs()[i]->path(), subDirNodes[i]->absolutePath());
         }
 
-        std::map<std::filesystem::path, std::shared_ptr<YAM::Node>> const& cNodes = actual->getContent();
+        YAM::NodeMap<YAM::Node> const& cNodes = actual->getContent();
         EXPECT_EQ(expected->getFiles().size() + expected->getSubDirs().size(), cNodes.size());
         for (auto f : fileNodes) EXPECT_TRUE(cNodes.contains(f->name()));
         for (auto d : subDirNodes) EXPECT_TRUE(cNodes.contains(d->name()));
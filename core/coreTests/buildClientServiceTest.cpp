@@ -153,6 +153,37 @@ namespace
         EXPECT_TRUE(result->state() == BuildResult::State::Ok);
     }
 
+    // The service answers a status request from the snapshot published at
+    // the end of the build.
+    TEST(BuildService, nodeStatus) {
+        Session session;
+        auto result = session.build();
+        EXPECT_TRUE(result->state() == BuildResult::State::Ok);
+
+        session.newClient();
+        std::mutex mutex;
+        std::condition_variable cond;
+        std::shared_ptr<NodeStatusResult> status;
+        session.client->statusCompletor().AddLambda([&](std::shared_ptr<NodeStatusResult> r) {
+            std::lock_guard<std::mutex> lock(mutex);
+            status = r;
+            cond.notify_one();
+        });
+        auto request = std::make_shared<NodeStatusRequest>();
+        request->nodes({ "@@testRepo", "@@testRepo/unknown.cpp" });
+        EXPECT_TRUE(session.client->requestStatus(request));
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (status == nullptr) cond.wait(lock);
+        }
+        session.client->statusCompletor().RemoveAll();
+        ASSERT_EQ(2, status->nodes().size());
+        EXPECT_LT(0, status->epoch());
+        EXPECT_TRUE(status->nodes()[0].found);
+        EXPECT_EQ(Node::State::Ok, status->nodes()[0].state);
+        EXPECT_FALSE(status->nodes()[1].found);
+    }
+
     TEST(BuildService, illegalClientUse) {
         Session session;
         auto result = session.build();
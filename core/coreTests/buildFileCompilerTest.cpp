@@ -47,7 +47,7 @@ namespace
             , repoDir(FileSystem::createUniqueDirectory())
             , testTree(repoDir, 1, RegexSet({ }))
         {
-            //context.threadPool().size(1);
+            //context.ioPool().size(1);
             std::filesystem::create_directory(repoDir / "src");
             std::filesystem::create_directory(repoDir / "output");
 
@@ -306,6 +306,36 @@ echo %%EV%%
         EXPECT_EQ(script.script, cmd->script());
     }
 
+    TEST(BuildFileCompiler, resourcePoolCapacityConflict) {
+        BuildFile::File file;
+        file.buildFile = "buildFile_yam.txt";
+        ExecutionContext context;
+        auto baseDir = std::make_shared<DirectoryNode>(&context, "base", nullptr);
+        for (uint32_t capacity : { 4, 2 }) {
+            auto rule = std::make_shared<BuildFile::Rule>();
+            rule->forEach = false;
+            rule->line = capacity;
+            rule->script.script = "link";
+            rule->resources.pool = "link";
+            rule->resources.capacity = capacity;
+            file.variablesAndRules.push_back(rule);
+        }
+
+        bool thrown = false;
+        try {
+            BuildFileCompiler compiler(
+                &context, baseDir, file,
+                emptyCmds, emptyForEachNodes,
+                emptyOutputs, emptyGroups,
+                std::map<std::filesystem::path, std::shared_ptr<GeneratedFileNode>>());
+        } catch (std::runtime_error const& e) {
+            thrown = true;
+            std::string message(e.what());
+            EXPECT_NE(std::string::npos, message.find("Resource pool link has capacity 2 while it has capacity 4 in the rule at line 4"));
+        }
+        EXPECT_TRUE(thrown);
+    }
+
     TEST(BuildFileCompiler, multilineScript) {
         BuildFile::File file;
         ExecutionContext context;
@@ -240,6 +240,34 @@ namespace {
         EXPECT_FALSE(output.ignore);
     }
 
+    TEST(BuildFileParser, resourceClaim) {
+        const std::string file = R"(: a.obj b.obj |> link %f -o %o |> app.exe {pool=link:4} {weight=2} {exes})";
+        BuildFileParser parser(file);
+        auto const buildFile = parser.file();
+        ASSERT_EQ(1, buildFile->variablesAndRules.size());
+        auto rule = dynamic_pointer_cast<BuildFile::Rule>(buildFile->variablesAndRules[0]);
+        ASSERT_NE(nullptr, rule);
+        EXPECT_EQ("link", rule->resources.pool);
+        EXPECT_EQ(4, rule->resources.capacity);
+        EXPECT_EQ(2, rule->resources.tokens);
+        ASSERT_EQ(1, rule->bins.size());
+        EXPECT_EQ("{exes}", rule->bins[0]);
+    }
+
+    TEST(BuildFileParser, invalidResourceClaim) {
+        const std::string file = R"(: a.obj |> link %f -o %o |> app.exe {pool=link})";
+        try
+        {
+            BuildFileParser parser(file);
+            FAIL();
+        } catch (std::runtime_error e)
+        {
+            std::string expected("Invalid resource claim '{pool=link}' at line 1, column 37 in file test: expected {pool=name:capacity} or {weight=tokens}.\n");
+            std::string actual = e.what();
+            EXPECT_EQ(expected, actual);
+        }
+    }
+
     TEST(BuildFileParser, twoRules) {
         const std::string file = R"(
 : foreach *.dll |> echo %f > %o |> generated\%B.txt
@@ -29,6 +29,19 @@ namespace
         EXPECT_TRUE(options._clean);
     }
 
+    TEST(BuildOptionsParser, threadBounds) {
+        char program[] = "yam";
+        char minThreads[] = "--minThreads=2";
+        char maxThreads[] = "--maxThreads=12";
+        char* argv[] = { program, minThreads, maxThreads };
+        BuildOptions options;
+        BuildOptionsParser parser(3, argv, options);
+        EXPECT_FALSE(parser.parseError());
+        EXPECT_EQ(0, options._threads);
+        EXPECT_EQ(2, options._minThreads);
+        EXPECT_EQ(12, options._maxThreads);
+    }
+
     TEST(BuildOptionsParser, files) {
         char program[] = "yam";
         char noopt[] = "--";
@@ -94,6 +94,26 @@ namespace
         ASSERT_NE(nullptr, result);
     }
 
+    TEST(BuildServiceProtocol, NodeStatus) {
+        ProtocolSetup setup;
+        auto statusRequest = std::make_shared<NodeStatusRequest>();
+        statusRequest->nodes({ "@@repo/a.cpp", "@@repo/b.cpp" });
+        setup.client.send(statusRequest);
+        auto request = dynamic_pointer_cast<NodeStatusRequest>(setup.service.receive());
+        ASSERT_NE(nullptr, request);
+        EXPECT_EQ(statusRequest->nodes(), request->nodes());
+
+        auto statusResult = std::make_shared<NodeStatusResult>();
+        statusResult->epoch(3);
+        statusResult->add({ "@@repo/a.cpp", true, Node::State::Failed });
+        statusResult->add({ "@@repo/b.cpp", false, Node::State::Dirty });
+        setup.service.send(statusResult);
+        auto result = dynamic_pointer_cast<NodeStatusResult>(setup.client.receive());
+        ASSERT_NE(nullptr, result);
+        EXPECT_EQ(3, result->epoch());
+        EXPECT_EQ(statusResult->nodes(), result->nodes());
+    }
+
     TEST(BuildServiceProtocol, ClientViolation) {
         ProtocolSetup setup;
         EXPECT_THROW(setup.client.send(setup.logRecord), std::exception);
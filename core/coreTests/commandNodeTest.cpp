@@ -92,7 +92,7 @@ namespace
             repos->addRepository(winRepo);
 
             stats.registerNodes = true;
-            context.threadPool().size(1); // to ease debugging
+            context.processPool().size(1); // to ease debugging
 
             std::ofstream pietSrcFile(pietSrc->absolutePath().string());
             pietSrcFile << "piet";
@@ -365,6 +365,38 @@ namespace
         EXPECT_EQ(Node::State::Ok, cmds.pietjanOut->state());
     }
 
+    // The commands are dirty while their inputs and outputs are up-to-date.
+    // Hence each command completes while it is being started, i.e. inside
+    // the startNodes/awaitNodes call of the node that starts it.
+    TEST(CommandNode, incrementalBuildWhileInputsAndOutputsUpToDate) {
+        Commands cmds;
+
+        EXPECT_TRUE(cmds.execute());
+
+        cmds.pietCmd->setState(Node::State::Dirty);
+        cmds.janCmd->setState(Node::State::Dirty);
+        cmds.pietjanCmd->setState(Node::State::Dirty);
+        EXPECT_EQ(Node::State::Ok, cmds.pietSrc->state());
+        EXPECT_EQ(Node::State::Ok, cmds.janSrc->state());
+
+        EXPECT_TRUE(cmds.execute(false));
+
+        EXPECT_TRUE(cmds.stats.started.contains(cmds.pietCmd.get()));
+        EXPECT_TRUE(cmds.stats.started.contains(cmds.janCmd.get()));
+        EXPECT_TRUE(cmds.stats.started.contains(cmds.pietjanCmd.get()));
+        EXPECT_FALSE(cmds.stats.selfExecuted.contains(cmds.pietCmd.get()));
+        EXPECT_FALSE(cmds.stats.selfExecuted.contains(cmds.janCmd.get()));
+        EXPECT_FALSE(cmds.stats.selfExecuted.contains(cmds.pietjanCmd.get()));
+
+        EXPECT_EQ(Node::State::Ok, cmds.pietCmd->state());
+        EXPECT_EQ(Node::State::Ok, cmds.janCmd->state());
+        EXPECT_EQ(Node::State::Ok, cmds.pietjanCmd->state());
+        EXPECT_EQ(Node::State::Ok, cmds.group->state());
+        EXPECT_EQ(Node::State::Ok, cmds.pietOut->state());
+        EXPECT_EQ(Node::State::Ok, cmds.janOut->state());
+        EXPECT_EQ(Node::State::Ok, cmds.pietjanOut->state());
+    }
+
     TEST(CommandNode, incrementalBuildAfterFileModification) {
         Commands cmds;
 
@@ -0,0 +1,90 @@
+#include "../CriticalPath.h"
+#include "../CommandNode.h"
+#include "../GeneratedFileNode.h"
+#include "../GroupNode.h"
+#include "../ExecutionContext.h"
+
+#include "gtest/gtest.h"
+
+namespace
+{
+    using namespace YAM;
+    using namespace std::chrono_literals;
+
+    // compileA -> a.obj ---+
+    //                      +--> link -> app.exe
+    // compileB -> b.obj ---+    (via group <objs>)
+    // compileC -> c.obj
+    class Commands
+    {
+    public:
+        ExecutionContext context;
+        std::shared_ptr<CommandNode> compileA;
+        std::shared_ptr<CommandNode> compileB;
+        std::shared_ptr<CommandNode> compileC;
+        std::shared_ptr<CommandNode> link;
+        std::shared_ptr<GeneratedFileNode> objA;
+        std::shared_ptr<GeneratedFileNode> objB;
+        std::shared_ptr<GeneratedFileNode> objC;
+        std::shared_ptr<GroupNode> objs;
+
+        Commands()
+            : compileA(std::make_shared<CommandNode>(&context, R"(@@.\compileA)"))
+            , compileB(std::make_shared<CommandNode>(&context, R"(@@.\compileB)"))
+            , compileC(std::make_shared<CommandNode>(&context, R"(@@.\compileC)"))
+            , link(std::make_shared<CommandNode>(&context, R"(@@.\link)"))
+            , objA(std::make_shared<GeneratedFileNode>(&context, R"(@@.\a.obj)", compileA))
+            , objB(std::make_shared<GeneratedFileNode>(&context, R"(@@.\b.obj)", compileB))
+            , objC(std::make_shared<GeneratedFileNode>(&context, R"(@@.\c.obj)", compileC))
+            , objs(std::make_shared<GroupNode>(&context, R"(@@.\<objs>)"))
+        {
+            compileA->executionDuration(10ms);
+            compileB->executionDuration(1ms);
+            compileC->executionDuration(1ms);
+            link->executionDuration(50ms);
+            objs->content({ objB });
+            link->cmdInputs({ objA });
+            link->orderOnlyInputs({ objs });
+        }
+
+        std::vector<std::shared_ptr<Node>> all() {
+            return { compileA, compileB, compileC, link };
+        }
+    };
+
+    TEST(CriticalPath, length) {
+        Commands cmds;
+        CriticalPath path(cmds.all());
+        EXPECT_EQ(60ms, path.length(cmds.compileA.get()));
+        EXPECT_EQ(51ms, path.length(cmds.compileB.get()));
+        EXPECT_EQ(1ms, path.length(cmds.compileC.get()));
+        EXPECT_EQ(50ms, path.length(cmds.link.get()));
+        EXPECT_EQ(60ms, path.maxLength());
+    }
+
+    TEST(CriticalPath, onlyDependenciesBetweenGivenCommands) {
+        Commands cmds;
+        CriticalPath path({ cmds.compileA, cmds.compileC });
+        EXPECT_EQ(10ms, path.length(cmds.compileA.get()));
+        EXPECT_EQ(0ms, path.length(cmds.link.get()));
+    }
+
+    TEST(CriticalPath, unknownDurationIsAverage) {
+        Commands cmds;
+        cmds.link->executionDuration(0ms);
+        // average of known durations = (10 + 1 + 1) / 3 = 4
+        CriticalPath path(cmds.all());
+        EXPECT_EQ(4ms, path.length(cmds.link.get()));
+        EXPECT_EQ(14ms, path.length(cmds.compileA.get()));
+    }
+
+    TEST(CriticalPath, assignPriorities) {
+        Commands cmds;
+        CriticalPath path(cmds.all());
+        path.assignPriorities(8, 24);
+        EXPECT_EQ(24, cmds.compileA->scriptPriority());
+        EXPECT_EQ(22, cmds.compileB->scriptPriority());
+        EXPECT_EQ(21, cmds.link->scriptPriority());
+        EXPECT_EQ(8, cmds.compileC->scriptPriority());
+    }
+}
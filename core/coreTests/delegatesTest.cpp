@@ -2,8 +2,12 @@
 
 #include "../Delegates.h"
 
+#include <array>
 #include <chrono>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
 
 namespace
 {
@@ -163,4 +167,99 @@ namespace
             << "callback ns=" << cbNs.count()/count
             << std::endl;
     }
-}
\ No newline at end of file
+
+    // Simulates the delegates that a node creates when executed:
+    //    - the completion callback passed to Node::startNodes, [this]
+    //    - the delegate that executes the node in the thread pool, [this]
+    //    - the delegate that posts the completion to the main thread,
+    //      [this, state]
+    //    - the delegate that posts an execution result to the main thread,
+    //      [this, shared_ptr], e.g. by GlobNode
+    //    - the delegate that posts the file hashes to the main thread,
+    //      [this], FileNode keeps the hashes in members. Formerly it 
+    //      captured [this, state, lastWriteTime, hashes].
+    //    - the completor (MulticastDelegate) of the node, without handlers
+    // Counts the delegates that needed a heap allocation, both for the
+    // current inline capacity and for the former capacity of 32 bytes.
+    class FakeNode
+    {
+    public:
+        struct Result { int state = 0; std::vector<std::string> paths; };
+
+        void handleRequisitesCompletion(int state) { _state = state; }
+        void execute() { _executed++; }
+        void notifyCompletion(int state) { _state = state; }
+        void handleCompletion(Result const& result) { _state = result.state; }
+        void finishHashing() { _executed += static_cast<int>(_newHashes[0]); }
+
+        Delegate<void, int> callback;
+        MulticastDelegate<FakeNode*> completor;
+        int _state = 0;
+        int _executed = 0;
+        std::chrono::system_clock::time_point _newLastWriteTime;
+        std::array<uint64_t, 9> _newHashes{};
+    };
+
+    template<typename TLambda, typename... Args>
+    bool formerHeap(TLambda const& lambda) {
+        return sizeof(LambdaDelegate<TLambda, void(Args...)>) > 32;
+    }
+
+    TEST(Delegate, allocationsPerCompletedNode) {
+        const std::size_t nNodes = 100000;
+        std::vector<FakeNode> nodes(nNodes);
+        std::size_t nHeap = 0;
+        std::size_t nFormerHeap = 0;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (auto& node : nodes) {
+            FakeNode* self = &node;
+            int state = 1;
+            auto result = std::make_shared<FakeNode::Result>();
+            auto requisites = [self](int state) { self->handleRequisitesCompletion(state); };
+            auto executeLambda = [self]() { self->execute(); };
+            auto notifyLambda = [self, state]() { self->notifyCompletion(state); };
+            auto completionLambda = [self, result]() { self->handleCompletion(*result); };
+            auto hashLambda = [self]() { self->finishHashing(); };
+            auto formerHashLambda = [self, state, lastWriteTime = node._newLastWriteTime, hashes = node._newHashes]() {
+                self->_executed += static_cast<int>(state + hashes[0] + lastWriteTime.time_since_epoch().count());
+            };
+            nFormerHeap += formerHeap<decltype(requisites), int>(requisites)
+                + formerHeap(executeLambda) + formerHeap(notifyLambda)
+                + formerHeap(completionLambda) + formerHeap(formerHashLambda);
+
+            // Lambdas are moved: CreateLambda stores a reference to an
+            // lvalue lambda.
+            node.callback = Delegate<void, int>::CreateLambda(std::move(requisites));
+            auto execute = Delegate<void>::CreateLambda(std::move(executeLambda));
+            auto notify = Delegate<void>::CreateLambda(std::move(notifyLambda));
+            auto completion = Delegate<void>::CreateLambda(std::move(completionLambda));
+            auto hashed = Delegate<void>::CreateLambda(std::move(hashLambda));
+
+            node.callback.Execute(1);
+            execute.Execute();
+            Delegate<void> queued(std::move(completion));
+            queued.Execute();
+            hashed.Execute();
+            notify.Execute();
+            node.completor.Broadcast(self);
+
+            nHeap += node.callback.IsHeapAllocated() + execute.IsHeapAllocated()
+                + notify.IsHeapAllocated() + queued.IsHeapAllocated()
+                + hashed.IsHeapAllocated() + node.completor.IsHeapAllocated();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        EXPECT_EQ(0, nHeap);
+        EXPECT_EQ(2 * nNodes, nFormerHeap);
+
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        std::cout
+            << "delegate heap allocations per completed node=" << static_cast<double>(nHeap) / nNodes
+            << " (former=" << static_cast<double>(nFormerHeap) / nNodes << ")"
+            << std::endl
+            << "delegate bytes per node=" << sizeof(Delegate<void, int>) + sizeof(MulticastDelegate<FakeNode*>)
+            << std::endl
+            << "ns per completed node=" << ns / nNodes
+            << std::endl;
+    }
+}
@@ -0,0 +1,244 @@
+#include "../DependencyIndex.h"
+#include "../ExecutionContext.h"
+#include "../Node.h"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using namespace YAM;
+
+    typedef DependencyIndex::Id Id;
+
+    std::filesystem::path indexPath(std::string const& name) {
+        return std::filesystem::temp_directory_path() / ("yamDependencyIndexTest_" + name);
+    }
+
+    std::vector<std::string> namesOf(DependencyIndex const& index, std::vector<Id> const& ids) {
+        std::vector<std::string> names;
+        for (Id id : ids) names.push_back(std::string(index.name(id)));
+        return names;
+    }
+
+    class TestNode : public Node {
+    public:
+        TestNode(ExecutionContext* context, std::filesystem::path const& name)
+            : Node(context, name)
+        {}
+        uint32_t typeId() const override { return 0; }
+        void getInputs(std::vector<std::shared_ptr<Node>>& inputs) const override {
+            inputs.insert(inputs.end(), _inputs.begin(), _inputs.end());
+        }
+        void getOutputs(std::vector<std::shared_ptr<Node>>& outputs) const override {
+            outputs.insert(outputs.end(), _outputs.begin(), _outputs.end());
+        }
+
+        std::vector<std::shared_ptr<Node>> _inputs;
+        std::vector<std::shared_ptr<Node>> _outputs;
+    };
+
+    // main.exe depends on link, link depends on main.obj and lib.obj,
+    // main.obj depends on compile_main, compile_main depends on main.cpp
+    // and lib.h, lib.obj depends on compile_lib, compile_lib depends on
+    // lib.cpp and lib.h.
+    class Graph
+    {
+    public:
+        Graph() : path(indexPath("graph")) {
+            std::vector<std::string> names({
+                "main.exe", "link", "main.obj", "lib.obj", "compile_main",
+                "compile_lib", "main.cpp", "lib.cpp", "lib.h"
+                });
+            std::vector<std::pair<Id, Id>> edges({
+                { 0, 1 }, { 1, 2 }, { 1, 3 }, { 2, 4 }, { 3, 5 },
+                { 4, 6 }, { 4, 8 }, { 5, 7 }, { 5, 8 }, { 5, 8 }
+                });
+            DependencyIndex::write(path, names, edges);
+        }
+        ~Graph() {
+            std::filesystem::remove(path);
+        }
+
+        std::filesystem::path path;
+    };
+
+    TEST(DependencyIndex, writeAndRead) {
+        Graph graph;
+        DependencyIndex index(graph.path);
+        EXPECT_EQ(9, index.nNodes());
+        EXPECT_EQ(9, index.nEdges());
+        Id link = index.find("link");
+        ASSERT_NE(DependencyIndex::invalidId, link);
+        EXPECT_EQ("link", index.name(link));
+        EXPECT_EQ(DependencyIndex::invalidId, index.find("unknown"));
+        EXPECT_EQ(std::vector<std::string>({ "lib.obj", "main.obj" }),
+            namesOf(index, std::vector<Id>(index.deps(link).begin(), index.deps(link).end())));
+        Id libH = index.find("lib.h");
+        EXPECT_EQ(std::vector<std::string>({ "compile_lib", "compile_main" }),
+            namesOf(index, std::vector<Id>(index.rdeps(libH).begin(), index.rdeps(libH).end())));
+    }
+
+    TEST(DependencyIndex, queries) {
+        Graph graph;
+        DependencyIndex index(graph.path);
+        Id exe = index.find("main.exe");
+        Id libH = index.find("lib.h");
+        Id libCpp = index.find("lib.cpp");
+        EXPECT_EQ(
+            std::vector<std::string>({ "compile_lib", "compile_main", "lib.obj", "link", "main.exe", "main.obj" }),
+            namesOf(index, index.transitiveRdeps(libH)));
+        EXPECT_EQ(
+            std::vector<std::string>({ "compile_lib", "lib.cpp", "lib.h" }),
+            namesOf(index, index.transitiveDeps(index.find("lib.obj"))));
+        EXPECT_EQ(
+            std::vector<std::string>({ "main.exe", "link", "lib.obj", "compile_lib", "lib.cpp" }),
+            namesOf(index, index.somePath(exe, libCpp)));
+        EXPECT_TRUE(index.somePath(libCpp, exe).empty());
+        EXPECT_EQ(
+            std::vector<std::string>({ "compile_lib", "compile_main", "lib.h", "lib.obj", "link", "main.exe", "main.obj" }),
+            namesOf(index, index.allPaths(exe, libH)));
+        EXPECT_TRUE(index.allPaths(libH, exe).empty());
+    }
+
+    // cmd depends on its input src.cpp, out.obj depends on cmd because it
+    // is an output of cmd. Nodes that are not in context.nodes() are not
+    // indexed.
+    TEST(DependencyIndex, writeExecutionContext) {
+        ExecutionContext context;
+        std::filesystem::path repo("@@repo");
+        auto src = std::make_shared<TestNode>(&context, repo / "src.cpp");
+        auto cmd = std::make_shared<TestNode>(&context, repo / "cmd");
+        auto out = std::make_shared<TestNode>(&context, repo / "out.obj");
+        auto notAdded = std::make_shared<TestNode>(&context, repo / "notAdded");
+        cmd->_inputs = { src, notAdded };
+        cmd->_outputs = { out };
+        context.nodes().add(src);
+        context.nodes().add(cmd);
+        context.nodes().add(out);
+
+        std::filesystem::path path = indexPath("context");
+        DependencyIndex::write(path, &context);
+        {
+            DependencyIndex index(path);
+            EXPECT_EQ(3, index.nNodes());
+            EXPECT_EQ(2, index.nEdges());
+            EXPECT_EQ(DependencyIndex::invalidId, index.find((repo / "notAdded").string()));
+            Id outId = index.find((repo / "out.obj").string());
+            ASSERT_NE(DependencyIndex::invalidId, outId);
+            EXPECT_EQ(
+                std::vector<std::string>({ (repo / "cmd").string(), (repo / "src.cpp").string() }),
+                namesOf(index, index.transitiveDeps(outId)));
+        }
+        std::filesystem::remove(path);
+        context.nodes().clear();
+    }
+
+    // Writing replaces the index, also while a reader has mapped it. On
+    // Windows the write completes after the reader unmapped the index.
+    TEST(DependencyIndex, replaceMappedIndex) {
+        std::filesystem::path path = indexPath("replace");
+        DependencyIndex::write(path, { "a", "b" }, { { 0, 1 } });
+        auto mapped = std::make_unique<DependencyIndex>(path);
+        std::thread writer([&path]() {
+            DependencyIndex::write(path, { "a", "b", "c" }, { { 0, 1 }, { 1, 2 } });
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        EXPECT_EQ(2, mapped->nNodes());
+        EXPECT_EQ(1, mapped->nEdges());
+        mapped = nullptr;
+        writer.join();
+        {
+            DependencyIndex index(path);
+            EXPECT_EQ(3, index.nNodes());
+            EXPECT_EQ(2, index.nEdges());
+        }
+        std::filesystem::remove(path);
+    }
+
+    TEST(DependencyIndex, invalidFile) {
+        std::filesystem::path path = indexPath("invalid");
+        EXPECT_ANY_THROW(DependencyIndex index(path));
+        {
+            std::ofstream out(path);
+            out << "not an index";
+        }
+        EXPECT_ANY_THROW(DependencyIndex index(path));
+        std::filesystem::remove(path);
+    }
+
+    // Create nNodes nodes in chains of 10 nodes. The first node i of each
+    // chain depends on header node i % nHeaders, the other nodes on their
+    // predecessor in the chain.
+    void chainedGraph(
+        Id nNodes,
+        Id nHeaders,
+        std::vector<std::string>& names,
+        std::vector<std::pair<Id, Id>>& edges
+    ) {
+        for (Id i = 0; i < nNodes; ++i) {
+            names.push_back("@@repo/node_" + std::to_string(i));
+            if (i < nHeaders) continue;
+            if (i % 10 == 0) edges.push_back({ i, i % nHeaders });
+            else edges.push_back({ i, i - 1 });
+        }
+    }
+
+    // 1000 nodes, 9 chains depend on node_40.
+    TEST(DependencyIndex, chainedGraph) {
+        std::vector<std::string> names;
+        std::vector<std::pair<Id, Id>> edges;
+        chainedGraph(1000, 100, names, edges);
+        std::filesystem::path path = indexPath("chained");
+        DependencyIndex::write(path, names, edges);
+        {
+            DependencyIndex index(path);
+            EXPECT_EQ(1000, index.nNodes());
+            EXPECT_EQ(900, index.nEdges());
+            Id header = index.find("@@repo/node_40");
+            ASSERT_NE(DependencyIndex::invalidId, header);
+            EXPECT_EQ(9 * 10, index.transitiveRdeps(header).size());
+            Id last = index.find("@@repo/node_949");
+            EXPECT_EQ(11, index.somePath(last, header).size());
+        }
+        std::filesystem::remove(path);
+    }
+
+    // 1M nodes, 9999 chains depend on node_40.
+    // Benchmark, run with --gtest_also_run_disabled_tests.
+    TEST(DependencyIndex, DISABLED_largeGraph) {
+        const Id nNodes = 1000000;
+        const Id nHeaders = 100;
+        std::vector<std::string> names;
+        std::vector<std::pair<Id, Id>> edges;
+        chainedGraph(nNodes, nHeaders, names, edges);
+        std::filesystem::path path = indexPath("large");
+        auto start = std::chrono::high_resolution_clock::now();
+        DependencyIndex::write(path, names, edges);
+        auto writeDuration = std::chrono::high_resolution_clock::now() - start;
+
+        start = std::chrono::high_resolution_clock::now();
+        std::size_t nRdeps;
+        {
+            DependencyIndex index(path);
+            Id header = index.find("@@repo/node_40");
+            nRdeps = index.transitiveRdeps(header).size();
+        }
+        auto queryDuration = std::chrono::high_resolution_clock::now() - start;
+        std::filesystem::remove(path);
+
+        EXPECT_EQ(9999 * 10, nRdeps);
+        std::cout
+            << "nodes=" << nNodes << " edges=" << edges.size() << std::endl
+            << "ms to write=" << std::chrono::duration_cast<std::chrono::milliseconds>(writeDuration).count()
+            << " ms to map and query rdeps=" << std::chrono::duration_cast<std::chrono::milliseconds>(queryDuration).count() << std::endl;
+    }
+}
@@ -0,0 +1,88 @@
+#include "../DependencyQuery.h"
+#include "../DependencyIndex.h"
+#include "../DotYamDirectory.h"
+#include "../RepositoryNameFile.h"
+#include "../FileSystem.h"
+
+#include "gtest/gtest.h"
+
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using namespace YAM;
+
+    typedef DependencyIndex::Id Id;
+
+    std::string symbolic(std::filesystem::path const& path) {
+        return (std::filesystem::path("@@repo") / path).make_preferred().string();
+    }
+
+    // Repository named 'repo' with a dependency index in which main.exe
+    // depends on link, link depends on src/main.obj and src/main.obj
+    // depends on src/main.cpp.
+    class Repo
+    {
+    public:
+        Repo() {
+            RepositoryNameFile(tmp.dir).repoName("repo");
+            std::filesystem::path yamDir = DotYamDirectory::create(tmp.dir);
+            std::filesystem::create_directories(tmp.dir / "src");
+            std::vector<std::string> names({
+                symbolic("main.exe"), symbolic("link"),
+                symbolic("src/main.obj"), symbolic("src/main.cpp")
+                });
+            std::vector<std::pair<Id, Id>> edges({ { 0, 1 }, { 1, 2 }, { 2, 3 } });
+            DependencyIndex::write(DependencyIndex::filePath(yamDir), names, edges);
+        }
+
+        std::string query(std::vector<std::string> const& args, std::filesystem::path const& currentDir, int expectedResult) {
+            std::stringstream out;
+            EXPECT_EQ(expectedResult, DependencyQuery::run(args, currentDir, out));
+            return out.str();
+        }
+
+        TemporaryDirectory tmp;
+    };
+
+    TEST(DependencyQuery, deps) {
+        Repo repo;
+        EXPECT_EQ(
+            symbolic("link") + "\n" + symbolic("main.exe") + "\n",
+            repo.query({ "rdeps", "main.obj" }, repo.tmp.dir / "src", 0));
+        EXPECT_EQ(
+            symbolic("link") + "\n" + symbolic("src/main.cpp") + "\n" + symbolic("src/main.obj") + "\n",
+            repo.query({ "deps", "main.exe" }, repo.tmp.dir, 0));
+        EXPECT_EQ(
+            symbolic("src/main.cpp") + "\n",
+            repo.query({ "deps", symbolic("src/main.obj") }, repo.tmp.dir, 0));
+        EXPECT_EQ(
+            symbolic("src/main.cpp") + "\n" + symbolic("src/main.obj") + "\n",
+            repo.query({ "deps", "../link" }, repo.tmp.dir / "src", 0));
+    }
+
+    TEST(DependencyQuery, paths) {
+        Repo repo;
+        EXPECT_EQ(
+            symbolic("main.exe") + "\n" + symbolic("link") + "\n" + symbolic("src/main.obj") + "\n" + symbolic("src/main.cpp") + "\n",
+            repo.query({ "somepath", "main.exe", "src/main.cpp" }, repo.tmp.dir, 0));
+        EXPECT_EQ(
+            "No dependency path from " + symbolic("src/main.cpp") + " to " + symbolic("main.exe") + "\n",
+            repo.query({ "allpaths", "src/main.cpp", "main.exe" }, repo.tmp.dir, 0));
+    }
+
+    TEST(DependencyQuery, failures) {
+        Repo repo;
+        EXPECT_EQ(
+            "Unknown node: " + symbolic("unknown") + "\n",
+            repo.query({ "deps", "unknown" }, repo.tmp.dir, 1));
+        std::string usage = repo.query({ "deps" }, repo.tmp.dir, 1);
+        EXPECT_EQ(0, usage.find("USAGE: yam query"));
+        std::filesystem::remove(DependencyIndex::filePath(repo.tmp.dir / DotYamDirectory::yamName()));
+        std::string noIndex = repo.query({ "deps", "main.exe" }, repo.tmp.dir, 1);
+        EXPECT_NE(std::string::npos, noIndex.find("Run a build to create the dependency index."));
+    }
+}
@@ -0,0 +1,156 @@
+#include "../Node.h"
+#include "../NodeSet.h"
+#include "../ExecutionContext.h"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using namespace YAM;
+
+    class TestNode : public Node {
+    public:
+        TestNode(ExecutionContext* context, std::filesystem::path const& name)
+            : Node(context, name)
+        {}
+        uint32_t typeId() const override { return 0; }
+        void observe(Node* subject) { subject->addObserver(this); }
+        void unobserve(Node* subject) { subject->removeObserver(this); }
+    };
+
+    std::shared_ptr<TestNode> addNode(ExecutionContext& context, std::string const& name) {
+        auto node = std::make_shared<TestNode>(&context, std::filesystem::path("@@dirtyTest") / name);
+        context.nodes().add(node);
+        node->setState(Node::State::Ok);
+        return node;
+    }
+
+    std::size_t nDirtyNodes(ExecutionContext& context) {
+        return context.nodes().dirtyNodes(NodeKind::Other).size();
+    }
+
+    // Chain of nodes in which node i+1 observes node i.
+    TEST(DirtyPropagation, deepChain) {
+        ExecutionContext context;
+        std::vector<std::shared_ptr<TestNode>> chain;
+        for (std::size_t i = 0; i < 100000; ++i) {
+            chain.push_back(addNode(context, "chain/" + std::to_string(i)));
+            if (i > 0) chain[i]->observe(chain[i - 1].get());
+        }
+        EXPECT_EQ(0, nDirtyNodes(context));
+        chain[50000]->setState(Node::State::Dirty);
+        EXPECT_EQ(Node::State::Ok, chain[49999]->state());
+        for (std::size_t i = 50000; i < chain.size(); ++i) {
+            EXPECT_EQ(Node::State::Dirty, chain[i]->state());
+        }
+        EXPECT_EQ(50000, nDirtyNodes(context));
+        for (std::size_t i = 1; i < chain.size(); ++i) chain[i]->unobserve(chain[i - 1].get());
+        context.nodes().clear();
+    }
+
+    // Diamond: the bottom node is notified by both sides, becomes Dirty
+    // once and is registered once.
+    TEST(DirtyPropagation, diamond) {
+        ExecutionContext context;
+        auto top = addNode(context, "diamond/top");
+        auto left = addNode(context, "diamond/left");
+        auto right = addNode(context, "diamond/right");
+        auto bottom = addNode(context, "diamond/bottom");
+        left->observe(top.get());
+        right->observe(top.get());
+        bottom->observe(left.get());
+        bottom->observe(right.get());
+        top->setState(Node::State::Dirty);
+        EXPECT_EQ(Node::State::Dirty, bottom->state());
+        EXPECT_EQ(4, nDirtyNodes(context));
+        bottom->unobserve(left.get());
+        bottom->unobserve(right.get());
+        left->unobserve(top.get());
+        right->unobserve(top.get());
+        context.nodes().clear();
+    }
+
+    // Sets the observed node to Ok while the dirty propagation pass that
+    // made it Dirty is still in progress.
+    class ResettingObserver : public StateObserver {
+    public:
+        void handleCompletionOf(Node* observedNode) override {}
+        void handleDirtyOf(Node* observedNode) override {
+            observedNode->setState(Node::State::Ok);
+        }
+    };
+
+    // A node that leaves Dirty before the pass registers it is not
+    // registered.
+    TEST(DirtyPropagation, leaveDirtyDuringPass) {
+        ExecutionContext context;
+        ResettingObserver resetter;
+        auto top = addNode(context, "reset/top");
+        auto middle = addNode(context, "reset/middle");
+        auto bottom = addNode(context, "reset/bottom");
+        middle->observe(top.get());
+        bottom->observe(middle.get());
+        middle->addObserver(&resetter);
+        top->setState(Node::State::Dirty);
+        EXPECT_EQ(Node::State::Ok, middle->state());
+        EXPECT_EQ(Node::State::Dirty, bottom->state());
+        NodeList const& dirty = context.nodes().dirtyNodes(NodeKind::Other);
+        EXPECT_EQ(2, dirty.size());
+        EXPECT_TRUE(dirty.contains(top.get()));
+        EXPECT_FALSE(dirty.contains(middle.get()));
+        EXPECT_TRUE(dirty.contains(bottom.get()));
+        middle->removeObserver(&resetter);
+        bottom->unobserve(middle.get());
+        middle->unobserve(top.get());
+        context.nodes().clear();
+    }
+
+    // A header file observed by 1000 compile commands that are each
+    // observed by 100 downstream nodes: 100k nodes downstream of the
+    // header.
+    // Benchmark, run with --gtest_also_run_disabled_tests.
+    TEST(DirtyPropagation, DISABLED_invalidate100kDownstreamNodes) {
+        const std::size_t nCommands = 1000;
+        const std::size_t nDownstream = 100;
+        ExecutionContext context;
+        auto header = addNode(context, "header.h");
+        std::vector<std::shared_ptr<TestNode>> commands;
+        std::vector<std::shared_ptr<TestNode>> downstream;
+        for (std::size_t c = 0; c < nCommands; ++c) {
+            auto cmd = addNode(context, "cmd_" + std::to_string(c));
+            cmd->observe(header.get());
+            commands.push_back(cmd);
+            for (std::size_t d = 0; d < nDownstream; ++d) {
+                auto node = addNode(context, "cmd_" + std::to_string(c) + "/out_" + std::to_string(d));
+                node->observe(cmd.get());
+                downstream.push_back(node);
+            }
+        }
+
+        auto start = std::chrono::high_resolution_clock::now();
+        header->setState(Node::State::Dirty);
+        auto duration = std::chrono::high_resolution_clock::now() - start;
+
+        std::size_t nDirty = 0;
+        for (auto const& node : downstream) nDirty += node->state() == Node::State::Dirty;
+        EXPECT_EQ(nCommands * nDownstream, nDirty);
+        EXPECT_EQ(1 + nCommands + nCommands * nDownstream, nDirtyNodes(context));
+        std::cout
+            << "downstream nodes=" << downstream.size() << std::endl
+            << "ms to invalidate=" << std::chrono::duration_cast<std::chrono::milliseconds>(duration).count() << std::endl;
+
+        for (std::size_t c = 0; c < nCommands; ++c) {
+            commands[c]->unobserve(header.get());
+            for (std::size_t d = 0; d < nDownstream; ++d) {
+                downstream[c * nDownstream + d]->unobserve(commands[c].get());
+            }
+        }
+        context.nodes().clear();
+    }
+}
@@ -70,7 +70,7 @@ namespace
             logAspects.push_back(LogRecord::BuildStateUpdate);
             context->logBook()->aspects(logAspects);
             // make test a bit more deterministic
-            //context->threadPool().size(1);
+            //context->processPool().size(1);
 
             AccessMonitor::startMonitoring(wdir.dir);
         }
@@ -120,7 +120,7 @@ namespace
             request->repoDirectory(repoDir);
             request->repoName(repoName);
             BuildOptions options;
-            options._threads = static_cast<uint32_t>(context->threadPool().size());
+            options._threads = static_cast<uint32_t>(context->processPool().size());
             request->options(options);
             return executeRequest(request);
         }
@@ -44,6 +44,7 @@ namespace YAMTest
                 }
             }
             _nodes[0]->context()->mainThreadQueue().run(&_frame);
+            _nodes[0]->context()->statistics().merge();
 
             for (auto& pair : _handles) {
                 pair.first->completor().Remove(pair.second);
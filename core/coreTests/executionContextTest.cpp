@@ -3,11 +3,14 @@
 #include "../FileRepositoryNode.h"
 #include "../FileSystem.h"
 #include "../RepositoriesNode.h"
+#include "../MemoryLogBook.h"
 
 #include "gtest/gtest.h"
 #include <memory>
 #include <vector>
 #include <unordered_set>
+#include <atomic>
+#include <thread>
 
 namespace
 {
@@ -86,4 +89,58 @@ namespace
         setup.context.getBuildState(buildState);
         EXPECT_EQ(0, buildState.size());
     }
+
+    TEST(ExecutionContext, separateIoAndProcessPools) {
+        ExecutionContext context;
+        context.ioPool().size(1);
+        context.processPool().size(2);
+        EXPECT_EQ(1, context.ioPool().size());
+        EXPECT_EQ(2, context.processPool().size());
+        EXPECT_NE(&context.ioQueue(), &context.processQueue());
+        context.resetStatistics();
+
+        // I/O delegates execute while all process pool threads are busy.
+        std::atomic<bool> release = false;
+        std::atomic<bool> ioDone = false;
+        auto busy = [&release]() { while (!release) std::this_thread::yield(); };
+        for (int i = 0; i < 3; ++i) {
+            context.processQueue().push(Delegate<void>::CreateLambda(busy));
+        }
+        context.ioQueue().push(Delegate<void>::CreateLambda([&ioDone]() { ioDone = true; }));
+        while (!ioDone) std::this_thread::yield();
+        release = true;
+        context.processPool().join();
+        context.ioPool().join();
+
+        context.updateQueueStatistics();
+        ExecutionStatistics const& stats = context.statistics();
+        EXPECT_EQ(1, stats.ioQueue.nDelegates);
+        EXPECT_EQ(3, stats.processQueue.nDelegates);
+        EXPECT_LE(1, stats.processQueue.maxDepth);
+        EXPECT_GE(3, stats.processQueue.maxDepth);
+    }
+
+    TEST(ExecutionContext, resourcePoolCapacityConflict) {
+        ExecutionContext context;
+        auto logBook = std::make_shared<MemoryLogBook>();
+        context.logBook(logBook);
+        ResourceClaim claim;
+        claim.pool = "link";
+        claim.capacity = 4;
+        auto pool = context.resourcePool(claim);
+        EXPECT_EQ(4, pool->capacity());
+
+        // Conflicting claim in the same build.
+        claim.capacity = 2;
+        EXPECT_EQ(pool, context.resourcePool(claim));
+        EXPECT_EQ(4, pool->capacity());
+        ASSERT_EQ(1, logBook->records().size());
+        EXPECT_EQ(LogRecord::Error, logBook->records()[0].aspect);
+
+        // Capacity changed in next build.
+        context.resetResourcePoolClaims();
+        EXPECT_EQ(pool, context.resourcePool(claim));
+        EXPECT_EQ(2, pool->capacity());
+        EXPECT_EQ(1, logBook->records().size());
+    }
 }
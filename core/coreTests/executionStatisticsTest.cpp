@@ -0,0 +1,88 @@
+#include "../ExecutionStatistics.h"
+
+#include "gtest/gtest.h"
+
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using namespace YAM;
+
+    FileNode const* fileAt(std::size_t i) {
+        return reinterpret_cast<FileNode const*>(i + 1);
+    }
+
+    DirectoryNode const* dirAt(std::size_t i) {
+        return reinterpret_cast<DirectoryNode const*>(i + 1);
+    }
+
+    void registerFromThreads(ExecutionStatistics& stats, std::size_t nThreads, std::size_t nPerThread) {
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < nThreads; ++t) {
+            threads.push_back(std::thread([&stats, t, nPerThread]() {
+                for (std::size_t i = 0; i < nPerThread; ++i) {
+                    stats.registerRehashedFile(fileAt(t * nPerThread + i));
+                    if (i % 2 == 0) stats.registerUpdatedDirectory(dirAt(t * nPerThread + i));
+                }
+            }));
+        }
+        for (auto& thread : threads) thread.join();
+    }
+
+    TEST(ExecutionStatistics, mergeCountersOnly) {
+        ExecutionStatistics stats;
+        registerFromThreads(stats, 4, 1000);
+        EXPECT_EQ(0, stats.nRehashedFiles);
+        stats.merge();
+        EXPECT_EQ(4000, stats.nRehashedFiles);
+        EXPECT_EQ(2000, stats.nDirectoryUpdates);
+        EXPECT_TRUE(stats.rehashedFiles.empty());
+        EXPECT_TRUE(stats.updatedDirectories.empty());
+    }
+
+    TEST(ExecutionStatistics, mergeNodes) {
+        ExecutionStatistics stats;
+        stats.registerNodes = true;
+        registerFromThreads(stats, 4, 1000);
+        stats.merge();
+        EXPECT_EQ(4000, stats.nRehashedFiles);
+        EXPECT_EQ(4000, stats.rehashedFiles.size());
+        EXPECT_EQ(2000, stats.updatedDirectories.size());
+        EXPECT_TRUE(stats.rehashedFiles.contains(fileAt(0)));
+        EXPECT_TRUE(stats.rehashedFiles.contains(fileAt(3999)));
+        EXPECT_TRUE(stats.updatedDirectories.contains(dirAt(3998)));
+
+        // Registrations are merged once.
+        stats.merge();
+        EXPECT_EQ(4000, stats.nRehashedFiles);
+    }
+
+    TEST(ExecutionStatistics, reset) {
+        ExecutionStatistics stats;
+        stats.registerNodes = true;
+        stats.registerRehashedFile(fileAt(0));
+        stats.merge();
+        stats.registerRehashedFile(fileAt(1));
+        stats.reset();
+        EXPECT_EQ(0, stats.nRehashedFiles);
+        EXPECT_TRUE(stats.rehashedFiles.empty());
+        stats.merge();
+        EXPECT_EQ(0, stats.nRehashedFiles);
+        EXPECT_TRUE(stats.rehashedFiles.empty());
+    }
+
+    TEST(ExecutionStatistics, threadRegistersInMultipleStatistics) {
+        ExecutionStatistics stats1;
+        ExecutionStatistics stats2;
+        for (std::size_t i = 0; i < 10; ++i) {
+            stats1.registerRehashedFile(fileAt(i));
+            stats2.registerRehashedFile(fileAt(i));
+            stats2.registerRehashedFile(fileAt(i));
+        }
+        stats1.merge();
+        stats2.merge();
+        EXPECT_EQ(10, stats1.nRehashedFiles);
+        EXPECT_EQ(20, stats2.nRehashedFiles);
+    }
+}
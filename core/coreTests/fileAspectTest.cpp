@@ -1,4 +1,5 @@
 #include "../FileAspect.h"
+#include "../Xxh3.h"
 
 #include "gtest/gtest.h"
 
@@ -23,7 +24,7 @@ namespace
     }
 
     XXH64_hash_t hashString(std::string const& content) {
-        return XXH64(content.c_str(), content.length(), 0);
+        return Xxh3::hash64(content);
     }
     TEST(FileAspect, construct) {
         FileAspect aspect("cpp-code", RegexSet({ "\\.cpp$" , "\\.c$", "\\.h$" }), entireFileHasher);
@@ -61,4 +62,136 @@ namespace
         EXPECT_EQ(expectedHash, aspect.hash(testPath));
         std::filesystem::remove(testPath);
     }
-}
\ No newline at end of file
+}
+namespace
+{
+    using namespace YAM;
+
+    TEST(FileAspect, index) {
+        EXPECT_EQ(0, FileAspect::entireFileAspect().index());
+        FileAspect aspect1("cpp-code", RegexSet({ "\\.cpp$" }), entireFileHasher);
+        FileAspect aspect2("cpp-code", RegexSet({ "\\.h$" }), entireFileHasher);
+        FileAspect aspect3("c-code", RegexSet({ "\\.c$" }), entireFileHasher);
+        EXPECT_NE(0, aspect1.index());
+        EXPECT_EQ(aspect1.index(), aspect2.index());
+        EXPECT_NE(aspect1.index(), aspect3.index());
+        EXPECT_GT(FileAspect::maxAspects, aspect3.index());
+        EXPECT_EQ(FileAspect::maxAspects, FileAspect().index());
+    }
+
+    TEST(FileAspectHashes, setAndGet) {
+        FileAspect const& entireFile = FileAspect::entireFileAspect();
+        FileAspect code("cpp-code", RegexSet({ "\\.cpp$" }), entireFileHasher);
+        FileAspectHashes hashes;
+        EXPECT_FALSE(hashes.contains(entireFile));
+        EXPECT_FALSE(hashes.contains(FileAspect()));
+        hashes.set(entireFile, 1);
+        EXPECT_TRUE(hashes.contains(entireFile));
+        EXPECT_FALSE(hashes.contains(code));
+        EXPECT_EQ(1, hashes[entireFile]);
+
+        FileAspectHashes other;
+        other.set(entireFile, 1);
+        EXPECT_TRUE(hashes == other);
+        other.set(code, 2);
+        EXPECT_FALSE(hashes == other);
+        hashes.set(code, 2);
+        EXPECT_TRUE(hashes == other);
+        hashes.set(code, 3);
+        EXPECT_FALSE(hashes == other);
+    }
+
+    TEST(FileAspectIndexMap, storeAndRetrieve) {
+        FileAspect const& entireFile = FileAspect::entireFileAspect();
+        FileAspect code("cpp-code", RegexSet({ "\\.cpp$" }), entireFileHasher);
+        FileAspectHashes hashes;
+        hashes.set(entireFile, 1);
+        hashes.set(code, 2);
+
+        // Build states that map cpp-code to different build state indices.
+        FileAspectIndexMap map1;
+        map1.names({ "entireFile", "c-code", "cpp-code" });
+        FileAspectIndexMap map2;
+        map2.names({ "entireFile", "cpp-code" });
+        FileAspectHashes stored1;
+        map1.store(hashes, stored1);
+        FileAspectHashes stored2;
+        map2.store(hashes, stored2);
+        EXPECT_FALSE(map1.modified());
+        EXPECT_FALSE(map2.modified());
+        EXPECT_FALSE(stored1 == stored2);
+
+        FileAspectHashes retrieved;
+        map1.retrieve(stored1, retrieved);
+        EXPECT_TRUE(hashes == retrieved);
+        map2.retrieve(stored2, retrieved);
+        EXPECT_TRUE(hashes == retrieved);
+
+        // Storing adds the names of unmapped aspects.
+        FileAspectIndexMap map3;
+        FileAspectHashes stored3;
+        map3.store(hashes, stored3);
+        EXPECT_TRUE(map3.modified());
+        EXPECT_EQ(std::vector<std::string>({ "entireFile", "cpp-code" }), map3.names());
+        EXPECT_TRUE(stored2 == stored3);
+
+        // Hashes of aspects that are not in the build state are not retrieved.
+        FileAspectIndexMap map4;
+        map4.names({ "entireFile" });
+        map4.retrieve(stored2, retrieved);
+        EXPECT_TRUE(retrieved.contains(entireFile));
+        EXPECT_FALSE(retrieved.contains(code));
+        EXPECT_EQ(1, retrieved[entireFile]);
+    }
+
+    // A file is read once for all aspects that hash content in memory.
+    TEST(FileAspect, hashFileReadsOnce) {
+        auto seededHasher = [](XXH64_hash_t seed) {
+            return Delegate<XXH64_hash_t, std::string_view, IPriorityDispatcher*>::CreateLambda(
+                [seed](std::string_view content, IPriorityDispatcher*) {
+                    return Xxh3::hash64(content.data(), content.size(), seed);
+                });
+        };
+        std::vector<FileAspect> aspects({
+            FileAspect::entireFileAspect(),
+            FileAspect("cpp-code", RegexSet({ "\\.cpp$" }), seededHasher(1)),
+            FileAspect("c-code", RegexSet({ "\\.cpp$" }), seededHasher(2))
+        });
+        EXPECT_TRUE(createTestFile(testString));
+        FileAspectHashes hashes;
+        EXPECT_EQ(testString.size(), FileAspect::hashFile(testPath, aspects, hashes));
+        for (auto const& aspect : aspects) {
+            EXPECT_TRUE(hashes.contains(aspect));
+            EXPECT_EQ(aspect.hash(testPath), hashes[aspect]);
+            EXPECT_EQ(aspect.hashContent(testString), hashes[aspect]);
+        }
+        EXPECT_NE(hashes[aspects[0]], hashes[aspects[1]]);
+        EXPECT_NE(hashes[aspects[1]], hashes[aspects[2]]);
+        std::filesystem::remove(testPath);
+    }
+
+    // Aspects that only hash by path each read the file.
+    TEST(FileAspect, hashFileByPath) {
+        std::vector<FileAspect> aspects({
+            FileAspect::entireFileAspect(),
+            FileAspect("cpp-code", RegexSet({ "\\.cpp$" }), entireFileHasher)
+        });
+        EXPECT_FALSE(aspects[1].hashesContent());
+        EXPECT_TRUE(createTestFile(testString));
+        FileAspectHashes hashes;
+        bool readFailed = true;
+        EXPECT_EQ(2 * testString.size(), FileAspect::hashFile(testPath, aspects, hashes, nullptr, &readFailed));
+        EXPECT_FALSE(readFailed);
+        EXPECT_EQ(hashString(testString), hashes[aspects[0]]);
+        EXPECT_EQ(hashString(testString), hashes[aspects[1]]);
+        std::filesystem::remove(testPath);
+
+        EXPECT_EQ(0, FileAspect::hashFile(testPath, aspects, hashes, nullptr, &readFailed));
+        EXPECT_TRUE(readFailed);
+        EXPECT_EQ(0, hashes[aspects[0]]);
+        aspects.erase(aspects.begin());
+        readFailed = false;
+        FileAspect::hashFile(testPath, aspects, hashes, nullptr, &readFailed);
+        EXPECT_TRUE(readFailed);
+    }
+}
@@ -0,0 +1,177 @@
+#include "../FileHashCache.h"
+#include "../FileAspect.h"
+#include "../FileSystem.h"
+#include "../Xxh3.h"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using namespace YAM;
+
+    // Identity of a file that did not change recently.
+    FileHashCache::Identity identity(uint64_t fileId) {
+        FileHashCache::Identity id;
+        id.device = 1;
+        id.fileIdLow = fileId;
+        id.size = 100;
+        id.modified = 1000;
+        id.changed = 1000;
+        return id;
+    }
+
+    FileAspect const& entireFile = FileAspect::entireFileAspect();
+    FileAspect code("cpp-code", RegexSet({ "\\.cpp$" }), FileAspect::entireFileAspect().hashFunction());
+
+    TEST(FileHashCache, insertAndFind) {
+        TemporaryDirectory tmp;
+        FileHashCache cache(tmp.dir / "cache");
+        ASSERT_TRUE(cache.good());
+        XXH64_hash_t hash = 0;
+        EXPECT_FALSE(cache.find(identity(1), entireFile, hash));
+        cache.insert(identity(1), entireFile, 11);
+        cache.insert(identity(1), code, 12);
+        EXPECT_TRUE(cache.find(identity(1), entireFile, hash));
+        EXPECT_EQ(11, hash);
+        EXPECT_TRUE(cache.find(identity(1), code, hash));
+        EXPECT_EQ(12, hash);
+        EXPECT_FALSE(cache.find(identity(2), entireFile, hash));
+
+        cache.insert(identity(1), entireFile, 13);
+        EXPECT_TRUE(cache.find(identity(1), entireFile, hash));
+        EXPECT_EQ(13, hash);
+
+        FileHashCache::Identity modified = identity(1);
+        modified.modified += 1;
+        EXPECT_FALSE(cache.find(modified, entireFile, hash));
+    }
+
+    // Hashes computed by an older version of an aspect are not found.
+    TEST(FileHashCache, aspectVersion) {
+        TemporaryDirectory tmp;
+        FileHashCache cache(tmp.dir / "cache");
+        FileAspect code2("cpp-code", RegexSet({ "\\.cpp$" }), code.hashFunction(), 2);
+        cache.insert(identity(1), code, 11);
+        XXH64_hash_t hash = 0;
+        EXPECT_FALSE(cache.find(identity(1), code2, hash));
+        cache.insert(identity(1), code2, 12);
+        EXPECT_TRUE(cache.find(identity(1), code, hash));
+        EXPECT_EQ(11, hash);
+        EXPECT_TRUE(cache.find(identity(1), code2, hash));
+        EXPECT_EQ(12, hash);
+    }
+
+    TEST(FileHashCache, slotsFor) {
+        EXPECT_EQ(FileHashCache::minSlots, FileHashCache::slotsFor(0));
+        EXPECT_EQ(FileHashCache::minSlots, FileHashCache::slotsFor(FileHashCache::minSlots / 2));
+        EXPECT_EQ(4 * FileHashCache::minSlots, FileHashCache::slotsFor(FileHashCache::minSlots / 2 + 1));
+        EXPECT_EQ(16 * FileHashCache::minSlots, FileHashCache::slotsFor(2 * 1000 * 1000));
+        EXPECT_EQ(FileHashCache::maxSlots, FileHashCache::slotsFor(100 * 1000 * 1000));
+        EXPECT_NE(FileHashCache::defaultPath(FileHashCache::minSlots), FileHashCache::defaultPath(FileHashCache::maxSlots));
+
+        TemporaryDirectory tmp;
+        FileHashCache cache(tmp.dir / "cache", 4 * FileHashCache::minSlots);
+        ASSERT_TRUE(cache.good());
+        EXPECT_EQ(4 * FileHashCache::minSlots, cache.nSlots());
+        EXPECT_EQ(
+            sizeof(uint64_t) * (8 + 4 * cache.nSlots()),
+            std::filesystem::file_size(tmp.dir / "cache"));
+    }
+
+    TEST(FileHashCache, recentlyChangedFilesAreNotStored) {
+        TemporaryDirectory tmp;
+        FileHashCache cache(tmp.dir / "cache");
+        std::filesystem::path path(tmp.dir / "file");
+        std::ofstream(path) << "content";
+        FileHashCache::Identity id;
+        ASSERT_TRUE(FileHashCache::identify(path, id));
+        EXPECT_EQ(7, id.size);
+        cache.insert(id, entireFile, 1);
+        XXH64_hash_t hash;
+        EXPECT_FALSE(cache.find(id, entireFile, hash));
+    }
+
+    // The cache file is shared, e.g. by the yamServers of two worktrees.
+    TEST(FileHashCache, sharedByInstances) {
+        TemporaryDirectory tmp;
+        FileHashCache cache1(tmp.dir / "cache");
+        FileHashCache cache2(tmp.dir / "cache");
+        ASSERT_TRUE(cache2.good());
+        cache1.insert(identity(1), entireFile, 11);
+        XXH64_hash_t hash = 0;
+        EXPECT_TRUE(cache2.find(identity(1), entireFile, hash));
+        EXPECT_EQ(11, hash);
+    }
+
+    TEST(FileHashCache, hashFile) {
+        TemporaryDirectory tmp;
+        FileHashCache cache(tmp.dir / "cache");
+        std::filesystem::path path(tmp.dir / "file.cpp");
+        std::string content("int main() { return 0; }");
+        std::ofstream(path) << content;
+        std::vector<FileAspect> aspects({ FileAspect::entireFileAspect() });
+        FileAspectHashes hashes;
+        // Not stored: file changed less than a second ago.
+        EXPECT_EQ(content.size(), cache.hashFile(path, aspects, hashes));
+        EXPECT_EQ(content.size(), cache.hashFile(path, aspects, hashes));
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+        EXPECT_EQ(content.size(), cache.hashFile(path, aspects, hashes));
+        FileAspectHashes cachedHashes;
+        EXPECT_EQ(0, cache.hashFile(path, aspects, cachedHashes));
+        EXPECT_EQ(Xxh3::hash64(content), cachedHashes[aspects[0]]);
+    }
+
+    // Readers never see a hash of another key while writers overwrite the
+    // slots of a bucket.
+    TEST(FileHashCache, concurrentAccess) {
+        TemporaryDirectory tmp;
+        FileHashCache cache(tmp.dir / "cache");
+        const uint64_t nFiles = 2 * cache.nSlots();
+        std::vector<std::thread> threads;
+        std::atomic<bool> consistent(true);
+        for (uint64_t t = 0; t < 4; ++t) {
+            threads.push_back(std::thread([&cache, &consistent, t, nFiles]() {
+                for (uint64_t i = t; i < nFiles; i += 2) {
+                    cache.insert(identity(i), entireFile, i);
+                    XXH64_hash_t hash;
+                    if (cache.find(identity(i / 2), entireFile, hash) && hash != i / 2) consistent = false;
+                }
+            }));
+        }
+        for (auto& thread : threads) thread.join();
+        EXPECT_TRUE(consistent);
+    }
+
+    // Slots whose writer died while writing remain odd. Insertion uses the
+    // other slots of the bucket.
+    TEST(FileHashCache, slotsOfDeadWriters) {
+        TemporaryDirectory tmp;
+        std::filesystem::path path(tmp.dir / "cache");
+        {
+            // Header of 8 words followed by slots of 4 words, the first
+            // word of a slot is its sequence. Leave one slot per bucket
+            // of 8 slots usable.
+            std::vector<uint64_t> words(8 + 4 * FileHashCache::minSlots, 0);
+            for (std::size_t i = 0; i < FileHashCache::minSlots; ++i) {
+                if (i % 8 != 7) words[8 + 4 * i] = 1;
+            }
+            std::ofstream file(path, std::ios::binary);
+            file.write(reinterpret_cast<char const*>(words.data()), words.size() * sizeof(uint64_t));
+        }
+        FileHashCache cache(path);
+        ASSERT_TRUE(cache.good());
+        XXH64_hash_t hash = 0;
+        for (uint64_t i = 0; i < 100; ++i) {
+            cache.insert(identity(i), entireFile, i + 1000);
+            EXPECT_TRUE(cache.find(identity(i), entireFile, hash));
+            EXPECT_EQ(i + 1000, hash);
+        }
+    }
+}
@@ -6,6 +6,7 @@
 #include "../FileRepositoryNode.h"
 #include "../RepositoriesNode.h"
 #include "../xxhash.h"
+#include "../Xxh3.h"
 
 #include <chrono>
 #include <fstream>
@@ -23,10 +24,10 @@ namespace
     }
 
     XXH64_hash_t hashString(std::string const& content) {
-        return XXH64(content.c_str(), content.length(), 0);
+        return Xxh3::hash64(content);
     }
 
-    std::string entireFile = FileAspect::entireFileAspect().name();
+    FileAspect const& entireFile = FileAspect::entireFileAspect();
 
     class Driver {
     public:
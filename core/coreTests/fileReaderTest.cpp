@@ -0,0 +1,47 @@
+#include "../FileReader.h"
+#include "../FileSystem.h"
+
+#include "gtest/gtest.h"
+
+#include <fstream>
+#include <string>
+
+namespace
+{
+    using namespace YAM;
+
+    std::string createFile(std::filesystem::path const& path, std::size_t size) {
+        std::string content(size, ' ');
+        for (std::size_t i = 0; i < size; ++i) content[i] = static_cast<char>('a' + i % 26);
+        std::ofstream file(path, std::ios::binary);
+        file.write(content.data(), content.size());
+        return content;
+    }
+
+    bool readFile(std::filesystem::path const& path, std::string& content) {
+        return FileReader::read(path, Delegate<void, std::string_view>::CreateLambda(
+            [&content](std::string_view read) {
+                content = std::string(read);
+            }));
+    }
+
+    // Read files that are buffered and files that are memory mapped.
+    TEST(FileReader, read) {
+        TemporaryDirectory tmp;
+        for (std::size_t size : { std::size_t(0), std::size_t(1), FileReader::mapThreshold, FileReader::mapThreshold + 1, std::size_t(10 * 1024 * 1024 + 3) }) {
+            std::filesystem::path path(tmp.dir / ("file" + std::to_string(size)));
+            std::string expected = createFile(path, size);
+            std::string content("dummy");
+            EXPECT_TRUE(readFile(path, content));
+            EXPECT_EQ(size, content.size());
+            EXPECT_TRUE(expected == content);
+        }
+    }
+
+    TEST(FileReader, readNonExistingFile) {
+        TemporaryDirectory tmp;
+        std::string content("dummy");
+        EXPECT_FALSE(readFile(tmp.dir / "nonExisting", content));
+        EXPECT_EQ("dummy", content);
+    }
+}
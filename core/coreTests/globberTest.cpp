@@ -31,7 +31,7 @@ namespace
             , repoDir(FileSystem::createUniqueDirectory())
             , testTree(repoDir, 3, RegexSet({ }))
         {
-            //context.threadPool().size(1);
+            //context.ioPool().size(1);
             auto homeRepo = std::make_shared<FileRepositoryNode>(
                 &context,
                 "repo",
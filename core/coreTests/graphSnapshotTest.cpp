@@ -0,0 +1,170 @@
+#include "../GraphSnapshot.h"
+#include "../Node.h"
+#include "../NodeSet.h"
+#include "../ExecutionContext.h"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using namespace YAM;
+
+    class TestNode : public Node {
+    public:
+        TestNode(ExecutionContext* context, std::filesystem::path const& name)
+            : Node(context, name)
+        {}
+        uint32_t typeId() const override { return 0; }
+        void getInputs(std::vector<std::shared_ptr<Node>>& inputs) const override {
+            inputs.insert(inputs.end(), _inputs.begin(), _inputs.end());
+        }
+        std::vector<std::shared_ptr<Node>> _inputs;
+    };
+
+    std::shared_ptr<TestNode> addNode(ExecutionContext& context, std::string const& name) {
+        auto node = std::make_shared<TestNode>(&context, std::filesystem::path("@@snapshotTest") / name);
+        context.nodes().add(node);
+        node->setState(Node::State::Ok);
+        return node;
+    }
+
+    TEST(GraphSnapshot, initialSnapshotIsEmpty) {
+        ExecutionContext context;
+        auto snapshot = context.snapshot();
+        ASSERT_NE(nullptr, snapshot);
+        EXPECT_EQ(0, snapshot->epoch());
+        EXPECT_EQ(0, snapshot->size());
+    }
+
+    TEST(GraphSnapshot, snapshotIsImmutable) {
+        ExecutionContext context;
+        auto source = addNode(context, "source");
+        auto compile = addNode(context, "compile");
+        compile->_inputs.push_back(source);
+
+        auto first = context.publishSnapshot();
+        EXPECT_EQ(first, context.snapshot());
+        EXPECT_EQ(1, first->epoch());
+        EXPECT_EQ(2, first->size());
+        auto compileSnapshot = first->find(compile->name());
+        ASSERT_NE(nullptr, compileSnapshot);
+        EXPECT_EQ(compile->name(), compileSnapshot->name());
+        EXPECT_EQ(Node::State::Ok, compileSnapshot->state);
+        EXPECT_EQ(std::vector<PathInterner::Id>({ source->nameId() }), compileSnapshot->inputs);
+        EXPECT_TRUE(compileSnapshot->outputs.empty());
+        EXPECT_EQ(nullptr, first->find(std::filesystem::path("@@snapshotTest/unknown")));
+
+        compile->setState(Node::State::Failed);
+        auto header = addNode(context, "header");
+        compile->_inputs.push_back(header);
+        EXPECT_EQ(Node::State::Ok, first->find(compile->nameId())->state);
+        EXPECT_EQ(1, first->find(compile->nameId())->inputs.size());
+        EXPECT_EQ(nullptr, first->find(header->nameId()));
+
+        auto second = context.publishSnapshot();
+        EXPECT_EQ(2, second->epoch());
+        EXPECT_EQ(3, second->size());
+        EXPECT_EQ(Node::State::Failed, second->find(compile->nameId())->state);
+        EXPECT_EQ(2, second->find(compile->nameId())->inputs.size());
+
+        compile->_inputs.clear();
+        context.nodes().clear();
+    }
+
+    TEST(GraphSnapshot, unchangedNodesAreShared) {
+        ExecutionContext context;
+        auto a = addNode(context, "a");
+        auto b = addNode(context, "b");
+        auto first = context.publishSnapshot();
+        b->setState(Node::State::Dirty);
+        auto second = context.publishSnapshot();
+        EXPECT_EQ(first->find(a->nameId()), second->find(a->nameId()));
+        EXPECT_NE(first->find(b->nameId()), second->find(b->nameId()));
+        context.nodes().clear();
+    }
+
+    // A published snapshot only re-takes the nodes that changed since the
+    // previous snapshot and equals a snapshot of all nodes.
+    TEST(GraphSnapshot, incrementalSnapshot) {
+        ExecutionContext context;
+        std::vector<std::shared_ptr<TestNode>> nodes;
+        for (std::size_t i = 0; i < 100; ++i) nodes.push_back(addNode(context, "n" + std::to_string(i)));
+        auto first = context.publishSnapshot();
+        EXPECT_TRUE(context.nodes().snapshotChanges().empty());
+
+        nodes[3]->setState(Node::State::Failed);
+        nodes[7]->modified(true);
+        context.nodes().remove(nodes[5]);
+        auto added = addNode(context, "added");
+        EXPECT_EQ(4, context.nodes().snapshotChanges().size());
+        auto second = context.publishSnapshot();
+        EXPECT_TRUE(context.nodes().snapshotChanges().empty());
+
+        EXPECT_EQ(100, second->size());
+        EXPECT_EQ(Node::State::Failed, second->find(nodes[3]->nameId())->state);
+        EXPECT_EQ(first->find(nodes[7]->nameId()), second->find(nodes[7]->nameId()));
+        EXPECT_EQ(nullptr, second->find(nodes[5]->nameId()));
+        EXPECT_NE(nullptr, second->find(added->nameId()));
+        EXPECT_NE(nullptr, first->find(nodes[5]->nameId()));
+        EXPECT_EQ(nullptr, first->find(added->nameId()));
+
+        GraphSnapshot full(&context, nullptr, 0);
+        EXPECT_EQ(full.size(), second->size());
+        std::size_t nEqual = 0;
+        full.foreach(Delegate<void, std::shared_ptr<const NodeSnapshot> const&>::CreateLambda(
+            [&](std::shared_ptr<const NodeSnapshot> const& node) {
+                auto incremental = second->find(node->nameId);
+                if (incremental != nullptr && *incremental == *node) nEqual += 1;
+            }));
+        EXPECT_EQ(full.size(), nEqual);
+        context.nodes().clear();
+    }
+
+    // Query snapshots in another thread while nodes change state and new
+    // snapshots are published.
+    TEST(GraphSnapshot, concurrentQueries) {
+        const std::size_t nNodes = 1000;
+        ExecutionContext context;
+        std::vector<std::shared_ptr<TestNode>> nodes;
+        for (std::size_t i = 0; i < nNodes; ++i) nodes.push_back(addNode(context, "n" + std::to_string(i)));
+        context.publishSnapshot();
+
+        std::atomic<bool> done(false);
+        std::size_t nQueries = 0;
+        bool consistent = true;
+        std::thread reader([&]() {
+            uint64_t lastEpoch = 0;
+            while (!done) {
+                auto snapshot = context.snapshot();
+                if (snapshot->epoch() < lastEpoch || snapshot->size() != nNodes) consistent = false;
+                lastEpoch = snapshot->epoch();
+                // All nodes in a snapshot have the same state: they change
+                // state in between publications.
+                Node::State state = snapshot->find(nodes[0]->nameId())->state;
+                snapshot->foreach(Delegate<void, std::shared_ptr<const NodeSnapshot> const&>::CreateLambda(
+                    [&](std::shared_ptr<const NodeSnapshot> const& node) {
+                        if (node->state != state) consistent = false;
+                    }));
+                nQueries += 1;
+            }
+        });
+        for (int epoch = 0; epoch < 100; ++epoch) {
+            Node::State state = (epoch % 2 == 0) ? Node::State::Dirty : Node::State::Ok;
+            for (auto const& node : nodes) node->setState(state);
+            context.publishSnapshot();
+        }
+        done = true;
+        reader.join();
+
+        EXPECT_TRUE(consistent);
+        EXPECT_LT(0, nQueries);
+        EXPECT_EQ(101, context.snapshot()->epoch());
+        context.nodes().clear();
+    }
+}
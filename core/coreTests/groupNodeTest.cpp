@@ -0,0 +1,87 @@
+#include "executeNode.h"
+#include "../GroupNode.h"
+#include "../ExecutionContext.h"
+
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using namespace YAMTest;
+    using namespace YAM;
+
+    // Empty groups are used as group members because they execute without
+    // accessing the file system.
+    std::vector<std::shared_ptr<Node>> createMembers(ExecutionContext& context, std::size_t n) {
+        std::vector<std::shared_ptr<Node>> members;
+        for (std::size_t i = 0; i < n; ++i) {
+            auto member = std::make_shared<GroupNode>(&context, "@@.\\member" + std::to_string(i));
+            context.nodes().add(member);
+            members.push_back(member);
+        }
+        return members;
+    }
+
+    TEST(GroupNode, hashIsOrderIndependent) {
+        ExecutionContext context;
+        auto members = createMembers(context, 3);
+        auto group1 = std::make_shared<GroupNode>(&context, "@@.\\group1");
+        auto group2 = std::make_shared<GroupNode>(&context, "@@.\\group2");
+        for (auto it = members.begin(); it != members.end(); ++it) group1->add(*it);
+        for (auto it = members.rbegin(); it != members.rend(); ++it) group2->add(*it);
+        ASSERT_TRUE(executeNodes({ group1, group2 }));
+        EXPECT_EQ(group1->hash(), group2->hash());
+        group1->content({});
+        group2->content({});
+        context.nodes().clear();
+    }
+
+    TEST(GroupNode, hashChangesOnAddAndRemove) {
+        ExecutionContext context;
+        auto members = createMembers(context, 3);
+        auto group = std::make_shared<GroupNode>(&context, "@@.\\group");
+        group->content({ members[0], members[1] });
+        ASSERT_TRUE(executeNode(group.get()));
+        XXH64_hash_t hash01 = group->hash();
+
+        group->add(members[2]);
+        EXPECT_EQ(Node::State::Dirty, group->state());
+        EXPECT_EQ(hash01, group->hash());
+        ASSERT_TRUE(executeNode(group.get()));
+        EXPECT_NE(hash01, group->hash());
+
+        group->remove(members[2]);
+        ASSERT_TRUE(executeNode(group.get()));
+        EXPECT_EQ(hash01, group->hash());
+
+        group->remove(members[1]);
+        ASSERT_TRUE(executeNode(group.get()));
+        EXPECT_NE(hash01, group->hash());
+        group->content({});
+        context.nodes().clear();
+    }
+
+    // The incrementally maintained hash equals the hash of a group that was
+    // assigned the same content in one go.
+    TEST(GroupNode, incrementalHashEqualsRecomputedHash) {
+        ExecutionContext context;
+        auto members = createMembers(context, 10000);
+        auto incremental = std::make_shared<GroupNode>(&context, "@@.\\incremental");
+        for (auto const& member : members) incremental->add(member);
+        std::vector<std::shared_ptr<Node>> remaining;
+        for (std::size_t i = 0; i < members.size(); ++i) {
+            if (i % 3 == 0) incremental->remove(members[i]);
+            else remaining.push_back(members[i]);
+        }
+        auto recomputed = std::make_shared<GroupNode>(&context, "@@.\\recomputed");
+        recomputed->content(remaining);
+        ASSERT_TRUE(executeNodes({ incremental, recomputed }));
+        EXPECT_EQ(recomputed->hash(), incremental->hash());
+        incremental->content({});
+        recomputed->content({});
+        context.nodes().clear();
+    }
+}
@@ -0,0 +1,45 @@
+#include "../JobServer.h"
+
+#include "gtest/gtest.h"
+#include <Windows.h>
+
+namespace
+{
+    using namespace YAM;
+
+    TEST(JobServer, acquireAndRelease) {
+        JobServer server(2);
+        EXPECT_EQ(2, server.nTokens());
+        EXPECT_TRUE(server.acquire(std::chrono::milliseconds(0)));
+        EXPECT_TRUE(server.acquire(std::chrono::milliseconds(0)));
+        EXPECT_FALSE(server.acquire(std::chrono::milliseconds(10)));
+        server.release();
+        EXPECT_TRUE(server.acquire(std::chrono::milliseconds(0)));
+        server.release();
+        server.release();
+    }
+
+    TEST(JobServer, makeFlags) {
+        JobServer server(4);
+        std::string expected = "-j4 --jobserver-auth=" + server.name();
+        EXPECT_EQ(expected, server.makeFlags());
+    }
+
+    TEST(JobServer, childTakesTokens) {
+        JobServer server(2);
+
+        // Simulate a child process that acquires a token like GNU make does.
+        HANDLE child = OpenSemaphoreA(SEMAPHORE_ALL_ACCESS, FALSE, server.name().c_str());
+        ASSERT_NE(nullptr, child);
+        EXPECT_EQ(WAIT_OBJECT_0, WaitForSingleObject(child, 0));
+
+        EXPECT_TRUE(server.acquire(std::chrono::milliseconds(0)));
+        EXPECT_FALSE(server.acquire(std::chrono::milliseconds(10)));
+
+        ReleaseSemaphore(child, 1, nullptr);
+        CloseHandle(child);
+        EXPECT_TRUE(server.acquire(std::chrono::milliseconds(0)));
+        server.release();
+        server.release();
+    }
+}
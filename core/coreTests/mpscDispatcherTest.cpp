@@ -0,0 +1,181 @@
+#include "../Delegates.h"
+#include "../MpscDispatcher.h"
+#include "../PriorityDispatcher.h"
+#include "../DispatcherFrame.h"
+#include "../Thread.h"
+
+#include "gtest/gtest.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+
+namespace
+{
+    using namespace YAM;
+
+    int x = 5;
+    int y = 10;
+    int sum = x + y;
+
+    TEST(MpscDispatcher, pushPopAndExecute) {
+        int r1 = -1;
+        int r2 = -1;
+        int r3 = -1;
+        int r4 = -1;
+        auto l1add = [&r1]() {r1 = 1; };
+        auto l2add = [&r2]() {r2 = 2; };
+        auto l3add = [&r3]() {r3 = 3; };
+        auto l4add = [&r4]() {r4 = 4; };
+        MpscDispatcher q(3);
+        q.push(Delegate<void>::CreateLambda(l1add), 0);
+        q.push(Delegate<void>::CreateLambda(l2add), 1);
+        q.push(Delegate<void>::CreateLambda(l3add), 2);
+        q.push(Delegate<void>::CreateLambda(l4add), 2);
+        EXPECT_EQ(4, q.size());
+
+        Delegate<void> d3 = q.pop();
+        d3.Execute();
+        EXPECT_EQ(3, r3);
+        EXPECT_EQ(-1, r4);
+
+        // Higher priority delegate pushed after the batch was drained
+        // must be popped before the remaining delegates in the batch.
+        int r5 = -1;
+        q.push(Delegate<void>::CreateLambda([&r5]() { r5 = 5; }), 2);
+
+        Delegate<void> d4 = q.pop();
+        d4.Execute();
+        EXPECT_EQ(4, r4);
+
+        Delegate<void> d5 = q.pop();
+        d5.Execute();
+        EXPECT_EQ(5, r5);
+        EXPECT_EQ(-1, r2);
+
+        Delegate<void> d2 = q.pop();
+        d2.Execute();
+        EXPECT_EQ(2, r2);
+
+        Delegate<void> d1 = q.pop();
+        d1.Execute();
+        EXPECT_EQ(1, r1);
+        EXPECT_TRUE(q.empty());
+        EXPECT_EQ(2, q.nBatches());
+    }
+
+    TEST(MpscDispatcher, startStop) {
+        int r1 = -1;
+        auto l1add = [&r1]() {r1 = x + y; };
+        MpscDispatcher q(4);
+
+        q.stop();
+        q.push(Delegate<void>::CreateLambda(l1add), 2);
+        Delegate<void> d0 = q.pop();
+        EXPECT_FALSE(d0.IsBound());
+
+        q.start();
+        Delegate<void> d1 = q.pop();
+        EXPECT_TRUE(d1.IsBound());
+        d1.Execute();
+        EXPECT_EQ(sum, r1);
+    }
+
+    TEST(MpscDispatcher, runFrame) {
+        DispatcherFrame frame;
+        int r1 = -1;
+        int r2 = -1;
+        auto l1add = [&r1]() { r1 = x + y; };
+        auto l2add = [&r2]() { r2 = x + y; };
+        auto stop = [&frame]() { frame.stop(); };
+        MpscDispatcher q(4);
+
+        q.push(Delegate<void>::CreateLambda(l1add), 2);
+        q.push(Delegate<void>::CreateLambda(stop), 1);
+        q.push(Delegate<void>::CreateLambda(l2add), 0);
+        q.run(&frame);
+        EXPECT_EQ(sum, r1);
+        // Frame was stopped before the lowest priority delegate was executed.
+        EXPECT_EQ(-1, r2);
+        EXPECT_EQ(1, q.size());
+    }
+
+    TEST(MpscDispatcher, suspendResume) {
+        std::atomic<int> count = 0;
+        MpscDispatcher q(4);
+        Thread consumer(&q, "consumer");
+
+        q.suspend();
+        q.push(Delegate<void>::CreateLambda([&count]() { count++; }));
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        EXPECT_EQ(0, count);
+        EXPECT_EQ(1, q.size());
+
+        q.resume();
+        while (count == 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        EXPECT_EQ(1, count);
+        q.stop();
+        consumer.join();
+    }
+
+    // Push nProducers * nPerProducer delegates from nProducers threads to 
+    // a dispatcher that is consumed by one thread.
+    // Return the number of completions per second.
+    double measureCompletions(IPriorityDispatcher& q, int nProducers, int nPerProducer) {
+        DispatcherFrame frame;
+        int count = 0;
+        const int nTotal = nProducers * nPerProducer;
+        auto complete = [&count, &frame, nTotal]() { 
+            if (++count == nTotal) frame.stop();
+        };
+        std::atomic<bool> go = false;
+        std::vector<std::thread> producers;
+        for (int i = 0; i < nProducers; ++i) {
+            producers.push_back(std::thread([&q, &go, &complete, nPerProducer]() {
+                while (!go) std::this_thread::yield();
+                for (int j = 0; j < nPerProducer; ++j) {
+                    q.push(Delegate<void>::CreateLambda(complete));
+                }
+            }));
+        }
+        auto start = std::chrono::high_resolution_clock::now();
+        go = true;
+        q.run(&frame);
+        auto end = std::chrono::high_resolution_clock::now();
+        for (auto& t : producers) t.join();
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        return (1e9 * nTotal) / static_cast<double>(ns);
+    }
+
+    // measureCompletions returns when all pushed delegates were executed.
+    TEST(MpscDispatcher, concurrentProducers) {
+        MpscDispatcher q(4);
+        measureCompletions(q, 4, 1000);
+        EXPECT_TRUE(q.empty());
+        EXPECT_LE(1, q.nBatches());
+    }
+
+    // Compare completions per second of PriorityDispatcher (single lock) 
+    // with MpscDispatcher (lock-free push, batched drain) when 1..N threads
+    // post completions to one consumer, N = number of logical cores.
+    // Benchmark, run with --gtest_also_run_disabled_tests.
+    TEST(MpscDispatcher, DISABLED_completionsUnderContention) {
+        const int nCompletions = 400000;
+        int nCores = static_cast<int>(std::thread::hardware_concurrency());
+        for (int nProducers = 1; nProducers <= std::max(1, nCores); nProducers *= 2) {
+            PriorityDispatcher pq(32);
+            MpscDispatcher mq(32);
+            double pqRate = measureCompletions(pq, nProducers, nCompletions / nProducers);
+            double mqRate = measureCompletions(mq, nProducers, nCompletions / nProducers);
+            EXPECT_TRUE(mq.empty());
+            std::cout
+                << "producers=" << nProducers
+                << " PriorityDispatcher completions/s=" << static_cast<uint64_t>(pqRate)
+                << " MpscDispatcher completions/s=" << static_cast<uint64_t>(mqRate)
+                << " avg batch=" << (nCompletions / nProducers) * nProducers / std::max<uint64_t>(1, mq.nBatches())
+                << std::endl;
+        }
+    }
+}
@@ -0,0 +1,178 @@
+#include "../NodeMap.h"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace
+{
+    using namespace YAM;
+
+    class FakeNode
+    {
+    public:
+        FakeNode(std::filesystem::path const& name)
+            : _nameId(PathInterner::names().intern(name))
+            , _name(&PathInterner::names().path(_nameId))
+        {}
+        std::filesystem::path const& name() const { return *_name; }
+        PathInterner::Id nameId() const { return _nameId; }
+    private:
+        PathInterner::Id _nameId;
+        std::filesystem::path const* _name;
+    };
+
+    std::shared_ptr<FakeNode> create(std::string const& name) {
+        return std::make_shared<FakeNode>(std::filesystem::path("@@repo/nodeMapTest") / name);
+    }
+
+    std::vector<std::string> namesOf(std::vector<std::shared_ptr<FakeNode>> const& nodes) {
+        std::vector<std::string> names;
+        for (auto const& node : nodes) names.push_back(node->name().filename().string());
+        return names;
+    }
+
+    TEST(NodeMap, sortedByName) {
+        // Intern in reverse order to make id order differ from name order.
+        auto c = create("c");
+        auto b = create("b");
+        auto a = create("a");
+        NodeMap<FakeNode> map({ c, a, b, create("a") });
+        ASSERT_EQ(3, map.size());
+        std::vector<std::shared_ptr<FakeNode>> nodes;
+        for (auto const& pair : map) {
+            EXPECT_EQ(pair.first, pair.second->name());
+            nodes.push_back(pair.second);
+        }
+        EXPECT_EQ(a, nodes[0]);
+        EXPECT_EQ(b, nodes[1]);
+        EXPECT_EQ(c, nodes[2]);
+    }
+
+    TEST(NodeMap, findInsertErase) {
+        NodeMap<FakeNode> map;
+        auto b = create("b");
+        auto a = create("a");
+        EXPECT_TRUE(map.insert(b).second);
+        EXPECT_TRUE(map.insert(a).second);
+        EXPECT_FALSE(map.insert(create("b")).second);
+        EXPECT_EQ(2, map.size());
+        EXPECT_EQ(a, map.begin()->second);
+        EXPECT_EQ(b, map.find(b->name())->second);
+        EXPECT_TRUE(map.contains(a->name()));
+        EXPECT_FALSE(map.contains("@@repo/nodeMapTest/x"));
+        EXPECT_EQ(map.end(), map.find("@@repo/nodeMapTest/x"));
+        EXPECT_EQ(1, map.erase(a->name()));
+        EXPECT_EQ(0, map.erase(a->name()));
+        EXPECT_EQ(1, map.size());
+    }
+
+    TEST(NodeMap, update) {
+        auto a = create("a");
+        auto b = create("b");
+        auto c = create("c");
+        auto d = create("d");
+        NodeMap<FakeNode> map({ a, b, c });
+        map.update({ c, a }, { d });
+        EXPECT_TRUE(NodeMap<FakeNode>({ b, d }) == map);
+        EXPECT_ANY_THROW(map.update({ a }, {}));
+        EXPECT_ANY_THROW(map.update({}, { b }));
+    }
+
+    TEST(NodeMap, appendAndSort) {
+        auto b = create("b");
+        auto a = create("a");
+        NodeMap<FakeNode> map;
+        map.append(b);
+        map.append(a);
+        map.sort();
+        EXPECT_EQ(a, map.begin()->second);
+        EXPECT_EQ(map.begin().nameId(), a->nameId());
+    }
+
+    TEST(NodeMap, computeNodeMapDifference) {
+        auto a = create("a");
+        auto b = create("b");
+        auto c = create("c");
+        auto d = create("d");
+        NodeMap<FakeNode> map1({ a, b, c });
+        NodeMap<FakeNode> map2({ d, b, create("c") });
+        std::vector<std::shared_ptr<FakeNode>> inBoth, onlyIn1, onlyIn2;
+        computeNodeMapDifference(map1, map2, inBoth, onlyIn1, onlyIn2);
+        EXPECT_EQ(std::vector<std::string>({ "b", "c" }), namesOf(inBoth));
+        EXPECT_EQ(c, inBoth[1]);
+        EXPECT_EQ(std::vector<std::string>({ "a" }), namesOf(onlyIn1));
+        EXPECT_EQ(std::vector<std::string>({ "d" }), namesOf(onlyIn2));
+
+        std::set<std::filesystem::path> paths({ b->name(), d->name(), "@@repo/nodeMapTest/e" });
+        std::vector<std::filesystem::path> pathsOnlyIn2;
+        inBoth.clear(); onlyIn1.clear();
+        computeNodeMapDifference(map1, paths, inBoth, onlyIn1, pathsOnlyIn2);
+        EXPECT_EQ(std::vector<std::string>({ "b" }), namesOf(inBoth));
+        EXPECT_EQ(std::vector<std::string>({ "a", "c" }), namesOf(onlyIn1));
+        EXPECT_EQ(std::vector<std::filesystem::path>({ d->name(), "@@repo/nodeMapTest/e" }), pathsOnlyIn2);
+    }
+
+    // Rescans a directory with 10000 entries in which 1% of the entries
+    // was replaced. Compares the std::map/unordered_set implementation
+    // of the directory rescan with the NodeMap implementation.
+    // Benchmark, run with --gtest_also_run_disabled_tests.
+    TEST(NodeMap, DISABLED_rescanBenchmark) {
+        const std::size_t nEntries = 10000;
+        const std::size_t nRescans = 20;
+        std::vector<std::shared_ptr<FakeNode>> previous;
+        std::vector<std::shared_ptr<FakeNode>> current;
+        for (std::size_t i = 0; i < nEntries; ++i) {
+            auto node = create("rescan/file_" + std::to_string(i) + ".cpp");
+            previous.push_back(node);
+            if (i % 100 == 0) node = create("rescan/new_" + std::to_string(i) + ".cpp");
+            current.push_back(node);
+        }
+
+        std::map<std::filesystem::path, std::shared_ptr<FakeNode>> previousMap;
+        for (auto const& node : previous) previousMap.insert({ node->name(), node });
+        std::size_t nMapChanges = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (std::size_t r = 0; r < nRescans; ++r) {
+            std::map<std::filesystem::path, std::shared_ptr<FakeNode>> content;
+            std::unordered_set<std::shared_ptr<FakeNode>> added, kept, removed;
+            for (auto const& node : current) {
+                auto it = previousMap.find(node->name());
+                if (it != previousMap.end()) kept.insert(it->second);
+                else added.insert(node);
+                content.insert({ node->name(), node });
+            }
+            for (auto const& pair : previousMap) {
+                if (!kept.contains(pair.second)) removed.insert(pair.second);
+            }
+            nMapChanges += added.size() + removed.size();
+        }
+        auto mapDuration = std::chrono::high_resolution_clock::now() - start;
+
+        NodeMap<FakeNode> previousNodeMap(previous);
+        std::size_t nNodeMapChanges = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (std::size_t r = 0; r < nRescans; ++r) {
+            NodeMap<FakeNode> content(current);
+            std::vector<std::shared_ptr<FakeNode>> added, kept, removed;
+            computeNodeMapDifference(content, previousNodeMap, kept, added, removed);
+            nNodeMapChanges += added.size() + removed.size();
+        }
+        auto nodeMapDuration = std::chrono::high_resolution_clock::now() - start;
+
+        EXPECT_EQ(nRescans * 2 * nEntries / 100, nMapChanges);
+        EXPECT_EQ(nMapChanges, nNodeMapChanges);
+        auto us = [nRescans](auto duration) {
+            return std::chrono::duration_cast<std::chrono::microseconds>(duration).count() / nRescans;
+        };
+        std::cout
+            << "entries=" << nEntries << std::endl
+            << "us per rescan: std::map=" << us(mapDuration) << " NodeMap=" << us(nodeMapDuration) << std::endl;
+    }
+}
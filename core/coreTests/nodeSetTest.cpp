@@ -87,4 +87,49 @@ namespace
         EXPECT_EQ(0, set.size());
         EXPECT_EQ(nullptr, set.find(setUp.n1->name()));
     }
-}
\ No newline at end of file
+
+    TEST(NodeSet, DirtyAndFailedRegistries) {
+        NodeSetUp setUp;
+        NodeSet& set = setUp.context.nodes();
+        set.add(setUp.n1);
+        set.add(setUp.n2);
+        NodeList const& dirty = set.dirtyNodes(NodeKind::Other);
+        NodeList const& failed = set.failedOrCanceledNodes(NodeKind::Other);
+        EXPECT_EQ(2, dirty.size());
+        EXPECT_TRUE(dirty.contains(setUp.n1.get()));
+        EXPECT_TRUE(set.dirtyNodes(NodeKind::Command).empty());
+
+        setUp.n1->setState(Node::State::Failed);
+        EXPECT_EQ(1, dirty.size());
+        EXPECT_EQ(setUp.n2.get(), *dirty.begin());
+        EXPECT_TRUE(failed.contains(setUp.n1.get()));
+        std::vector<std::shared_ptr<Node>> dirtyNodes;
+        setUp.context.getDirtyNodes(dirtyNodes);
+        EXPECT_EQ(std::vector<std::shared_ptr<Node>>({ setUp.n2 }), dirtyNodes);
+
+        setUp.n1->setState(Node::State::Dirty);
+        EXPECT_TRUE(failed.empty());
+        EXPECT_EQ(2, dirty.size());
+
+        set.remove(setUp.n2);
+        EXPECT_EQ(1, dirty.size());
+        EXPECT_FALSE(dirty.contains(setUp.n2.get()));
+        set.clear();
+        EXPECT_TRUE(dirty.empty());
+    }
+
+    TEST(NodeList, destroyedNodeIsUnlinked) {
+        ExecutionContext context;
+        NodeList list;
+        auto n1 = std::make_shared<TestNode>(&context, "aap/noot");
+        auto n2 = std::make_shared<TestNode>(&context, "aap/noot/mies");
+        list.pushBack(n1.get());
+        list.pushBack(n2.get());
+        n1 = nullptr;
+        EXPECT_EQ(1, list.size());
+        EXPECT_EQ(n2.get(), *list.begin());
+        n2 = nullptr;
+        EXPECT_TRUE(list.empty());
+        EXPECT_EQ(list.end(), list.begin());
+    }
+}
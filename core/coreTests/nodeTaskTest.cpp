@@ -0,0 +1,106 @@
+#include "../NodeTask.h"
+#include "../PriorityDispatcher.h"
+#include "../Thread.h"
+
+#include "gtest/gtest.h"
+
+#include <thread>
+#include <vector>
+#include <stdexcept>
+
+namespace
+{
+    using namespace YAM;
+
+    NodeTask resumeOnce(IPriorityDispatcher& q, PriorityClass prio, std::vector<int>& trace, int id) {
+        trace.push_back(id);
+        co_await ResumeOn(q, prio);
+        trace.push_back(10 * id);
+    }
+
+    NodeTask resumeOnThread(
+        IPriorityDispatcher& q,
+        Thread const& thread,
+        std::thread::id& resumedIn,
+        bool& readyInThread
+    ) {
+        co_await ResumeOn(q, PriorityClass::Medium, &thread);
+        resumedIn = std::this_thread::get_id();
+        readyInThread = ResumeOn(q, PriorityClass::Medium, &thread).await_ready();
+        co_await ResumeOn(q, PriorityClass::Medium, &thread);
+        q.stop();
+    }
+
+    NodeTask throwBeforeSuspension() {
+        throw std::runtime_error("node task failed");
+        co_return;
+    }
+
+    NodeTask throwAfterSuspension(IPriorityDispatcher& q, bool& resumed) {
+        co_await ResumeOn(q, PriorityClass::Medium);
+        resumed = true;
+        throw std::runtime_error("node task failed");
+    }
+
+    TEST(NodeTask, runsUntilFirstSuspension) {
+        PriorityDispatcher q(4);
+        std::vector<int> trace;
+        resumeOnce(q, PriorityClass::Medium, trace, 1).start();
+        EXPECT_EQ(std::vector<int>({ 1 }), trace);
+        EXPECT_EQ(1, q.size());
+        q.popAndExecute();
+        EXPECT_EQ(std::vector<int>({ 1, 10 }), trace);
+        EXPECT_TRUE(q.empty());
+    }
+
+    TEST(NodeTask, resumeInPriorityOrder) {
+        PriorityDispatcher q(4);
+        std::vector<int> trace;
+        resumeOnce(q, PriorityClass::Low, trace, 1).start();
+        resumeOnce(q, PriorityClass::VeryHigh, trace, 2).start();
+        resumeOnce(q, PriorityClass::Medium, trace, 3).start();
+        EXPECT_EQ(3, q.size());
+        while (!q.empty()) q.popAndExecute();
+        EXPECT_EQ(std::vector<int>({ 1, 2, 3, 20, 30, 10 }), trace);
+    }
+
+    TEST(NodeTask, resumeOnThread) {
+        PriorityDispatcher q(4);
+        std::thread::id resumedIn;
+        bool readyInThread = false;
+        {
+            Thread t(&q, "t");
+            EXPECT_FALSE(ResumeOn(q, PriorityClass::Medium, &t).await_ready());
+            resumeOnThread(q, t, resumedIn, readyInThread).start();
+            t.join();
+        }
+        EXPECT_NE(std::this_thread::get_id(), resumedIn);
+        EXPECT_TRUE(readyInThread);
+        EXPECT_TRUE(q.empty());
+    }
+
+    TEST(NodeTask, runsOnlyWhenStarted) {
+        PriorityDispatcher q(4);
+        std::vector<int> trace;
+        {
+            NodeTask task = resumeOnce(q, PriorityClass::Medium, trace, 1);
+            EXPECT_TRUE(trace.empty());
+        }
+        EXPECT_TRUE(trace.empty());
+        EXPECT_TRUE(q.empty());
+    }
+
+    TEST(NodeTask, exceptionPropagatesToCaller) {
+        EXPECT_THROW(throwBeforeSuspension().start(), std::runtime_error);
+    }
+
+    TEST(NodeTask, exceptionPropagatesToDispatcher) {
+        PriorityDispatcher q(4);
+        bool resumed = false;
+        throwAfterSuspension(q, resumed).start();
+        EXPECT_FALSE(resumed);
+        EXPECT_THROW(q.popAndExecute(), std::runtime_error);
+        EXPECT_TRUE(resumed);
+        EXPECT_TRUE(q.empty());
+    }
+}
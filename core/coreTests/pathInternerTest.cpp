@@ -0,0 +1,180 @@
+#include "../PathInterner.h"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    using namespace YAM;
+
+    std::size_t heapSize(std::filesystem::path const& path) {
+        auto const& s = path.native();
+        return s.capacity() > std::filesystem::path::string_type().capacity()
+            ? (s.capacity() + 1) * sizeof(std::filesystem::path::value_type)
+            : 0;
+    }
+
+    // Names of a synthetic repository with 3 levels of nDirs directories
+    // and nFiles files per leaf directory.
+    std::vector<std::filesystem::path> createNames(std::size_t nDirs, std::size_t nFiles) {
+        std::vector<std::filesystem::path> names;
+        std::filesystem::path repo("@@repo");
+        for (std::size_t d1 = 0; d1 < nDirs; ++d1) {
+            auto p1 = repo / ("component_" + std::to_string(d1));
+            names.push_back(p1);
+            for (std::size_t d2 = 0; d2 < nDirs; ++d2) {
+                auto p2 = p1 / ("module_" + std::to_string(d2));
+                names.push_back(p2);
+                for (std::size_t d3 = 0; d3 < nDirs; ++d3) {
+                    auto p3 = p2 / ("src_" + std::to_string(d3));
+                    names.push_back(p3);
+                    for (std::size_t f = 0; f < nFiles; ++f) {
+                        names.push_back(p3 / ("source_file_" + std::to_string(f) + ".cpp"));
+                    }
+                }
+            }
+        }
+        return names;
+    }
+
+    TEST(PathInterner, intern) {
+        PathInterner interner;
+        EXPECT_EQ(1, interner.size());
+        EXPECT_EQ(PathInterner::emptyId, interner.find(""));
+        EXPECT_EQ(std::filesystem::path(), interner.path(PathInterner::emptyId));
+
+        std::filesystem::path a("@@repo/a");
+        std::filesystem::path ab("@@repo/a/b.cpp");
+        PathInterner::Id idAB = interner.intern(ab);
+        EXPECT_EQ(4, interner.size()); // empty, @@repo, a, b.cpp
+        EXPECT_EQ(ab, interner.path(idAB));
+        EXPECT_EQ(idAB, interner.intern(ab));
+        EXPECT_EQ(4, interner.size());
+
+        // The prefix is found but its full path is not stored until it is
+        // interned.
+        PathInterner::Id idA = interner.find(a);
+        EXPECT_NE(PathInterner::invalidId, idA);
+        EXPECT_EQ(a, interner.rebuildPath(idA));
+        EXPECT_EQ(ab, interner.rebuildPath(idAB));
+        EXPECT_EQ(idA, interner.parent(idAB));
+        EXPECT_EQ(idA, interner.intern(a));
+        EXPECT_EQ(a, interner.path(idA));
+
+        EXPECT_EQ(PathInterner::invalidId, interner.find("@@repo/a/c.cpp"));
+        EXPECT_EQ(PathInterner::invalidId, interner.find("@@repo/b"));
+        EXPECT_EQ(4, interner.size());
+    }
+
+    TEST(PathInterner, stableReferences) {
+        PathInterner interner;
+        auto names = createNames(4, 100);
+        std::vector<std::filesystem::path const*> paths;
+        for (auto const& name : names) {
+            paths.push_back(&interner.path(interner.intern(name)));
+        }
+        for (std::size_t i = 0; i < names.size(); ++i) {
+            EXPECT_EQ(names[i], *paths[i]);
+            EXPECT_EQ(paths[i], &interner.path(interner.find(names[i])));
+        }
+    }
+
+    // Re-creating the nodes of a repository, e.g. after the build state
+    // was cleared and reloaded, does not grow the interner. New names only
+    // add their new components.
+    TEST(PathInterner, sizeBoundedByDistinctNames) {
+        PathInterner interner;
+        auto names = createNames(4, 100);
+        for (auto const& name : names) interner.intern(name);
+        std::size_t size = interner.size();
+        std::size_t memoryUsage = interner.memoryUsage();
+        for (int reload = 0; reload < 10; ++reload) {
+            for (auto const& name : names) interner.intern(name);
+        }
+        EXPECT_EQ(size, interner.size());
+        EXPECT_EQ(memoryUsage, interner.memoryUsage());
+
+        interner.intern(names[0].parent_path() / "renamed.cpp");
+        EXPECT_EQ(size + 1, interner.size());
+    }
+
+    TEST(PathInterner, concurrentIntern) {
+        PathInterner interner;
+        auto names = createNames(4, 100);
+        std::vector<std::vector<PathInterner::Id>> ids(4);
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < ids.size(); ++t) {
+            threads.push_back(std::thread([&interner, &names, &ids, t]() {
+                for (auto const& name : names) ids[t].push_back(interner.intern(name));
+            }));
+        }
+        for (auto& thread : threads) thread.join();
+        for (std::size_t t = 1; t < ids.size(); ++t) EXPECT_EQ(ids[0], ids[t]);
+        for (std::size_t i = 0; i < names.size(); ++i) EXPECT_EQ(names[i], interner.path(ids[0][i]));
+    }
+
+    // Compares memory and lookup latency of a map keyed by path, with nodes
+    // that store a copy of their name, to a map keyed by interned name id.
+    // Benchmark, run with --gtest_also_run_disabled_tests.
+    TEST(PathInterner, DISABLED_largeRepositoryBenchmark) {
+        auto names = createNames(20, 25); // 8420 dirs, 200000 files
+        auto node = std::make_shared<int>(0);
+
+        std::unordered_map<std::filesystem::path, std::shared_ptr<int>> pathMap;
+        std::vector<std::filesystem::path> nodeNames;
+        std::size_t pathBytes = 0;
+        for (auto const& name : names) {
+            pathMap.insert({ name, node });
+            nodeNames.push_back(name);
+            // node name + key + hash table node + bucket
+            pathBytes += 2 * (sizeof(std::filesystem::path) + heapSize(name));
+            pathBytes += sizeof(std::shared_ptr<int>) + 3 * sizeof(void*);
+        }
+
+        PathInterner interner;
+        std::unordered_map<PathInterner::Id, std::shared_ptr<int>> idMap;
+        std::vector<PathInterner::Id> ids;
+        for (auto const& name : names) {
+            PathInterner::Id id = interner.intern(name);
+            idMap.insert({ id, node });
+            ids.push_back(id);
+        }
+        std::size_t idBytes = interner.memoryUsage();
+        // node name id + name pointer + key + hash table node + bucket
+        idBytes += names.size() * (sizeof(PathInterner::Id) + sizeof(void*));
+        idBytes += names.size() * (sizeof(PathInterner::Id) + sizeof(std::shared_ptr<int>) + 3 * sizeof(void*));
+
+        std::size_t nFound = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (auto const& name : names) nFound += pathMap.contains(name);
+        auto pathLookup = std::chrono::high_resolution_clock::now() - start;
+
+        start = std::chrono::high_resolution_clock::now();
+        for (auto const& name : names) nFound += idMap.contains(interner.find(name));
+        auto nameLookup = std::chrono::high_resolution_clock::now() - start;
+
+        start = std::chrono::high_resolution_clock::now();
+        for (auto id : ids) nFound += idMap.contains(id);
+        auto idLookup = std::chrono::high_resolution_clock::now() - start;
+
+        EXPECT_EQ(3 * names.size(), nFound);
+        EXPECT_EQ(names.size() + 2, interner.size()); // + empty and @@repo
+
+        auto ns = [&names](auto duration) {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count() / names.size();
+        };
+        std::cout
+            << "nodes=" << names.size() << std::endl
+            << "path keyed MB=" << pathBytes / (1024 * 1024)
+            << " id keyed MB=" << idBytes / (1024 * 1024) << std::endl
+            << "ns per lookup by path=" << ns(pathLookup)
+            << " by interned path=" << ns(nameLookup)
+            << " by id=" << ns(idLookup) << std::endl;
+    }
+}
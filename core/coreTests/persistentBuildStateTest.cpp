@@ -43,7 +43,7 @@ namespace
     // Return whether event was consumed.
     bool consumeFileChangeEvents(
         FileRepositoryNode* sourceFileRepo,
-        PriorityDispatcher& mainThreadQueue,
+        IPriorityDispatcher& mainThreadQueue,
         std::initializer_list<std::filesystem::path> paths)
     {
         std::atomic<bool> received = false;
@@ -91,7 +91,7 @@ namespace
             , testTree(repoDir, 0, RegexSet({ ".yam" }))
             , persistentState(getBuildStateFile(repoDir), &context)
         {
-            //context.threadPool().size(1);
+            //context.ioPool().size(1);
             auto homeRepo = std::make_shared<FileRepositoryNode>(
                 &context,
                 "repo",
@@ -120,7 +120,7 @@ namespace
             , testTree(repoDir, 3, RegexSet({ ".yam" }))
             , persistentState(getBuildStateFile(repoDir), &context)
         {
-            //context.threadPool().size(1);
+            //context.ioPool().size(1);
             auto homeRepo = std::make_shared<FileRepositoryNode>(
                 &context,
                 "repo",
@@ -215,11 +215,11 @@ namespace
             auto symFile3 = sourceFileRepo()->symbolicPathOf(file3);
             auto node = dynamic_pointer_cast<FileNode>(context.nodes().find(symFile3));
             YAMTest::executeNode(node.get());
-            XXH64_hash_t oldHash = node->hashOf(FileAspect::entireFileAspect().name());
+            XXH64_hash_t oldHash = node->hashOf(FileAspect::entireFileAspect());
             updateFile(file3);
             consumeFileChangeEvent({ file3 });
             YAMTest::executeNode(node.get());
-            XXH64_hash_t newHash = node->hashOf(FileAspect::entireFileAspect().name());
+            XXH64_hash_t newHash = node->hashOf(FileAspect::entireFileAspect());
             EXPECT_NE(oldHash, newHash);
             return { file3, oldHash };
         }
@@ -264,7 +264,7 @@ namespace
         XXH64_hash_t addFileAndUpdateFileAndExecuteNode(std::shared_ptr<FileNode> fileNode) {
             bool completed = YAMTest::executeNode(fileNode.get());
             EXPECT_TRUE(completed);
-            auto hash = fileNode->hashOf(FileAspect::entireFileAspect().name());
+            auto hash = fileNode->hashOf(FileAspect::entireFileAspect());
             setup.testTree.addFile(); // add File4
             setup.updateFile(fileNode->absolutePath());
             bool consumed = consumeFileChangeEvent({ fileNode->absolutePath(), setup.repoDir / "File4" });
@@ -279,7 +279,7 @@ namespace
             completed = YAMTest::executeNodes(dirtyNodes);
             EXPECT_TRUE(completed);
             // ... and verify that hash has changed
-            auto updatedHash = fileNode->hashOf(FileAspect::entireFileAspect().name());
+            auto updatedHash = fileNode->hashOf(FileAspect::entireFileAspect());
             EXPECT_NE(hash, updatedHash);
             return updatedHash;
         }
@@ -437,7 +437,7 @@ namespace
         EXPECT_NE(nullptr, newFileNode);
         EXPECT_FALSE(newFileNode->modified());
 
-        auto actualHash = fileNode->hashOf(FileAspect::entireFileAspect().name());
+        auto actualHash = fileNode->hashOf(FileAspect::entireFileAspect());
         EXPECT_EQ(updatedHash, actualHash);
     }
 
@@ -525,7 +525,7 @@ namespace
         EXPECT_EQ(nNodes, setup.context.nodes().size());
         auto symModifiedFile = setup.sourceFileRepo()->symbolicPathOf(modifiedFile);
         auto node = dynamic_pointer_cast<FileNode>(setup.context.nodes().find(symModifiedFile));
-        XXH64_hash_t hash = node->hashOf(FileAspect::entireFileAspect().name());
+        XXH64_hash_t hash = node->hashOf(FileAspect::entireFileAspect());
         EXPECT_EQ(hashBeforeModify, hash);
         // Verify that the rolled-back build state can be executed
         setup.executeAll();
@@ -547,7 +547,7 @@ namespace
             , testTree(repoDir, 4, RegexSet({ ".yam" }))
             , persistentState(getBuildStateFile(repoDir), &context)
         {
-            context.threadPool().size(1);
+            context.ioPool().size(1);
             std::filesystem::create_directory(repoDir / "r0");
             std::filesystem::create_directory(repoDir / "r1");
             persistentState.retrieve();
@@ -0,0 +1,79 @@
+#include "../ResourcePool.h"
+#include "../PriorityDispatcher.h"
+
+#include "gtest/gtest.h"
+#include <vector>
+
+namespace
+{
+    using namespace YAM;
+
+    TEST(ResourcePool, admitWhenTokensAvailable) {
+        PriorityDispatcher q(4);
+        auto pool = std::make_shared<ResourcePool>("link", 2, q);
+        std::vector<int> executed;
+
+        pool->admit(Delegate<void>::CreateLambda([&executed]() { executed.push_back(1); }), 1, 1);
+        pool->admit(Delegate<void>::CreateLambda([&executed]() { executed.push_back(2); }), 1, 1);
+        pool->admit(Delegate<void>::CreateLambda([&executed]() { executed.push_back(3); }), 1, 1);
+        EXPECT_EQ(2, q.size());
+        EXPECT_EQ(1, pool->nWaiting());
+        EXPECT_EQ(0, pool->available());
+
+        // Executing an admitted delegate releases its token, hence admits 3.
+        q.popAndExecute();
+        EXPECT_EQ(2, q.size());
+        EXPECT_EQ(0, pool->nWaiting());
+        q.popAndExecute();
+        q.popAndExecute();
+        EXPECT_EQ(std::vector<int>({ 1, 2, 3 }), executed);
+        EXPECT_EQ(2, pool->available());
+    }
+
+    TEST(ResourcePool, admitInPriorityOrder) {
+        PriorityDispatcher q(4);
+        auto pool = std::make_shared<ResourcePool>("memory", 4, q);
+        std::vector<int> executed;
+
+        pool->admit(Delegate<void>::CreateLambda([&executed]() { executed.push_back(1); }), 1, 4);
+        pool->admit(Delegate<void>::CreateLambda([&executed]() { executed.push_back(2); }), 1, 1);
+        pool->admit(Delegate<void>::CreateLambda([&executed]() { executed.push_back(3); }), 3, 4);
+        EXPECT_EQ(1, q.size());
+        EXPECT_EQ(2, pool->nWaiting());
+
+        // 3 has higher priority than 2. While 3 waits for 4 tokens it 
+        // blocks admission of 2.
+        q.popAndExecute();
+        EXPECT_EQ(1, q.size());
+        EXPECT_EQ(1, pool->nWaiting());
+        q.popAndExecute();
+        q.popAndExecute();
+        EXPECT_EQ(std::vector<int>({ 1, 3, 2 }), executed);
+        EXPECT_TRUE(q.empty());
+    }
+
+    TEST(ResourcePool, claimIsLimitedToCapacity) {
+        PriorityDispatcher q(4);
+        auto pool = std::make_shared<ResourcePool>("memory", 2, q);
+        int executed = 0;
+
+        pool->admit(Delegate<void>::CreateLambda([&executed]() { executed++; }), 1, 8);
+        EXPECT_EQ(1, q.size());
+        EXPECT_EQ(0, pool->available());
+        q.popAndExecute();
+        EXPECT_EQ(1, executed);
+        EXPECT_EQ(2, pool->available());
+    }
+
+    TEST(ResourcePool, increaseCapacity) {
+        PriorityDispatcher q(4);
+        auto pool = std::make_shared<ResourcePool>("link", 1, q);
+
+        pool->admit(Delegate<void>::CreateLambda([]() {}), 1, 1);
+        pool->admit(Delegate<void>::CreateLambda([]() {}), 1, 1);
+        EXPECT_EQ(1, q.size());
+        pool->capacity(2);
+        EXPECT_EQ(2, q.size());
+        EXPECT_EQ(0, pool->nWaiting());
+    }
+}
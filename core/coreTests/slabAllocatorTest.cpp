@@ -0,0 +1,162 @@
+#include "../SlabAllocator.h"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace
+{
+    using namespace YAM;
+
+    // Size comparable to SourceFileNode.
+    class FakeNode : public std::enable_shared_from_this<FakeNode>
+    {
+    public:
+        FakeNode(std::size_t id) : _id(id) {}
+        std::size_t id() const { return _id; }
+    private:
+        std::size_t _id;
+        char _payload[240];
+    };
+
+    class OtherNode
+    {
+    public:
+        double value = 1.0;
+    };
+
+    TEST(SlabPool, allocateAndRelease) {
+        SlabPool* pool = new SlabPool(100, 8);
+        EXPECT_EQ(104, pool->blockSize());
+        EXPECT_EQ(0, pool->nSlabs());
+
+        std::size_t blocksPerSlab = pool->slabSize() / pool->blockSize();
+        std::vector<void*> blocks;
+        std::unordered_set<void*> unique;
+        for (std::size_t i = 0; i < 2 * blocksPerSlab; ++i) {
+            void* block = pool->allocate();
+            blocks.push_back(block);
+            unique.insert(block);
+            EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(block) % 8);
+        }
+        EXPECT_EQ(blocks.size(), unique.size());
+        EXPECT_EQ(blocks.size(), pool->nBlocks());
+        EXPECT_EQ(3, pool->nSlabs()); // header takes room of a block
+
+        // Freed blocks are re-used.
+        void* last = blocks.back();
+        pool->deallocate(last);
+        EXPECT_EQ(last, pool->allocate());
+
+        for (auto block : blocks) pool->deallocate(block);
+        EXPECT_EQ(0, pool->nBlocks());
+        EXPECT_EQ(3, pool->nSlabs());
+        EXPECT_EQ(3, pool->releaseEmptySlabs());
+        EXPECT_EQ(0, pool->nSlabs());
+    }
+
+    TEST(SlabPool, partiallyUsedSlabIsNotReleased) {
+        SlabPool* pool = new SlabPool(64, 8);
+        std::size_t blocksPerSlab = pool->slabSize() / pool->blockSize();
+        std::vector<void*> blocks;
+        for (std::size_t i = 0; i < 2 * blocksPerSlab; ++i) blocks.push_back(pool->allocate());
+        for (std::size_t i = 1; i < blocks.size(); ++i) pool->deallocate(blocks[i]);
+        EXPECT_EQ(2, pool->releaseEmptySlabs());
+        EXPECT_EQ(1, pool->nSlabs());
+        EXPECT_EQ(1, pool->nBlocks());
+        pool->deallocate(blocks[0]);
+        EXPECT_EQ(1, pool->releaseEmptySlabs());
+        EXPECT_EQ(0, pool->nSlabs());
+    }
+
+    TEST(SlabPool, releaseAllEmptySlabs) {
+        SlabPool* pool = new SlabPool(32, 8);
+        pool->deallocate(pool->allocate());
+        EXPECT_EQ(1, pool->nSlabs());
+        // Pools of other tests may also have empty slabs.
+        EXPECT_LE(1, SlabPool::releaseAllEmptySlabs());
+        EXPECT_EQ(0, pool->nSlabs());
+    }
+
+    TEST(SlabPool, concurrentAllocate) {
+        SlabPool* pool = new SlabPool(48, 16);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.push_back(std::thread([pool]() {
+                std::vector<void*> blocks;
+                for (int i = 0; i < 10000; ++i) blocks.push_back(pool->allocate());
+                for (auto block : blocks) pool->deallocate(block);
+            }));
+        }
+        for (auto& thread : threads) thread.join();
+        EXPECT_EQ(0, pool->nBlocks());
+        pool->releaseEmptySlabs();
+        EXPECT_EQ(0, pool->nSlabs());
+    }
+
+    TEST(SlabAllocator, makeShared) {
+        {
+            auto node = makeShared<FakeNode>(42);
+            SlabPool* pool = SlabPoolOf<FakeNode>::pool();
+            ASSERT_NE(nullptr, pool);
+            EXPECT_LE(sizeof(FakeNode), pool->blockSize());
+            EXPECT_EQ(1, pool->nBlocks());
+            EXPECT_EQ(42, node->id());
+            EXPECT_EQ(node, node->shared_from_this());
+            auto other = makeShared<OtherNode>();
+            EXPECT_EQ(1.0, other->value);
+        }
+        EXPECT_EQ(0, SlabPoolOf<FakeNode>::pool()->nBlocks());
+        EXPECT_EQ(0, SlabPoolOf<OtherNode>::pool()->nBlocks());
+    }
+
+    // Creates the nodes of a large repository mirror, removes a random
+    // half of them, adds them again and finally removes all nodes.
+    // Compares std::make_shared with makeShared.
+    // Benchmark, run with --gtest_also_run_disabled_tests.
+    TEST(SlabAllocator, DISABLED_largeRepositoryBenchmark) {
+        const std::size_t nNodes = 1000000;
+        std::mt19937 random(7);
+        std::size_t nSlabsCreated = 0;
+        std::size_t nSlabsRecreated = 0;
+
+        auto run = [&](auto create) {
+            std::vector<std::shared_ptr<FakeNode>> nodes(nNodes);
+            auto start = std::chrono::high_resolution_clock::now();
+            for (std::size_t i = 0; i < nNodes; ++i) nodes[i] = create(i);
+            auto created = std::chrono::high_resolution_clock::now() - start;
+            SlabPool* pool = SlabPoolOf<FakeNode>::pool();
+            if (pool != nullptr) nSlabsCreated = pool->nSlabs();
+            for (std::size_t i = 0; i < nNodes; ++i) {
+                if (random() % 2 == 0) nodes[i] = nullptr;
+            }
+            for (std::size_t i = 0; i < nNodes; ++i) {
+                if (nodes[i] == nullptr) nodes[i] = create(i);
+            }
+            if (pool != nullptr) nSlabsRecreated = pool->nSlabs();
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(created).count() / nNodes;
+        };
+
+        auto heapNs = run([](std::size_t i) { return std::make_shared<FakeNode>(i); });
+        auto slabNs = run([](std::size_t i) { return makeShared<FakeNode>(i); });
+        SlabPool& pool = *SlabPoolOf<FakeNode>::pool();
+        std::size_t nReleased = pool.releaseEmptySlabs();
+
+        // Re-created nodes re-use the blocks of the removed nodes.
+        EXPECT_EQ(nSlabsCreated, nSlabsRecreated);
+        EXPECT_EQ(0, pool.nBlocks());
+        EXPECT_EQ(0, pool.nSlabs());
+        EXPECT_EQ(nSlabsCreated, nReleased);
+        std::cout
+            << "nodes=" << nNodes << " block size=" << pool.blockSize() << std::endl
+            << "ns per created node: make_shared=" << heapNs << " makeShared=" << slabNs << std::endl
+            << "slabs=" << nSlabsCreated << " slab MB=" << nSlabsCreated * pool.slabSize() / (1024 * 1024)
+            << " released slabs=" << nReleased << std::endl;
+    }
+}
@@ -0,0 +1,117 @@
+#include "../SmallVectorSet.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+namespace
+{
+    using namespace YAM;
+
+    std::vector<int*> sorted(SmallVectorSet<int*, 4> const& set) {
+        std::vector<int*> values(set.begin(), set.end());
+        std::sort(values.begin(), values.end());
+        return values;
+    }
+
+    TEST(SmallVectorSet, insertAndErase) {
+        int v[3];
+        SmallVectorSet<int*, 4> set;
+        EXPECT_TRUE(set.empty());
+        EXPECT_TRUE(set.insert(&v[0]));
+        EXPECT_TRUE(set.insert(&v[1]));
+        EXPECT_FALSE(set.insert(&v[0]));
+        EXPECT_EQ(2, set.size());
+        EXPECT_TRUE(set.contains(&v[1]));
+        EXPECT_FALSE(set.contains(&v[2]));
+        EXPECT_EQ(1, set.erase(&v[0]));
+        EXPECT_EQ(0, set.erase(&v[0]));
+        EXPECT_EQ(std::vector<int*>({ &v[1] }), sorted(set));
+    }
+
+    // Grow beyond the inline capacity and beyond the index threshold,
+    // then shrink back.
+    TEST(SmallVectorSet, overflow) {
+        std::vector<int> v(100);
+        SmallVectorSet<int*, 4> set;
+        for (auto& i : v) EXPECT_TRUE(set.insert(&i));
+        for (auto& i : v) EXPECT_FALSE(set.insert(&i));
+        EXPECT_EQ(v.size(), set.size());
+        for (std::size_t i = 0; i < v.size(); i += 2) EXPECT_EQ(1, set.erase(&v[i]));
+        EXPECT_EQ(v.size() / 2, set.size());
+        for (std::size_t i = 0; i < v.size(); ++i) EXPECT_EQ(i % 2 == 1, set.contains(&v[i]));
+        for (std::size_t i = 1; i + 4 < v.size(); i += 2) EXPECT_EQ(1, set.erase(&v[i]));
+        EXPECT_EQ(std::vector<int*>({ &v[97], &v[99] }), sorted(set));
+        set.clear();
+        EXPECT_TRUE(set.empty());
+        EXPECT_FALSE(set.contains(&v[99]));
+    }
+
+    class Observer {
+    public:
+        Observer() : nNotifications(0) {}
+        void notify() { nNotifications += 1; }
+        std::size_t nNotifications;
+    };
+
+    // Synthetic graph with 1M observer edges: most subjects have one to
+    // three observers, every 1000th subject is observed by 1000 observers.
+    // Measures adding all edges, notifying all observers and removing all
+    // edges. Compares std::unordered_set with SmallVectorSet.
+    // Benchmark, run with --gtest_also_run_disabled_tests.
+    TEST(SmallVectorSet, DISABLED_observerBenchmark) {
+        const std::size_t nEdges = 1000000;
+        std::mt19937 random(7);
+        std::vector<std::pair<std::size_t, std::size_t>> edges;
+        std::size_t nSubjects = 0;
+        while (edges.size() < nEdges) {
+            std::size_t nObservers = (nSubjects % 1000 == 0) ? 1000 : 1 + random() % 3;
+            for (std::size_t i = 0; i < nObservers; ++i) edges.push_back({ nSubjects, random() % nEdges });
+            nSubjects += 1;
+        }
+        std::vector<Observer> observers(nEdges);
+
+        struct Timing { long long add; long long notify; long long remove; };
+        auto run = [&](auto& subjects) {
+            Timing timing;
+            auto start = std::chrono::high_resolution_clock::now();
+            for (auto const& edge : edges) subjects[edge.first].insert(&observers[edge.second]);
+            timing.add = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start).count();
+            start = std::chrono::high_resolution_clock::now();
+            for (auto const& subject : subjects) {
+                for (auto observer : subject) observer->notify();
+            }
+            timing.notify = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start).count();
+            start = std::chrono::high_resolution_clock::now();
+            for (auto const& edge : edges) subjects[edge.first].erase(&observers[edge.second]);
+            timing.remove = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start).count();
+            return timing;
+        };
+
+        std::vector<std::unordered_set<Observer*>> hashSets(nSubjects);
+        Timing hashTiming = run(hashSets);
+        std::size_t nHashNotifications = 0;
+        for (auto& observer : observers) {
+            nHashNotifications += observer.nNotifications;
+            observer.nNotifications = 0;
+        }
+        std::vector<SmallVectorSet<Observer*, 4>> smallSets(nSubjects);
+        Timing smallTiming = run(smallSets);
+        std::size_t nSmallNotifications = 0;
+        for (auto& observer : observers) nSmallNotifications += observer.nNotifications;
+
+        EXPECT_EQ(nHashNotifications, nSmallNotifications);
+        for (auto const& set : smallSets) EXPECT_TRUE(set.empty());
+        std::cout
+            << "subjects=" << nSubjects << " edges=" << edges.size() << std::endl
+            << "ms unordered_set: add=" << hashTiming.add << " notify=" << hashTiming.notify << " remove=" << hashTiming.remove << std::endl
+            << "ms SmallVectorSet: add=" << smallTiming.add << " notify=" << smallTiming.notify << " remove=" << smallTiming.remove << std::endl
+            << "bytes per subject: unordered_set=" << sizeof(std::unordered_set<Observer*>)
+            << " SmallVectorSet=" << sizeof(SmallVectorSet<Observer*, 4>) << std::endl;
+    }
+}
@@ -0,0 +1,183 @@
+#include "../ThreadPoolSizeController.h"
+#include "../ThreadPool.h"
+#include "../PriorityDispatcher.h"
+
+#include "gtest/gtest.h"
+
+namespace
+{
+    using namespace YAM;
+
+    SystemLoad idleLoad() {
+        SystemLoad load;
+        load.valid = true;
+        load.nCores = 8;
+        load.loadAverage = 2;
+        return load;
+    }
+
+    ThreadPoolSizeController::Config config(std::size_t minSize, std::size_t maxSize) {
+        ThreadPoolSizeController::Config cfg;
+        cfg.minSize = minSize;
+        cfg.maxSize = maxSize;
+        return cfg;
+    }
+
+    TEST(SystemLoad, parsePressure) {
+        std::string text =
+            "some avg10=12.50 avg60=3.10 avg300=0.80 total=123456\n"
+            "full avg10=4.25 avg60=1.00 avg300=0.20 total=6543\n";
+        double some = 0;
+        double full = 0;
+        EXPECT_TRUE(SystemLoad::parsePressure(text, some, full));
+        EXPECT_DOUBLE_EQ(12.5, some);
+        EXPECT_DOUBLE_EQ(4.25, full);
+
+        EXPECT_FALSE(SystemLoad::parsePressure("", some, full));
+        EXPECT_FALSE(SystemLoad::parsePressure("full avg10=1.00 avg60=0.00 avg300=0.00 total=0\n", some, full));
+    }
+
+    TEST(SystemLoad, parseLoadAverage) {
+        double load = 0;
+        EXPECT_TRUE(SystemLoad::parseLoadAverage("3.27 2.11 1.05 2/1234 5678\n", load));
+        EXPECT_DOUBLE_EQ(3.27, load);
+        EXPECT_FALSE(SystemLoad::parseLoadAverage("", load));
+    }
+
+    TEST(ThreadPoolSizeController, growWhenIdleWithQueuedWork) {
+        PriorityDispatcher q(8);
+        ThreadPool pool(&q, "YAM", 2);
+        ThreadPoolSizeController controller(pool, config(1, 3));
+
+        // No queued work: keep size.
+        EXPECT_FALSE(controller.update(idleLoad()));
+        EXPECT_EQ(2, pool.size());
+
+        q.suspend();
+        q.push(Delegate<void>::CreateLambda([]() {}));
+        EXPECT_TRUE(controller.update(idleLoad()));
+        EXPECT_EQ(3, pool.size());
+        // maxSize reached
+        EXPECT_FALSE(controller.update(idleLoad()));
+        EXPECT_EQ(3, pool.size());
+        q.resume();
+
+        auto decisions = controller.decisions();
+        ASSERT_EQ(1, decisions.size());
+        EXPECT_EQ(2, decisions[0].oldSize);
+        EXPECT_EQ(3, decisions[0].newSize);
+        EXPECT_EQ("cpu available", decisions[0].reason);
+        pool.join();
+    }
+
+    TEST(ThreadPoolSizeController, shrinkOnPressure) {
+        PriorityDispatcher q(8);
+        ThreadPool pool(&q, "YAM", 4);
+        ThreadPoolSizeController controller(pool, config(2, 8));
+
+        SystemLoad memory = idleLoad();
+        memory.memorySome = 50;
+        EXPECT_TRUE(controller.update(memory));
+        EXPECT_EQ(3, pool.size());
+
+        SystemLoad io = idleLoad();
+        io.ioSome = 60;
+        EXPECT_TRUE(controller.update(io));
+        EXPECT_EQ(2, pool.size());
+
+        // minSize reached
+        SystemLoad load = idleLoad();
+        load.loadAverage = 20;
+        EXPECT_FALSE(controller.update(load));
+        EXPECT_EQ(2, pool.size());
+
+        auto decisions = controller.decisions();
+        ASSERT_EQ(2, decisions.size());
+        EXPECT_EQ("memory pressure", decisions[0].reason);
+        EXPECT_EQ("io pressure", decisions[1].reason);
+        EXPECT_NE(std::string::npos, decisions[1].toString().find("ThreadPool size 3 -> 2: io pressure"));
+        pool.join();
+    }
+
+    TEST(ThreadPoolSizeController, enforceBounds) {
+        PriorityDispatcher q(8);
+        ThreadPool pool(&q, "YAM", 6);
+        ThreadPoolSizeController controller(pool, config(1, 4));
+
+        EXPECT_TRUE(controller.update(idleLoad()));
+        EXPECT_EQ(4, pool.size());
+        EXPECT_EQ("bounds", controller.decisions()[0].reason);
+        pool.join();
+    }
+
+    TEST(ThreadPoolSizeController, changeBounds) {
+        PriorityDispatcher q(8);
+        ThreadPool pool(&q, "YAM", 6);
+        ThreadPoolSizeController controller(pool, config(1, 8));
+        EXPECT_ANY_THROW(controller.bounds(0, 4));
+        EXPECT_ANY_THROW(controller.bounds(3, 2));
+        controller.bounds(2, 4);
+        EXPECT_EQ(2, controller.config().minSize);
+        EXPECT_EQ(4, controller.config().maxSize);
+        EXPECT_TRUE(controller.update(idleLoad()));
+        EXPECT_EQ(4, pool.size());
+        pool.join();
+    }
+
+    // Only the last maxDecisions decisions are kept.
+    TEST(ThreadPoolSizeController, maxDecisions) {
+        PriorityDispatcher q(8);
+        ThreadPool pool(&q, "YAM", 2);
+        ThreadPoolSizeController::Config cfg = config(1, 2);
+        cfg.maxDecisions = 3;
+        ThreadPoolSizeController controller(pool, cfg);
+        SystemLoad pressure = idleLoad();
+        pressure.cpuSome = 90;
+        q.suspend();
+        q.push(Delegate<void>::CreateLambda([]() {}));
+        for (std::size_t i = 0; i < 10; ++i) {
+            EXPECT_TRUE(controller.update(pressure));
+            EXPECT_TRUE(controller.update(idleLoad()));
+        }
+        q.resume();
+        auto decisions = controller.decisions();
+        ASSERT_EQ(3, decisions.size());
+        EXPECT_EQ("cpu available", decisions[0].reason);
+        EXPECT_EQ("cpu pressure", decisions[1].reason);
+        EXPECT_EQ("cpu available", decisions[2].reason);
+        pool.join();
+    }
+
+    TEST(ThreadPoolSizeController, inactiveWithoutLoadInformation) {
+        PriorityDispatcher q(8);
+        ThreadPool pool(&q, "YAM", 6);
+        ThreadPoolSizeController controller(pool, config(1, 4));
+
+        EXPECT_FALSE(controller.update(SystemLoad()));
+        EXPECT_EQ(6, pool.size());
+        EXPECT_TRUE(controller.decisions().empty());
+        pool.join();
+    }
+
+    TEST(ThreadPoolSizeController, periodicSampling) {
+        PriorityDispatcher q(8);
+        ThreadPool pool(&q, "YAM", 2);
+        ThreadPoolSizeController::Config cfg = config(1, 4);
+        cfg.period = std::chrono::milliseconds(1);
+        auto sampler = Delegate<SystemLoad>::CreateLambda([]() {
+            SystemLoad load = idleLoad();
+            load.cpuSome = 90;
+            return load;
+        });
+        ThreadPoolSizeController controller(pool, cfg, nullptr, sampler);
+        controller.start();
+        EXPECT_TRUE(controller.running());
+        while (pool.size() != 1) std::this_thread::yield();
+        controller.stop();
+        EXPECT_FALSE(controller.running());
+        auto decisions = controller.decisions();
+        ASSERT_EQ(1, decisions.size());
+        EXPECT_EQ("cpu pressure", decisions[0].reason);
+        pool.join();
+    }
+}
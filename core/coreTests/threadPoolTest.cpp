@@ -1,9 +1,14 @@
 #include "../Delegates.h"
 #include "../PriorityDispatcher.h"
+#include "../WorkStealingDispatcher.h"
 #include "../ThreadPool.h"
 
 #include "gtest/gtest.h"
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <iostream>
+#include <vector>
 
 namespace
 {
@@ -78,4 +83,86 @@ namespace
         EXPECT_EQ(sum, r1);
         EXPECT_EQ(sum, r2);
     }
-}
\ No newline at end of file
+
+    TEST(ThreadPool, shrinkWithoutBlockingOnBusyThreads) {
+        std::atomic<bool> release = false;
+        std::atomic<int> count = 0;
+        auto busy = [&release, &count]() {
+            while (!release) std::this_thread::yield();
+            count++;
+        };
+
+        WorkStealingDispatcher q(8, 4);
+        ThreadPool pool(&q, "YAM", 4);
+        for (int i = 0; i < 4; ++i) q.push(Delegate<void>::CreateLambda(busy));
+        while (!q.empty()) std::this_thread::yield();
+
+        // All threads are busy, shrinking must not wait for them.
+        pool.size(1);
+        EXPECT_EQ(1, pool.size());
+        pool.size(3);
+        EXPECT_EQ(3, pool.size());
+        release = true;
+        for (int i = 0; i < 100; ++i) q.push(Delegate<void>::CreateLambda(busy));
+        pool.join();
+        EXPECT_EQ(0, pool.size());
+        EXPECT_EQ(104, count);
+    }
+
+    // Execute nTasks small delegates on a pool of nThreads threads. The 
+    // delegates are pushed from the pool threads, like FileNode and 
+    // DirectoryNode push their completions and sub-tasks during a rehash.
+    // Return throughput in delegates per second.
+    double measureThroughput(IPriorityDispatcher& q, std::size_t nThreads, int nTasks) {
+        std::atomic<int> count = 0;
+        auto task = [&count]() {
+            volatile uint64_t h = 0;
+            for (int i = 0; i < 100; ++i) h = h * 31 + i;
+            count++;
+        };
+        int nFanOuts = static_cast<int>(nThreads);
+        int tasksPerFanOut = nTasks / nFanOuts;
+        auto start = std::chrono::high_resolution_clock::now();
+        {
+            ThreadPool pool(&q, "YAM", nThreads);
+            for (int i = 0; i < nFanOuts; ++i) {
+                q.push(Delegate<void>::CreateLambda([&q, &task, tasksPerFanOut]() {
+                    for (int j = 0; j < tasksPerFanOut; ++j) {
+                        q.push(Delegate<void>::CreateLambda(task), j % q.nPriorities());
+                    }
+                }), q.maxPriority());
+            }
+            while (count < nFanOuts * tasksPerFanOut) std::this_thread::yield();
+            pool.join();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        return (1e9 * nFanOuts * tasksPerFanOut) / static_cast<double>(ns);
+    }
+
+    // Compare throughput scaling of PriorityDispatcher (single lock) with
+    // WorkStealingDispatcher (lock per worker queue) for 1, 2, 4, .., N 
+    // threads, N = number of logical cores.
+    // Benchmark, run with --gtest_also_run_disabled_tests.
+    TEST(ThreadPool, DISABLED_throughputScaling) {
+        const int nTasks = 200000;
+        std::size_t nCores = std::max(1u, std::thread::hardware_concurrency());
+        std::vector<std::size_t> threadCounts;
+        for (std::size_t nThreads = 1; nThreads < nCores; nThreads *= 2) {
+            threadCounts.push_back(nThreads);
+        }
+        threadCounts.push_back(nCores);
+        for (std::size_t nThreads : threadCounts) {
+            PriorityDispatcher pq(32);
+            WorkStealingDispatcher wq(32, static_cast<uint32_t>(nThreads));
+            double pqThroughput = measureThroughput(pq, nThreads, nTasks);
+            double wqThroughput = measureThroughput(wq, nThreads, nTasks);
+            std::cout
+                << "threads=" << nThreads
+                << " PriorityDispatcher delegates/s=" << static_cast<uint64_t>(pqThroughput)
+                << " WorkStealingDispatcher delegates/s=" << static_cast<uint64_t>(wqThroughput)
+                << " stolen=" << wq.nStolen()
+                << std::endl;
+        }
+    }
+}
@@ -0,0 +1,62 @@
+#include "../TreeHash.h"
+#include "../Xxh3.h"
+#include "../PriorityDispatcher.h"
+#include "../ThreadPool.h"
+
+#include "gtest/gtest.h"
+
+#include <random>
+#include <string>
+
+namespace
+{
+    using namespace YAM;
+
+    std::string randomContent(std::size_t size) {
+        std::mt19937_64 random(size);
+        std::string content(size, ' ');
+        for (auto& c : content) c = static_cast<char>(random());
+        return content;
+    }
+
+    TEST(TreeHash, smallContentIsXxh3) {
+        std::string content = randomContent(TreeHash::treeThreshold);
+        EXPECT_EQ(Xxh3::hash64(content), TreeHash::hash64(content));
+        EXPECT_EQ(Xxh3::hash64(""), TreeHash::hash64(""));
+    }
+
+    TEST(TreeHash, largeContentIsRootOfChunkHashes) {
+        std::string content = randomContent(TreeHash::treeThreshold + 1);
+        std::vector<XXH64_hash_t> chunkHashes = TreeHash::chunkHashes(content);
+        ASSERT_EQ(5, chunkHashes.size());
+        EXPECT_EQ(Xxh3::hash64(content.data(), TreeHash::chunkSize), chunkHashes[0]);
+        EXPECT_EQ(Xxh3::hash64(content.data() + 4 * TreeHash::chunkSize, 1), chunkHashes[4]);
+        EXPECT_EQ(TreeHash::root(chunkHashes, content.size()), TreeHash::hash64(content));
+        EXPECT_NE(Xxh3::hash64(content), TreeHash::hash64(content));
+
+        content[2 * TreeHash::chunkSize] ^= 1;
+        std::vector<XXH64_hash_t> modifiedHashes = TreeHash::chunkHashes(content);
+        EXPECT_EQ(chunkHashes[1], modifiedHashes[1]);
+        EXPECT_NE(chunkHashes[2], modifiedHashes[2]);
+        EXPECT_EQ(chunkHashes[3], modifiedHashes[3]);
+    }
+
+    TEST(TreeHash, parallelEqualsSequential) {
+        std::string content = randomContent(10 * TreeHash::chunkSize + 7);
+        XXH64_hash_t expected = TreeHash::hash64(content);
+        PriorityDispatcher helpers(8);
+        ThreadPool pool(&helpers, "TreeHash", 4);
+        for (int i = 0; i < 10; ++i) {
+            EXPECT_EQ(expected, TreeHash::hash64(content, &helpers));
+        }
+        pool.join();
+    }
+
+    // Hashing completes when no thread executes the helper delegates.
+    TEST(TreeHash, completesWithoutHelperThreads) {
+        std::string content = randomContent(10 * TreeHash::chunkSize);
+        PriorityDispatcher helpers(8);
+        EXPECT_EQ(TreeHash::hash64(content), TreeHash::hash64(content, &helpers));
+        EXPECT_LT(0, helpers.size());
+    }
+}
@@ -0,0 +1,196 @@
+#include "../Delegates.h"
+#include "../WorkStealingDispatcher.h"
+#include "../DispatcherFrame.h"
+#include "../ThreadPool.h"
+
+#include "gtest/gtest.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace
+{
+    using namespace YAM;
+
+    int x = 5;
+    int y = 10;
+    int sum = x + y;
+
+    TEST(WorkStealingDispatcher, pushPopAndExecute) {
+        int r1 = -1;
+        int r2 = -1;
+        int r3 = -1;
+        auto l1add = [&r1]() {r1 = 1; };
+        auto l2add = [&r2]() {r2 = 2; };
+        auto l3add = [&r3]() {r3 = 3; };
+        WorkStealingDispatcher q(3, 4);
+        q.push(Delegate<void>::CreateLambda(l1add), 0);
+        q.push(Delegate<void>::CreateLambda(l2add), 1);
+        q.push(Delegate<void>::CreateLambda(l3add), 2);
+        EXPECT_EQ(3, q.size());
+
+        // Delegates are distributed over the 4 worker queues, 
+        // yet are popped in priority order.
+        Delegate<void> d3 = q.pop();
+        d3.Execute();
+        EXPECT_EQ(3, r3);
+
+        Delegate<void> d2 = q.pop();
+        d2.Execute();
+        EXPECT_EQ(2, r2);
+
+        Delegate<void> d1 = q.pop();
+        d1.Execute();
+        EXPECT_EQ(1, r1);
+        EXPECT_TRUE(q.empty());
+    }
+
+    TEST(WorkStealingDispatcher, queueDepthStatistics) {
+        WorkStealingDispatcher q(3, 2);
+        for (int i = 0; i < 3; ++i) q.push(Delegate<void>::CreateLambda([]() {}), 0);
+        q.popAndExecute();
+        q.push(Delegate<void>::CreateLambda([]() {}), 1);
+        EXPECT_EQ(3, q.maxSize());
+        EXPECT_EQ(4, q.nPushed());
+
+        q.resetStatistics();
+        EXPECT_EQ(3, q.maxSize());
+        EXPECT_EQ(0, q.nPushed());
+        while (!q.empty()) q.popAndExecute();
+        q.resetStatistics();
+        EXPECT_EQ(0, q.maxSize());
+        q.push(Delegate<void>::CreateLambda([]() {}), 2);
+        EXPECT_EQ(1, q.maxSize());
+        EXPECT_EQ(1, q.nPushed());
+    }
+
+    TEST(WorkStealingDispatcher, startStop) {
+        int r1 = -1;
+        auto l1add = [&r1]() {r1 = x + y; };
+        WorkStealingDispatcher q(4, 2);
+
+        q.stop();
+        q.push(Delegate<void>::CreateLambda(l1add), 2);
+        Delegate<void> d0 = q.pop();
+        EXPECT_FALSE(d0.IsBound());
+
+        q.start();
+        Delegate<void> d1 = q.pop();
+        EXPECT_TRUE(d1.IsBound());
+        d1.Execute();
+        EXPECT_EQ(sum, r1);
+    }
+
+    TEST(WorkStealingDispatcher, runFrame) {
+        DispatcherFrame frame;
+        int r1 = -1;
+        auto l1add = [&r1]() { r1 = x + y; };
+        auto stop = [&frame]() { frame.stop(); };
+        WorkStealingDispatcher q(4, 2);
+
+        q.push(Delegate<void>::CreateLambda(l1add), 1);
+        q.push(Delegate<void>::CreateLambda(stop), 0);
+        q.run(&frame);
+        EXPECT_EQ(sum, r1);
+    }
+
+    TEST(WorkStealingDispatcher, stealAndJoin) {
+        std::atomic<int> count = 0;
+        const int nFanOuts = 4;
+        const int nIterations = 10000;
+        WorkStealingDispatcher q(8, 4);
+        ThreadPool pool(&q, "YAM", 4);
+
+        // Each fan-out delegate pushes its delegates to the worker queue of
+        // the pool thread that executes it. Threads that run out of work
+        // must steal from the other worker queues.
+        for (int i = 0; i < nFanOuts; ++i) {
+            q.push(Delegate<void>::CreateLambda([&q, &count, nIterations]() {
+                for (int j = 0; j < nIterations; ++j) {
+                    q.push(Delegate<void>::CreateLambda([&count]() { count++; }), 2);
+                }
+            }), 4);
+        }
+        while (count < nFanOuts * nIterations) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        pool.join();
+        EXPECT_EQ(0, pool.size());
+        EXPECT_EQ(nFanOuts * nIterations, count);
+        EXPECT_TRUE(q.empty());
+    }
+
+    // Delegates are counted before they can be popped, hence size() never
+    // exceeds the number of pushed delegates, also not while threads push
+    // and steal concurrently.
+    TEST(WorkStealingDispatcher, sizeWhilePushingAndStealing) {
+        std::atomic<std::size_t> nPushes = 0;
+        std::atomic<std::size_t> maxExcess = 0;
+        std::atomic<int> count = 0;
+        const int nFanOuts = 8;
+        const int nIterations = 20000;
+        WorkStealingDispatcher q(8, 4);
+        ThreadPool pool(&q, "YAM", 4);
+
+        // Sample size() right after a pop, i.e. when a thread that stole
+        // a delegate may have decremented the counters before the pushing
+        // thread incremented them.
+        auto checkSize = [&q, &nPushes, &maxExcess]() {
+            std::size_t size = q.size();
+            std::size_t pushed = nPushes;
+            if (size > pushed) {
+                std::size_t excess = maxExcess;
+                while (size - pushed > excess && !maxExcess.compare_exchange_weak(excess, size - pushed));
+            }
+        };
+        for (int i = 0; i < nFanOuts; ++i) {
+            nPushes++;
+            q.push(Delegate<void>::CreateLambda([&q, &count, &nPushes, checkSize, nIterations]() {
+                for (int j = 0; j < nIterations; ++j) {
+                    nPushes++;
+                    q.push(Delegate<void>::CreateLambda([&count, checkSize]() {
+                        checkSize();
+                        count++;
+                    }), 2);
+                }
+            }), 4);
+        }
+        while (count < nFanOuts * nIterations) {
+            checkSize();
+            std::this_thread::yield();
+        }
+        pool.join();
+        EXPECT_EQ(0, maxExcess);
+        EXPECT_TRUE(q.empty());
+        EXPECT_EQ(0, q.size());
+    }
+
+    // The recorded max depth never exceeds the number of pushes, also not
+    // when statistics are reset while threads push and steal.
+    TEST(WorkStealingDispatcher, queueDepthStatisticsWhileStealing) {
+        std::atomic<int> count = 0;
+        const int nFanOuts = 8;
+        const int nIterations = 20000;
+        WorkStealingDispatcher q(8, 4);
+        ThreadPool pool(&q, "YAM", 4);
+
+        for (int i = 0; i < nFanOuts; ++i) {
+            q.push(Delegate<void>::CreateLambda([&q, &count, nIterations]() {
+                for (int j = 0; j < nIterations; ++j) {
+                    q.push(Delegate<void>::CreateLambda([&count]() { count++; }), 2);
+                }
+            }), 4);
+        }
+        std::size_t maxDepth = 0;
+        while (count < nFanOuts * nIterations) {
+            q.resetStatistics();
+            std::this_thread::yield();
+            maxDepth = (std::max)(maxDepth, q.maxSize());
+            EXPECT_GE(std::size_t(nFanOuts * (nIterations + 1)), q.maxSize());
+        }
+        pool.join();
+        EXPECT_GE(std::size_t(nFanOuts * (nIterations + 1)), maxDepth);
+        q.resetStatistics();
+        EXPECT_EQ(0, q.maxSize());
+    }
+}
@@ -0,0 +1,137 @@
+#include "../Xxh3.h"
+#include "../FileSystem.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+    using namespace YAM;
+
+    std::vector<Xxh3::Isa> supportedIsas() {
+        std::vector<Xxh3::Isa> isas;
+        for (auto isa : { Xxh3::Isa::Sse2, Xxh3::Isa::Avx2, Xxh3::Isa::Avx512 }) {
+            if (Xxh3::supported(isa)) isas.push_back(isa);
+        }
+        return isas;
+    }
+
+    std::vector<char> randomBytes(std::size_t size) {
+        std::mt19937_64 random(size);
+        std::vector<char> bytes(size);
+        for (auto& byte : bytes) byte = static_cast<char>(random());
+        return bytes;
+    }
+
+    // Restores the instruction set selected at construction.
+    class IsaSelection {
+    public:
+        IsaSelection() : _isa(Xxh3::isa()) {}
+        ~IsaSelection() { Xxh3::isa(_isa); }
+    private:
+        Xxh3::Isa _isa;
+    };
+
+    TEST(Xxh3, referenceValues) {
+        EXPECT_EQ(0x2D06800538D394C2ULL, Xxh3::hash64(nullptr, 0));
+        Xxh3Hash128 empty = Xxh3::hash128(nullptr, 0);
+        EXPECT_EQ(0x6001C324468D497FULL, empty.low64);
+        EXPECT_EQ(0x99AA06D3014798D8ULL, empty.high64);
+    }
+
+    TEST(Xxh3, bestIsaIsDefault) {
+        EXPECT_TRUE(Xxh3::supported(Xxh3::Isa::Sse2));
+        EXPECT_EQ(Xxh3::bestIsa(), Xxh3::isa());
+    }
+
+    // All instruction sets compute the same hashes for the short, medium
+    // and long input code paths, in one go and streaming.
+    TEST(Xxh3, isasComputeSameHashes) {
+        IsaSelection restore;
+        std::vector<char> bytes = randomBytes(1024 * 1024 + 7);
+        std::vector<std::size_t> lengths({ 0, 1, 3, 4, 8, 9, 16, 17, 128, 129, 240, 241, 1024, 100000, bytes.size() });
+        Xxh3::isa(Xxh3::Isa::Sse2);
+        std::vector<XXH64_hash_t> expected64;
+        std::vector<Xxh3Hash128> expected128;
+        for (auto length : lengths) {
+            expected64.push_back(Xxh3::hash64(bytes.data(), length, 42));
+            expected128.push_back(Xxh3::hash128(bytes.data(), length, 42));
+        }
+        for (auto isa : supportedIsas()) {
+            Xxh3::isa(isa);
+            for (std::size_t i = 0; i < lengths.size(); ++i) {
+                EXPECT_EQ(expected64[i], Xxh3::hash64(bytes.data(), lengths[i], 42)) << Xxh3::isaName(isa);
+                EXPECT_EQ(expected128[i], Xxh3::hash128(bytes.data(), lengths[i], 42)) << Xxh3::isaName(isa);
+                Xxh3::State state(42);
+                std::size_t offset = 0;
+                std::size_t chunk = 1;
+                while (offset < lengths[i]) {
+                    std::size_t n = std::min(chunk, lengths[i] - offset);
+                    state.update(bytes.data() + offset, n);
+                    offset += n;
+                    chunk = 2 * chunk + 1;
+                }
+                EXPECT_EQ(expected64[i], state.digest64()) << Xxh3::isaName(isa);
+                EXPECT_EQ(expected128[i], state.digest128()) << Xxh3::isaName(isa);
+            }
+        }
+    }
+
+    TEST(Xxh3, file64) {
+        TemporaryDirectory tmp;
+        std::filesystem::path path(tmp.dir / "file");
+        std::vector<char> bytes = randomBytes(200000);
+        {
+            std::ofstream file(path, std::ios::binary);
+            file.write(bytes.data(), bytes.size());
+        }
+        EXPECT_EQ(Xxh3::hash64(bytes.data(), bytes.size()), Xxh3::file64(path));
+        EXPECT_EQ(0, Xxh3::file64(tmp.dir / "nonExisting"));
+    }
+
+    // Print the throughput in MB/s of XXH64_file and of Xxh3::file64 for
+    // each supported instruction set when hashing a file of given size.
+    void benchmarkFile(std::size_t size) {
+        TemporaryDirectory tmp;
+        std::filesystem::path path(tmp.dir / "file");
+        {
+            std::vector<char> bytes = randomBytes(std::min(size, std::size_t(1024 * 1024)));
+            std::ofstream file(path, std::ios::binary);
+            for (std::size_t written = 0; written < size; written += bytes.size()) {
+                file.write(bytes.data(), std::min(bytes.size(), size - written));
+            }
+        }
+        // Repeat small files to get measurable durations.
+        std::size_t nRepeats = std::clamp(std::size_t(64 * 1024 * 1024) / size, std::size_t(1), std::size_t(1000));
+        auto throughput = [&](auto hashFile) {
+            XXH64_hash_t hash = hashFile();
+            auto start = std::chrono::high_resolution_clock::now();
+            for (std::size_t i = 0; i < nRepeats; ++i) EXPECT_EQ(hash, hashFile());
+            auto duration = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start);
+            return static_cast<long long>(nRepeats * size / (1024.0 * 1024.0) / duration.count());
+        };
+        IsaSelection restore;
+        std::cout << "file size=" << size << " MB/s XXH64=" << throughput([&]() { return XXH64_file(path.string().c_str()); });
+        for (auto isa : supportedIsas()) {
+            Xxh3::isa(isa);
+            std::cout << " XXH3(" << Xxh3::isaName(isa) << ")=" << throughput([&]() { return Xxh3::file64(path); });
+        }
+        std::cout << std::endl;
+    }
+
+    // Benchmark, run with --gtest_also_run_disabled_tests.
+    TEST(Xxh3, DISABLED_fileThroughput) {
+        for (std::size_t size = 1024; size <= 64 * 1024 * 1024; size *= 8) benchmarkFile(size);
+    }
+
+    // Writes a 1 GB file. Run with --gtest_also_run_disabled_tests.
+    TEST(Xxh3, DISABLED_fileThroughput1GB) {
+        benchmarkFile(1024 * 1024 * 1024);
+    }
+}
@@ -9,6 +9,7 @@
 #include "../RepositoryNameFile.h"
 #include "../BuildOptions.h"
 #include "../BuildOptionsParser.h"
+#include "../DependencyQuery.h"
 
 #include <thread>
 #include <filesystem>
@@ -296,7 +297,16 @@ bool initializeYam(ILogBook &logBook, std::filesystem::path &repoDir, std::strin
     return !repoName.empty();
 }
 
+// Answer 'yam query' from the dependency index, i.e. without connecting
+// to yamServer. argv[0] is "query".
+int query(int argc, char* argv[]) {
+    std::vector<std::string> args(argv + 1, argv + argc);
+    return DependencyQuery::run(args, std::filesystem::current_path(), std::cout);
+}
+
 int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "query") return query(argc - 1, argv + 1);
+
     ConsoleLogBook logBook;
     logBook.logElapsedTime(true);
     BuildOptions options;